@@ -1,6 +1,7 @@
 #pragma once
 
 #include <FiniteDifferenceSolver1D.h>
+#include <StabilityAnalysis.h>
 
 #define MAKE_DEFAULT_CONSTRUCTORS(CLASS)\
 	virtual ~CLASS() noexcept = default;\
@@ -22,10 +23,35 @@ namespace pde
 		
 		using FiniteDifferenceSolver1D::FiniteDifferenceSolver1D;
 
+		typedef typename cl::Traits<mathDomain>::stdType stdType;
+
+		/**
+		* Whether the state includes solutionDerivative, for the memory plan
+		*/
+		static constexpr bool hasSolutionDerivative = false;
+
 		MAKE_DEFAULT_CONSTRUCTORS(AdvectionDiffusionSolver1D);
 
+		/**
+		* Spectral radius of the built propagator, and optionally the largest stable dt for the same solver type, as a new solver has to be built to use it.
+		* This only costs a few hundred steps, and it's meant to be called before a long run
+		*/
+		StabilityReport AnalyseStability(const bool findLargestStableDt = true);
+
 	protected:
 		void MakeTimeDiscretizer(const std::shared_ptr<cl::Tensor<memorySpace, mathDomain>>& timeDiscretizers, const SolverType solverType);
+
+		/**
+		* The dense operator L into denseSpaceDiscretizer, which has to be dimension x dimension
+		*/
+		void MakeSpaceDiscretizer(cl::ColumnWiseMatrix<memorySpace, mathDomain>& denseSpaceDiscretizer, const SolverType solverType) const;
+
+		/**
+		* Returns false if solverType has no banded (or banded-factorizable) propagator, in which case the dense overload is used.
+		* Throws UnsupportedSolverTypeException if extendedSolverType needs the banded operator and the boundary conditions rule it out.
+		* The step is hostInput.dt, which Setup shrinks while filling the history of multi-step schemes with sub-steps
+		*/
+		bool MakeTimeDiscretizer(BandedTimeDiscretizer<stdType>& timeDiscretizers, const SolverType solverType);
 	};
 
 #pragma region Type aliases
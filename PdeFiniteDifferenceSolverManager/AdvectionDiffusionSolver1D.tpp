@@ -7,10 +7,18 @@ namespace pde
 	template<MemorySpace ms, MathDomain md>
 	void AdvectionDiffusionSolver1D<ms, md>::MakeTimeDiscretizer(const std::shared_ptr<cl::Tensor<ms, md>>& timeDiscretizers, const SolverType solverType)
 	{
-		// reset everything to 0
+		// reset everything to 0, releasing the operator of an earlier call (e.g. the bootstrap starter) before allocating the new one
+		spaceDiscretizer.reset();
 		spaceDiscretizer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(solution->nRows(), solution->nRows(), 0.0);
 		timeDiscretizers->Set(0.0);
 
+		MakeSpaceDiscretizer(*spaceDiscretizer, solverType);
+		pde::detail::MakeTimeDiscretizerAdvectionDiffusion(timeDiscretizers->GetCube(), spaceDiscretizer->GetTile(), solverType, inputData.dt);
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	void AdvectionDiffusionSolver1D<ms, md>::MakeSpaceDiscretizer(cl::ColumnWiseMatrix<ms, md>& denseSpaceDiscretizer, const SolverType solverType) const
+	{
 		FiniteDifferenceInput1D _input(inputData.dt,
 										inputData.spaceGrid.GetBuffer(),
 										inputData.velocity.GetBuffer(),
@@ -18,8 +26,79 @@ namespace pde
 										solverType,
 										inputData.spaceDiscretizerType,
 										inputData.boundaryConditions);
-		pde::detail::MakeSpaceDiscretizer1D(spaceDiscretizer->GetTile(), _input);
-		pde::detail::MakeTimeDiscretizerAdvectionDiffusion(timeDiscretizers->GetCube(), spaceDiscretizer->GetTile(), solverType, inputData.dt);
+		pde::detail::MakeSpaceDiscretizer1D(denseSpaceDiscretizer.GetTile(), _input);
 	}
-}
 
+	template<MemorySpace ms, MathDomain md>
+	bool AdvectionDiffusionSolver1D<ms, md>::MakeTimeDiscretizer(BandedTimeDiscretizer<stdType>& timeDiscretizers, const SolverType solverType)
+	{
+		if (this->HasOneSidedPeriodicBoundaryConditions())
+		{
+			// the dense propagators only implement solverType
+			const ExtendedSolverType extendedSolverType = this->inputData.settings.extendedSolverType;
+			if (extendedSolverType == ExtendedSolverType::KrylovExponential || pde::detail::IsEmbeddedRungeKutta(extendedSolverType) || pde::detail::IsLinearMultiStep(extendedSolverType) || pde::detail::IsImex(extendedSolverType))
+				throw UnsupportedSolverTypeException("extended solver type " + std::to_string(static_cast<int>(extendedSolverType)) + " needs the banded operator, which one-sided periodic boundaries rule out");
+			return false;
+		}
+
+		this->bandedSpaceDiscretizer = std::make_shared<BandedMatrix<stdType>>();
+		pde::detail::MakeSpaceDiscretizer1D(*this->bandedSpaceDiscretizer, this->hostInput);
+
+		// exponential integrators, adaptive and higher order multi-step schemes only need the operator itself, and take precedence over solverType
+		if (pde::detail::MakeKrylovExponentialTimeDiscretizer(timeDiscretizers, *this->bandedSpaceDiscretizer, this->inputData.settings.extendedSolverType, this->hostInput.dt))
+			return true;
+		if (pde::detail::MakeEmbeddedRungeKuttaTimeDiscretizer(timeDiscretizers, *this->bandedSpaceDiscretizer, this->inputData.settings.extendedSolverType, this->inputData.settings.adaptiveStepSettings, this->hostInput.dt))
+			return true;
+		if (pde::detail::MakeLinearMultiStepTimeDiscretizer(timeDiscretizers, *this->bandedSpaceDiscretizer, this->inputData.settings.extendedSolverType, this->hostInput.dt))
+			return true;
+
+		if (pde::detail::IsImex(this->inputData.settings.extendedSolverType))
+		{
+			// the stencils are linear in the coefficients, so that the two parts add up to the whole operator
+			HostFiniteDifferenceInput1D<stdType> diffusionInput(this->hostInput);
+			std::fill(diffusionInput.velocity.begin(), diffusionInput.velocity.end(), stdType(0.0));
+			HostFiniteDifferenceInput1D<stdType> advectionInput(this->hostInput);
+			std::fill(advectionInput.diffusion.begin(), advectionInput.diffusion.end(), stdType(0.0));
+
+			BandedMatrix<stdType> diffusion, advection;
+			pde::detail::MakeSpaceDiscretizer1D(diffusion, diffusionInput);
+			pde::detail::MakeSpaceDiscretizer1D(advection, advectionInput);
+
+			return pde::detail::MakeImexTimeDiscretizer(timeDiscretizers, diffusion, advection, this->inputData.settings.extendedSolverType, this->hostInput.dt);
+		}
+
+		return pde::detail::MakeTimeDiscretizerAdvectionDiffusion(timeDiscretizers, *this->bandedSpaceDiscretizer, solverType, this->hostInput.dt);
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	StabilityReport AdvectionDiffusionSolver1D<ms, md>::AnalyseStability(const bool findLargestStableDt)
+	{
+		StabilityReport report;
+
+		// the splitting has no single amplification factor, and the multi-step schemes carry a history of solution that the power iterations can't step without losing it
+		if (!this->HasStatelessSteps())
+		{
+			report.spectralRadius = std::numeric_limits<double>::quiet_NaN();
+			report.isStable = false;
+			report.largestStableDt = std::numeric_limits<double>::quiet_NaN();
+			return report;
+		}
+
+		report.spectralRadius = this->EstimateSpectralRadius();
+		report.isStable = report.spectralRadius <= 1.0 + std::sqrt(std::numeric_limits<stdType>::epsilon());
+		if (!findLargestStableDt)
+			return report;
+
+		// exponential integrators are exact, and the adaptive schemes shrink their steps to stay stable
+		if (this->bandedTimeDiscretizers.krylovExponential || this->bandedTimeDiscretizers.embeddedRungeKutta)
+		{
+			report.largestStableDt = std::numeric_limits<double>::infinity();
+			return report;
+		}
+
+		const auto discs = this->bandedSpaceDiscretizer ? pde::detail::MakeGershgorinDiscs(*this->bandedSpaceDiscretizer) : pde::detail::MakeGershgorinDiscs(this->MakeDenseSpaceDiscretizer()->Get(), solution->nRows());
+		report.largestStableDt = pde::detail::FindLargestStableDt(discs, inputData.solverType, inputData.dt);
+
+		return report;
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <FiniteDifferenceSolver2D.h>
+#include <StabilityAnalysis.h>
 
 #define MAKE_DEFAULT_CONSTRUCTORS(CLASS)\
 	virtual ~CLASS() noexcept = default;\
@@ -22,10 +23,47 @@ namespace pde
 
 		using FiniteDifferenceSolver2D::FiniteDifferenceSolver2D;
 
+		typedef typename cl::Traits<mathDomain>::stdType stdType;
+
+		/**
+		* Whether the state includes solutionDerivative, for the memory plan
+		*/
+		static constexpr bool hasSolutionDerivative = false;
+
 		MAKE_DEFAULT_CONSTRUCTORS(AdvectionDiffusionSolver2D);
 
+		/**
+		* Spectral radius of the built propagator, and optionally the largest stable dt for the same solver type, as a new solver has to be built to use it.
+		* This only costs a few hundred steps, and it's meant to be called before a long run
+		*/
+		StabilityReport AnalyseStability(const bool findLargestStableDt = true);
+
 	protected:
 		void MakeTimeDiscretizer(const std::shared_ptr<cl::Tensor<memorySpace, mathDomain>>& timeDiscretizers, const SolverType solverType);
+
+		/**
+		* The dense operator L into denseSpaceDiscretizer, which has to be dimension x dimension
+		*/
+		void MakeSpaceDiscretizer(cl::ColumnWiseMatrix<memorySpace, mathDomain>& denseSpaceDiscretizer, const SolverType solverType) const;
+
+		/**
+		* Returns false if solverType has no sparse (or banded-factorizable) propagator, in which case the dense overload is used.
+		* Throws UnsupportedSolverTypeException if extendedSolverType needs the sparse operator and SupportsSparseOperators is false.
+		* The step is hostInput.dt, which Setup shrinks while filling the history of multi-step schemes with sub-steps
+		*/
+		bool MakeTimeDiscretizer(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizers, const SolverType solverType);
+
+		/**
+		* Returns false if solverType is not an ADI scheme, and throws UnsupportedSolverTypeException if the operator can't be split along the axes.
+		* Periodic boundaries need separable coefficients
+		*/
+		bool MakeTimeDiscretizer(AdiTimeDiscretizer<stdType>& timeDiscretizer, const ExtendedSolverType solverType);
+
+		/**
+		* Returns false unless solverType is StrangSplitting: the grid lines are then advanced with the solverType of the input, which has to be a one-step scheme.
+		* Throws UnsupportedSolverTypeException if the coefficients aren't on the host
+		*/
+		bool MakeTimeDiscretizer(StrangSplitting2D<stdType>& timeDiscretizer, const ExtendedSolverType solverType);
 	};
 
 #pragma region Type aliases
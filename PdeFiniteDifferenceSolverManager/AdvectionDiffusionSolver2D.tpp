@@ -7,11 +7,19 @@ namespace pde
 	template<MemorySpace ms, MathDomain md>
 	void AdvectionDiffusionSolver2D<ms, md>::MakeTimeDiscretizer(const std::shared_ptr<cl::Tensor<ms, md>>& timeDiscretizers, const SolverType solverType)
 	{
-		// reset everything to 0
+		// reset everything to 0, releasing the operator of an earlier call (e.g. the bootstrap starter) before allocating the new one
 		const unsigned dimension = this->inputData.initialCondition.nRows() * this->inputData.initialCondition.nCols();
+		spaceDiscretizer.reset();
 		spaceDiscretizer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(dimension, dimension, 0.0);
 		timeDiscretizers->Set(0.0);
 
+		MakeSpaceDiscretizer(*spaceDiscretizer, solverType);
+		pde::detail::MakeTimeDiscretizerAdvectionDiffusion(timeDiscretizers->GetCube(), spaceDiscretizer->GetTile(), solverType, inputData.dt);
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	void AdvectionDiffusionSolver2D<ms, md>::MakeSpaceDiscretizer(cl::ColumnWiseMatrix<ms, md>& denseSpaceDiscretizer, const SolverType solverType) const
+	{
 		FiniteDifferenceInput2D _input(inputData.dt,
 									   inputData.xSpaceGrid.GetBuffer(),
 									   inputData.ySpaceGrid.GetBuffer(),
@@ -21,8 +29,158 @@ namespace pde
 									   solverType,
 									   inputData.spaceDiscretizerType,
 									   inputData.boundaryConditions);
-		pde::detail::MakeSpaceDiscretizer2D(spaceDiscretizer->GetTile(), _input);
-		pde::detail::MakeTimeDiscretizerAdvectionDiffusion(timeDiscretizers->GetCube(), spaceDiscretizer->GetTile(), solverType, inputData.dt);
+		pde::detail::MakeSpaceDiscretizer2D(denseSpaceDiscretizer.GetTile(), _input);
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	bool AdvectionDiffusionSolver2D<ms, md>::MakeTimeDiscretizer(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizers, const SolverType solverType)
+	{
+		// exponential integrators, adaptive and higher order multi-step schemes only need the operator itself, and take precedence over solverType
+		const ExtendedSolverType extendedSolverType = this->inputData.settings.extendedSolverType;
+		const bool needsOperator = extendedSolverType == ExtendedSolverType::KrylovExponential || pde::detail::IsEmbeddedRungeKutta(extendedSolverType) || pde::detail::IsLinearMultiStep(extendedSolverType);
+
+		// the dense propagators only implement solverType
+		if ((needsOperator || pde::detail::IsImex(extendedSolverType)) && !this->SupportsSparseOperators())
+			throw UnsupportedSolverTypeException("extended solver type " + std::to_string(static_cast<int>(extendedSolverType)) + " needs the sparse operators, which periodic boundaries and device-only coefficients rule out");
+
+		if (!this->HasHostCoefficients())
+			return false;
+
+		if (needsOperator)
+		{
+			this->sparseSpaceDiscretizer = std::make_shared<SparseDiagonalMatrix<stdType>>();
+			pde::detail::MakeSpaceDiscretizer2D(*this->sparseSpaceDiscretizer, this->hostInput);
+
+			if (pde::detail::MakeKrylovExponentialTimeDiscretizer(timeDiscretizers, *this->sparseSpaceDiscretizer, extendedSolverType, this->hostInput.dt))
+				return true;
+			if (pde::detail::MakeLinearMultiStepTimeDiscretizer(timeDiscretizers, *this->sparseSpaceDiscretizer, extendedSolverType, this->hostInput.dt, this->inputData.settings.linearSolverSettings, &this->hostInput))
+				return true;
+			return pde::detail::MakeEmbeddedRungeKuttaTimeDiscretizer(timeDiscretizers, *this->sparseSpaceDiscretizer, extendedSolverType, this->inputData.settings.adaptiveStepSettings, this->hostInput.dt);
+		}
+
+		if (pde::detail::IsImex(extendedSolverType))
+		{
+			// the stencils are linear in the coefficients, so that the two parts add up to the whole operator
+			HostFiniteDifferenceInput2D<stdType> diffusionInput(this->hostInput);
+			std::fill(diffusionInput.xVelocity.begin(), diffusionInput.xVelocity.end(), stdType(0.0));
+			std::fill(diffusionInput.yVelocity.begin(), diffusionInput.yVelocity.end(), stdType(0.0));
+			HostFiniteDifferenceInput2D<stdType> advectionInput(this->hostInput);
+			std::fill(advectionInput.diffusion.begin(), advectionInput.diffusion.end(), stdType(0.0));
+
+			SparseDiagonalMatrix<stdType> diffusion, advection;
+			pde::detail::MakeSpaceDiscretizer2D(diffusion, diffusionInput);
+			pde::detail::MakeSpaceDiscretizer2D(advection, advectionInput);
+
+			return pde::detail::MakeImexTimeDiscretizer(timeDiscretizers, diffusion, advection, extendedSolverType, this->hostInput.dt, this->inputData.settings.linearSolverSettings, &diffusionInput);
+		}
+
+		// constant coefficients without transport: implicit steps are diagonal in the sine/Fourier basis, which also handles periodic boundaries
+		if (pde::detail::MakeFastDiagonalizationTimeDiscretizer(timeDiscretizers, this->hostInput, solverType))
+			return true;
+
+		if (!this->SupportsSparseOperators())
+			return false;
+
+		// explicit one-step schemes apply the stencils on the fly, and never build the operator:
+		// with separable coefficients only the 1D stencils are stored, so that they're not recomputed at every step
+		if (pde::detail::MakeMatrixFreeTimeDiscretizer(timeDiscretizers, solverType))
+		{
+			auto kroneckerSpaceDiscretizer = std::make_shared<KroneckerOperator2D<stdType>>();
+			if (pde::detail::MakeKroneckerOperator2D(*kroneckerSpaceDiscretizer, this->hostInput))
+				this->kroneckerSpaceDiscretizer = kroneckerSpaceDiscretizer;
+
+			return true;
+		}
+
+		this->sparseSpaceDiscretizer = std::make_shared<SparseDiagonalMatrix<stdType>>();
+		pde::detail::MakeSpaceDiscretizer2D(*this->sparseSpaceDiscretizer, this->hostInput);
+
+		return pde::detail::MakeTimeDiscretizerAdvectionDiffusion(timeDiscretizers, *this->sparseSpaceDiscretizer, solverType, this->hostInput.dt, this->inputData.settings.linearSolverSettings, &this->hostInput);
 	}
-}
 
+	template<MemorySpace ms, MathDomain md>
+	bool AdvectionDiffusionSolver2D<ms, md>::MakeTimeDiscretizer(AdiTimeDiscretizer<stdType>& timeDiscretizer, const ExtendedSolverType solverType)
+	{
+		if (!pde::detail::IsAdi(solverType))
+			return false;
+		if (!this->HasHostCoefficients())
+			throw UnsupportedSolverTypeException("the ADI line solves need the coefficients on the host");
+
+		// separable coefficients: one 1D factorization per axis, shared by all the grid lines, which wraps around on a periodic axis
+		bool xPeriodic, yPeriodic;
+		KroneckerOperator2D<stdType> kroneckerSpaceDiscretizer;
+		if (pde::detail::GetPeriodicity(this->hostInput, xPeriodic, yPeriodic) && pde::detail::MakeKroneckerOperator2D(kroneckerSpaceDiscretizer, this->hostInput))
+			return pde::detail::MakeAdiTimeDiscretizer(timeDiscretizer, kroneckerSpaceDiscretizer, solverType, this->inputData.dt, xPeriodic, yPeriodic);
+
+		// the strided line solves of non-separable coefficients don't wrap around
+		if (!this->SupportsSparseOperators())
+			throw UnsupportedSolverTypeException("periodic ADI needs separable coefficients, and both ends of an axis periodic");
+
+		SparseDiagonalMatrix<stdType> xSpaceDiscretizer, ySpaceDiscretizer;
+		pde::detail::MakeSpaceDiscretizers2D(xSpaceDiscretizer, ySpaceDiscretizer, this->hostInput);
+
+		return pde::detail::MakeAdiTimeDiscretizer(timeDiscretizer, xSpaceDiscretizer, ySpaceDiscretizer, solverType, this->inputData.dt);
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	bool AdvectionDiffusionSolver2D<ms, md>::MakeTimeDiscretizer(StrangSplitting2D<stdType>& timeDiscretizer, const ExtendedSolverType solverType)
+	{
+		// the 1D lines handle periodic boundaries on their own, so that only the coefficients need to be on the host
+		if (solverType != ExtendedSolverType::StrangSplitting)
+			return false;
+		if (!this->HasHostCoefficients())
+			throw UnsupportedSolverTypeException("the Strang splitting lines need the coefficients on the host");
+
+		return pde::detail::MakeStrangSplittingTimeDiscretizer(timeDiscretizer, this->hostInput, this->inputData.solverType);
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	StabilityReport AdvectionDiffusionSolver2D<ms, md>::AnalyseStability(const bool findLargestStableDt)
+	{
+		StabilityReport report;
+
+		// the splitting has no single amplification factor, and the multi-step schemes carry a history of solution that the power iterations can't step without losing it
+		if (!this->HasStatelessSteps())
+		{
+			report.spectralRadius = std::numeric_limits<double>::quiet_NaN();
+			report.isStable = false;
+			report.largestStableDt = std::numeric_limits<double>::quiet_NaN();
+			return report;
+		}
+
+		report.spectralRadius = this->EstimateSpectralRadius();
+		report.isStable = report.spectralRadius <= 1.0 + std::sqrt(std::numeric_limits<stdType>::epsilon());
+		if (!findLargestStableDt)
+			return report;
+
+		// ADI steps are unconditionally stable, exponential integrators are exact, and the adaptive schemes shrink their steps to stay stable
+		if (this->adiTimeDiscretizer.solverType != ExtendedSolverType::Null || this->sparseTimeDiscretizers.krylovExponential || this->sparseTimeDiscretizers.embeddedRungeKutta)
+		{
+			report.largestStableDt = std::numeric_limits<double>::infinity();
+			return report;
+		}
+
+		// the Strang splitting has no single amplification factor
+		if (this->strangSplitting.solverType != ExtendedSolverType::Null)
+		{
+			report.largestStableDt = std::numeric_limits<double>::quiet_NaN();
+			return report;
+		}
+
+		// matrix-free and fast diagonalization propagators never build the operator
+		std::vector<pde::detail::GershgorinDisc> discs;
+		if (this->sparseSpaceDiscretizer)
+			discs = pde::detail::MakeGershgorinDiscs(*this->sparseSpaceDiscretizer);
+		else if (this->SupportsSparseOperators())
+		{
+			SparseDiagonalMatrix<stdType> sparseSpaceDiscretizer;
+			pde::detail::MakeSpaceDiscretizer2D(sparseSpaceDiscretizer, this->hostInput);
+			discs = pde::detail::MakeGershgorinDiscs(sparseSpaceDiscretizer);
+		}
+		else
+			discs = pde::detail::MakeGershgorinDiscs(this->MakeDenseSpaceDiscretizer()->Get(), solution->nRows());
+		report.largestStableDt = pde::detail::FindLargestStableDt(discs, inputData.solverType, inputData.dt);
+
+		return report;
+	}
+}
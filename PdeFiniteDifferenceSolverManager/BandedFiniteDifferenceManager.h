@@ -0,0 +1,576 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <FiniteDifferenceTypes.h>
+#include <BandedMatrix.h>
+#include <BandedLuFactorization.h>
+#include <SparseDiagonalMatrix.h>
+#include <StridedTridiagonalFactorization.h>
+#include <SpectralTransform.h>
+#include <KrylovSolver.h>
+#include <MultigridSolver.h>
+#include <KrylovExponential.h>
+#include <EmbeddedRungeKutta.h>
+#include <ExtendedSolverType.h>
+
+namespace pde
+{
+	/**
+	*	Host-side counterpart of FiniteDifferenceInput1D: the buffers are copied once at setup, so that the banded operators can be built and applied without any device round-trip
+	*/
+	template<typename stdType>
+	struct HostFiniteDifferenceInput1D
+	{
+		double dt = 0.0;
+
+		std::vector<stdType> spaceGrid;
+		std::vector<stdType> velocity;
+		std::vector<stdType> diffusion;
+
+		SpaceDiscretizerType spaceDiscretizerType = SpaceDiscretizerType::Null;
+		BoundaryCondition1D boundaryConditions = BoundaryCondition1D();
+	};
+
+	/**
+	*	Host-side counterpart of FiniteDifferenceInput2D. The grid is flattened column-major: point (i, j) is at i + j * nRows, with x along the rows
+	*/
+	template<typename stdType>
+	struct HostFiniteDifferenceInput2D
+	{
+		double dt = 0.0;
+
+		std::vector<stdType> xSpaceGrid;
+		std::vector<stdType> ySpaceGrid;
+
+		/**
+		* Either one value per x (y) grid point, or one per flattened grid point
+		*/
+		std::vector<stdType> xVelocity;
+		std::vector<stdType> yVelocity;
+
+		/**
+		* One value per flattened grid point
+		*/
+		std::vector<stdType> diffusion;
+
+		SpaceDiscretizerType spaceDiscretizerType = SpaceDiscretizerType::Null;
+		BoundaryCondition2D boundaryConditions = BoundaryCondition2D();
+	};
+
+	/**
+	*	2D operator with separable coefficients, stored as its 1D factors: L * U = Lx * U * Jy + Jx * U * Ly^T,
+	*	where U is the nRows x nCols solution and Jx (Jy) is the identity with its boundary rows (columns) zeroed.
+	*	Memory is O(nRows + nCols) instead of O(nRows * nCols), and each application is a tridiagonal product along each axis.
+	*/
+	template<typename stdType>
+	struct KroneckerOperator2D
+	{
+		BandedMatrix<stdType> xOperator;
+		BandedMatrix<stdType> yOperator;
+
+		size_t size() const noexcept { return xOperator.size() + yOperator.size(); }
+	};
+
+	/**
+	*	Fast diagonalization of the implicit steps, for constant coefficients with Dirichlet or periodic boundaries along each axis:
+	*	on the interior points Lx and Ly are symmetric tridiagonal Toeplitz (or circulant) matrices, which are diagonal in the sine (or Fourier) basis.
+	*	(I - implicitWeight * L) * u_{n + 1} = (I + explicitWeight * L) * u_n is then solved with two 1D transforms per axis, and no matrix is stored.
+	*/
+	template<typename stdType>
+	struct FastDiagonalization2D
+	{
+		/**
+		* Explicit part of the step, and coupling of the interior points with the Dirichlet boundaries
+		*/
+		KroneckerOperator2D<stdType> spaceDiscretizer;
+
+		SpectralTransform<stdType> xTransform;
+		SpectralTransform<stdType> yTransform;
+		std::vector<stdType> xEigenvalues;
+		std::vector<stdType> yEigenvalues;
+
+		stdType explicitWeight = stdType(0.0);
+		stdType implicitWeight = stdType(0.0);
+	};
+
+	/**
+	*	Implicit-explicit splitting of L = D + A into its diffusion part D, which is stepped implicitly, and its advection part A, which is stepped explicitly:
+	*	the implicit systems I - implicitWeight * D are symmetric on uniform grids, and the step is only limited by the advective CFL condition.
+	*	matrixType is BandedMatrix for 1D operators and SparseDiagonalMatrix for 2D ones.
+	*/
+	template<typename stdType, template<typename> class matrixType>
+	struct ImexSplitting
+	{
+		ExtendedSolverType solverType = ExtendedSolverType::Null;
+		double dt = 0.0;
+
+		matrixType<stdType> diffusion;
+		matrixType<stdType> advection;
+
+		/**
+		* ImexCrankNicolsonAdamsBashforth2 only: A * u_{n - 1}, carried over from the previous step. It's empty before the first step (and after ResetStepHistory), which then uses A * u_n instead
+		*/
+		mutable std::vector<stdType> previousAdvection;
+	};
+
+	/**
+	*	Higher order linear multi-step schemes, which keep their own history in a ring buffer: a step overwrites the oldest entry and rotates the index of the newest one,
+	*	instead of shifting all the past steps. The first steps are exact exponential ones, so that filling the history doesn't lower the order of the scheme.
+	*	matrixType is BandedMatrix for 1D operators and SparseDiagonalMatrix for 2D ones.
+	*/
+	template<typename stdType, template<typename> class matrixType>
+	struct LinearMultiStep
+	{
+		ExtendedSolverType solverType = ExtendedSolverType::Null;
+
+		matrixType<stdType> spaceDiscretizer;
+
+		/**
+		* Adams-Bashforth: dt * b_j, applied to L * u_{n - j}. Backward differentiation: a_j, applied to u_{n - j}, with M = I - beta * dt * L
+		*/
+		std::vector<stdType> weights;
+
+		/**
+		* exp(dt * L), until the history is full
+		*/
+		std::shared_ptr<KrylovExponential<stdType, matrixType>> starter;
+
+		/**
+		* history[(newest + j) % weights.size()] is the entry of u_{n - j}, and only the first nFilled ones are valid: ResetStepHistory sets it to 0 when the solution changes between two calls
+		*/
+		mutable std::vector<std::vector<stdType>> history;
+		mutable size_t newest = 0;
+		mutable size_t nFilled = 0;
+	};
+
+	/**
+	*	u_{n + 1} = M^{-1} * sum_j A_j * u_{n - j}, with one A_j per solver step.
+	*	M is only present for implicit schemes, and it's kept factorized so that each step is a forward/back substitution.
+	*	matrixType is BandedMatrix for 1D operators and SparseDiagonalMatrix for 2D ones.
+	*/
+	template<typename stdType, template<typename> class matrixType = BandedMatrix>
+	struct BandedTimeDiscretizer
+	{
+		std::vector<matrixType<stdType>> matrices;
+		std::shared_ptr<BandedLuFactorization<stdType>> implicitFactorization;
+
+		/**
+		* 2D only: replace implicitFactorization when LinearSolverSettings asks for Krylov iterations or multigrid cycles
+		*/
+		std::shared_ptr<KrylovSolver<stdType>> iterativeSolver;
+		std::shared_ptr<MultigridSolver<stdType>> multigridSolver;
+
+		/**
+		* If not 0, matrices is empty and the Taylor propagator of this order is applied stencil by stencil, without storing any operator
+		*/
+		unsigned matrixFreeOrder = 0;
+
+		/**
+		* 2D only: if set, matrices is empty and the steps are solved in the eigenbasis of the operator
+		*/
+		std::shared_ptr<FastDiagonalization2D<stdType>> fastDiagonalization;
+
+		/**
+		* If set, matrices is empty and each step is exp(dt * L) * u_n, applied on the Krylov subspace of u_n
+		*/
+		std::shared_ptr<KrylovExponential<stdType, matrixType>> krylovExponential;
+
+		/**
+		* If set, matrices is empty and the steps are adaptive: nSteps steps advance the solution by nSteps * dt, whatever the number of steps actually taken
+		*/
+		std::shared_ptr<EmbeddedRungeKutta<stdType, matrixType>> embeddedRungeKutta;
+
+		/**
+		* If set, matrices is empty and M = I - implicitWeight * D is the implicit part of the splitting, with implicitWeight depending on the scheme
+		*/
+		std::shared_ptr<ImexSplitting<stdType, matrixType>> imexSplitting;
+
+		/**
+		* If set, matrices is empty and the steps are the ones of a higher order multi-step scheme, which carries its own history
+		*/
+		std::shared_ptr<LinearMultiStep<stdType, matrixType>> linearMultiStep;
+
+		/**
+		* Wave equation only: if set, matrices is empty and the steps are leapfrog ones, which only need the space discretizer
+		*/
+		bool stormerVerlet = false;
+
+		size_t size() const noexcept { return matrices.size(); }
+
+		/**
+		* Clears matrices and every strategy above, for the Make*TimeDiscretizer functions to set exactly one: the steps take the first one they find
+		*/
+		void ResetStrategies() noexcept
+		{
+			matrices.clear();
+			implicitFactorization.reset();
+			iterativeSolver.reset();
+			multigridSolver.reset();
+			matrixFreeOrder = 0;
+			fastDiagonalization.reset();
+			krylovExponential.reset();
+			embeddedRungeKutta.reset();
+			imexSplitting.reset();
+			linearMultiStep.reset();
+			stormerVerlet = false;
+		}
+	};
+
+	/**
+	*	Alternating direction implicit propagator: L = Lx + Ly is split into its x and y parts,
+	*	so that each half step only inverts one tridiagonal system per grid line.
+	*/
+	template<typename stdType>
+	struct AdiTimeDiscretizer
+	{
+		ExtendedSolverType solverType = ExtendedSolverType::Null;
+
+		/**
+		* .5 * dt * Lx and .5 * dt * Ly
+		*/
+		SparseDiagonalMatrix<stdType> halfStepX;
+		SparseDiagonalMatrix<stdType> halfStepY;
+
+		/**
+		* I - .5 * dt * Lx and I - .5 * dt * Ly: one system per grid column and one per grid row respectively
+		*/
+		std::shared_ptr<StridedTridiagonalFactorization<stdType>> xFactorization;
+		std::shared_ptr<StridedTridiagonalFactorization<stdType>> yFactorization;
+
+		/**
+		* Separable coefficients only, replacing all of the above: .5 * dt * Lx and .5 * dt * Ly as 1D factors,
+		* and the 1D factorizations of I - .5 * dt * Lx and I - .5 * dt * Ly, which are shared by all the grid lines
+		*/
+		std::shared_ptr<KroneckerOperator2D<stdType>> kroneckerHalfStep;
+		std::shared_ptr<BandedLuFactorization<stdType>> xLineFactorization;
+		std::shared_ptr<BandedLuFactorization<stdType>> yLineFactorization;
+
+		/**
+		* Separable coefficients only: the line factorizations of a periodic axis span its n - 2 interior points, and wrap around
+		*/
+		bool xPeriodic = false;
+		bool yPeriodic = false;
+	};
+
+	/**
+	*	Strang splitting: half a step along x, a full step along y and another half step along x, where each sweep is a batch of independent 1D problems
+	*	advanced by the 1D time discretizers, so that memory and cost are linear in the number of grid points.
+	*/
+	template<typename stdType>
+	struct StrangSplitting2D
+	{
+		ExtendedSolverType solverType = ExtendedSolverType::Null;
+
+		/**
+		* One 1D problem per interior grid column (along x, with dt / 2) and one per interior grid row (along y, with dt)
+		*/
+		std::vector<HostFiniteDifferenceInput1D<stdType>> xLines;
+		std::vector<HostFiniteDifferenceInput1D<stdType>> yLines;
+
+		/**
+		* xLines[l] is advanced by xTimeDiscretizers[xLineTimeDiscretizers[l]], and likewise along y:
+		* neighbouring lines with the same coefficients share their time discretizer, so that separable coefficients only need one per axis
+		*/
+		std::vector<BandedTimeDiscretizer<stdType>> xTimeDiscretizers;
+		std::vector<BandedTimeDiscretizer<stdType>> yTimeDiscretizers;
+		std::vector<size_t> xLineTimeDiscretizers;
+		std::vector<size_t> yLineTimeDiscretizers;
+	};
+
+	namespace detail
+	{
+		/**
+		* Coefficients of u_{i - 1}, u_i and u_{i + 1} in -velocity * u_h + diffusion * u_hh
+		*/
+		template<typename stdType>
+		struct StencilWeights
+		{
+			stdType minus = stdType(0.0);
+			stdType main = stdType(0.0);
+			stdType plus = stdType(0.0);
+		};
+
+		/**
+		* Centered/Upwind/LaxWendroff weights at a grid point whose neighbours are dxMinus and dxPlus away: this is shared by the 1D, 2D and matrix-free operators
+		*/
+		template<typename stdType>
+		StencilWeights<stdType> MakeStencilWeights(const stdType dxMinus, const stdType dxPlus, const stdType velocity, stdType diffusion, const SpaceDiscretizerType spaceDiscretizerType, const double dt);
+
+		/**
+		* Order of the Taylor propagator that solverType yields on a linear problem, or 0 if it's not an explicit one-step scheme
+		*/
+		inline unsigned GetTaylorOrder(const SolverType solverType) noexcept;
+
+		inline bool IsAdi(const ExtendedSolverType solverType) noexcept;
+
+		inline bool IsEmbeddedRungeKutta(const ExtendedSolverType solverType) noexcept;
+
+		inline bool IsImex(const ExtendedSolverType solverType) noexcept;
+
+		inline bool IsLinearMultiStep(const ExtendedSolverType solverType) noexcept;
+
+		/**
+		* beta of the backward differentiation formulas, for which M = I - beta * dt * L, and 0 for the explicit schemes
+		*/
+		inline double GetLinearMultiStepImplicitWeight(const ExtendedSolverType solverType) noexcept;
+
+		/**
+		* Periodic on both ends: the first and last points are ghost copies of the points n - 2 and 1, which SetBoundaryConditions1D fills after every step
+		*/
+		template<typename stdType>
+		bool IsPeriodic(const HostFiniteDifferenceInput1D<stdType>& input) noexcept;
+
+		/**
+		* Centered/Upwind/LaxWendroff stencils on a (possibly non-uniform) grid, written straight into a tridiagonal matrix.
+		* Boundary rows are left empty, as they're overwritten by SetBoundaryConditions1D after every step.
+		* With periodic boundaries the matrix only spans the n - 2 interior points, and the stencils of the first and last one wrap around into its corners.
+		*/
+		template<typename stdType>
+		void MakeSpaceDiscretizer1D(BandedMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input);
+
+		/**
+		* Periodic copy of a tridiagonal operator over n points: the ghost rows 0 and n - 1 are dropped, and the stencils of the points 1 and n - 2 wrap around into the corners
+		*/
+		template<typename stdType>
+		BandedMatrix<stdType> MakePeriodicOperator(const BandedMatrix<stdType>& spaceDiscretizer);
+
+		/**
+		* Returns false if only one end of an axis is periodic. x is along the grid columns, whose ends are up/down, and y along the grid rows, whose ends are left/right
+		*/
+		template<typename stdType>
+		bool GetPeriodicity(const HostFiniteDifferenceInput2D<stdType>& input, bool& xPeriodic, bool& yPeriodic) noexcept;
+
+		/**
+		* Five-point stencils on the flattened 2D grid: same boundary treatment as MakeSpaceDiscretizer1D, without periodic wrapping
+		*/
+		template<typename stdType>
+		void MakeSpaceDiscretizer2D(SparseDiagonalMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input);
+
+		/**
+		* x and y parts of MakeSpaceDiscretizer2D, whose sum is the full operator
+		*/
+		template<typename stdType>
+		void MakeSpaceDiscretizers2D(SparseDiagonalMatrix<stdType>& xSpaceDiscretizer, SparseDiagonalMatrix<stdType>& ySpaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input);
+
+		/**
+		* Returns false if the coefficients aren't separable, i.e. if the x (y) stencils change along y (x)
+		*/
+		template<typename stdType>
+		bool MakeKroneckerOperator2D(KroneckerOperator2D<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input);
+
+		/**
+		* out = L * in, computing the five-point stencils on the fly from the grid and the coefficients. Boundary points are set to 0, as the rows of MakeSpaceDiscretizer2D
+		*/
+		template<typename stdType>
+		void ApplySpaceDiscretizer2D(stdType* out, const stdType* in, const HostFiniteDifferenceInput2D<stdType>& input);
+
+		/**
+		* out = L * in, from the 1D factors
+		*/
+		template<typename stdType>
+		void ApplySpaceDiscretizer2D(stdType* out, const stdType* in, const KroneckerOperator2D<stdType>& spaceDiscretizer);
+
+		/**
+		* out += alpha * Lx * in on every interior grid column, and out += alpha * Ly * in on every interior grid row
+		*/
+		template<typename stdType>
+		void KroneckerDotX(stdType* out, const stdType* in, const BandedMatrix<stdType>& xOperator, const size_t nCols, const stdType alpha);
+		template<typename stdType>
+		void KroneckerDotY(stdType* out, const stdType* in, const BandedMatrix<stdType>& yOperator, const size_t nRows, const stdType alpha);
+
+		/**
+		* Selects the ConstantCoefficients kernel of BandedMatrix::Dot over the rows where it applies.
+		* SparseDiagonalMatrix keeps the field kernel: the boundary rows of every grid column break its diagonals, and constant 2D coefficients go through KroneckerOperator2D
+		*/
+		template<typename stdType>
+		void DetectConstantCoefficients(BandedMatrix<stdType>& matrix);
+		template<typename stdType>
+		void DetectConstantCoefficients(SparseDiagonalMatrix<stdType>& matrix) noexcept;
+
+		template<typename stdType>
+		std::shared_ptr<BandedLuFactorization<stdType>> MakeImplicitFactorization(const BandedMatrix<stdType>& matrix);
+
+		/**
+		* The 2D implicit matrices are factorized as banded matrices of bandwidth nRows: fill-in makes this O(nRows^2 * nCols) memory, still far below the dense inverse
+		*/
+		template<typename stdType>
+		std::shared_ptr<BandedLuFactorization<stdType>> MakeImplicitFactorization(const SparseDiagonalMatrix<stdType>& matrix);
+
+		/**
+		* Rediscretizes I - implicitWeight * L on grids coarsened by 2 along each axis with more than 8 points, down to a grid that is factorized.
+		* Even sized axes keep their last point, so that the coarse grid lines are always a subset of the fine ones
+		*/
+		template<typename stdType>
+		std::shared_ptr<MultigridSolver<stdType>> MakeMultigridSolver(const HostFiniteDifferenceInput2D<stdType>& input, const double implicitWeight, const LinearSolverSettings& settings);
+
+		/**
+		* Sets up M^{-1}: 1D operators are always factorized, 2D ones are factorized, solved by Krylov iterations or by multigrid as requested by settings.
+		* multigrid is the hierarchy of M, if it could be built: without it a multigrid solver falls back to Krylov iterations
+		*/
+		template<typename stdType>
+		void MakeImplicitSolver(BandedTimeDiscretizer<stdType, BandedMatrix>& timeDiscretizer, const BandedMatrix<stdType>& matrix, const LinearSolverSettings& settings, std::shared_ptr<MultigridSolver<stdType>> multigrid = nullptr);
+		template<typename stdType>
+		void MakeImplicitSolver(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const SparseDiagonalMatrix<stdType>& matrix, const LinearSolverSettings& settings, std::shared_ptr<MultigridSolver<stdType>> multigrid = nullptr);
+
+		/**
+		* M = I - implicitWeight * L: if input is given, this is the 2D grid L was discretized on, which multigrid needs to rediscretize it
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		void MakeImplicitSolver(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const double implicitWeight, const LinearSolverSettings& settings, const HostFiniteDifferenceInput2D<stdType>* input);
+
+		/**
+		* x = M^{-1} * x, if M is present. initialGuess is only used by the iterative solvers, which throw LinearSolverNotConvergedException past maxIterations
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		void SolveImplicit(const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, stdType* x, const stdType* initialGuess);
+
+		/**
+		* Fills timeDiscretizer with the banded propagator: returns false if solverType has no banded (or banded-factorizable) form
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeTimeDiscretizerAdvectionDiffusion(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const SolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings = LinearSolverSettings(), const HostFiniteDifferenceInput2D<stdType>* input = nullptr);
+
+		/**
+		* Exponential integrator, which only needs products with spaceDiscretizer: returns false unless solverType is KrylovExponential
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeKrylovExponentialTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const double dt);
+
+		/**
+		* Implicit-explicit splitting of the operator discretized from the same input, with velocity set to 0 (diffusion) and diffusion set to 0 (advection):
+		* returns false unless solverType is an IMEX scheme. If diffusionInput is given, this is the 2D grid of diffusion, which multigrid needs to rediscretize it
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeImexTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& diffusion, const matrixType<stdType>& advection, const ExtendedSolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings = LinearSolverSettings(), const HostFiniteDifferenceInput2D<stdType>* diffusionInput = nullptr);
+
+		/**
+		* Adams-Bashforth 3/4 or backward differentiation 2-4: returns false unless solverType is one of them. If input is given, this is the 2D grid of spaceDiscretizer, which multigrid needs to rediscretize it
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeLinearMultiStepTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings = LinearSolverSettings(), const HostFiniteDifferenceInput2D<stdType>* input = nullptr);
+
+		/**
+		* Adaptive embedded Runge-Kutta pair, which only needs products with spaceDiscretizer: returns false unless solverType is BogackiShampine32 or DormandPrince54
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeEmbeddedRungeKuttaTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const AdaptiveStepSettings& settings, const double dt);
+
+		/**
+		* Matrix-free propagator for explicit one-step schemes: returns false for any other solverType
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeMatrixFreeTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const SolverType solverType);
+
+		/**
+		* Returns false if solverType is not an ADI scheme
+		*/
+		template<typename stdType>
+		bool MakeAdiTimeDiscretizer(AdiTimeDiscretizer<stdType>& timeDiscretizer, const SparseDiagonalMatrix<stdType>& xSpaceDiscretizer, const SparseDiagonalMatrix<stdType>& ySpaceDiscretizer, const ExtendedSolverType solverType, const double dt);
+		template<typename stdType>
+		bool MakeAdiTimeDiscretizer(AdiTimeDiscretizer<stdType>& timeDiscretizer, const KroneckerOperator2D<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const double dt, const bool xPeriodic = false, const bool yPeriodic = false);
+
+		/**
+		* The grid lines are advanced with lineSolverType, and their boundary conditions are the matching ones of input.
+		* Returns false if lineSolverType is a multi-step scheme, as its history can't be carried across the sweeps
+		*/
+		template<typename stdType>
+		bool MakeStrangSplittingTimeDiscretizer(StrangSplitting2D<stdType>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const SolverType lineSolverType);
+
+		/**
+		* Returns false unless solverType is ImplicitEuler or CrankNicolson, the coefficients are constant and symmetric (no transport),
+		* and each axis has either Dirichlet or periodic boundaries on both ends
+		*/
+		template<typename stdType>
+		bool MakeFastDiagonalizationTimeDiscretizer(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const SolverType solverType);
+
+		/**
+		* Returns false if solverType is not StormerVerlet
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeStormerVerletTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const ExtendedSolverType solverType);
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeTimeDiscretizerWaveEquation(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const SolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings = LinearSolverSettings(), const HostFiniteDifferenceInput2D<stdType>* input = nullptr);
+
+		/**
+		* Deep copy of the schemes whose steps depend on the ones taken before, i.e. the adaptive step size and the exponential sub-steps: the other members are left empty
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		BandedTimeDiscretizer<stdType, matrixType> SaveStepState(const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer);
+
+		/**
+		* Undoes the steps taken since SaveStepState returned state
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		void RestoreStepState(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const BandedTimeDiscretizer<stdType, matrixType>& state);
+
+		/**
+		* Drops the past steps of the multi-step schemes, which then restart from the next solution they're given
+		*/
+		template<typename stdType, template<typename> class matrixType>
+		void ResetStepHistory(const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer) noexcept;
+
+		template<typename stdType>
+		void SetBoundaryConditions1D(stdType* solution, const HostFiniteDifferenceInput1D<stdType>& input);
+
+		/**
+		* left/right are the first/last grid columns (y), up/down the first/last grid rows (x)
+		*/
+		template<typename stdType>
+		void SetBoundaryConditions2D(stdType* solution, const HostFiniteDifferenceInput2D<stdType>& input);
+
+		/**
+		* solution is column-major, with one column per solver step (column 0 being the most recent one).
+		* Periodic propagators are applied to the interior points only.
+		*/
+		template<typename stdType>
+		void Iterate1D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const unsigned nSteps);
+
+		/**
+		* Same, with the scratch for the new step owned by the caller, which can then step many lines without reallocating
+		*/
+		template<typename stdType>
+		void Iterate1D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const unsigned nSteps, std::vector<stdType>& stepBuffer);
+
+		/**
+		* Advances the first column of solution by duration, which doesn't need to be a multiple of dt: returns false if timeDiscretizer isn't adaptive
+		*/
+		template<typename stdType>
+		bool AdvanceAdaptive1D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const double duration);
+
+		/**
+		* u' = v; v' = L * u, with u_{n + 1} = M^{-1} * A * (u_n + dt * v_n) and v_{n + 1} = M^{-1} * A * (v_n + dt * L * u_n),
+		* or a leapfrog step if the time discretizer is a Stormer-Verlet one
+		*/
+		template<typename stdType>
+		void IterateWaveEquation1D(std::vector<stdType>& solution, std::vector<stdType>& solutionDerivative, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const BandedMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const unsigned nSteps);
+
+		/**
+		* solution is column-major, with one flattened grid per solver step (column 0 being the most recent one).
+		* If given, kroneckerSpaceDiscretizer replaces the on the fly stencils of the matrix-free propagators
+		*/
+		template<typename stdType>
+		void Iterate2D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps, const KroneckerOperator2D<stdType>* kroneckerSpaceDiscretizer = nullptr);
+
+		template<typename stdType>
+		bool AdvanceAdaptive2D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const double duration);
+
+		/**
+		* Only the most recent step (the first flattened grid of solution) is advanced
+		*/
+		template<typename stdType>
+		void IterateAdi2D(std::vector<stdType>& solution, const AdiTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps);
+
+		/**
+		* Only the most recent step is advanced. The lines of a sweep are independent, and they're run in parallel when OpenMP is enabled
+		*/
+		template<typename stdType>
+		void IterateStrangSplitting2D(std::vector<stdType>& solution, const StrangSplitting2D<stdType>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps);
+
+		template<typename stdType>
+		void IterateWaveEquation2D(std::vector<stdType>& solution, std::vector<stdType>& solutionDerivative, const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const SparseDiagonalMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps);
+	}
+}
+
+#include <BandedFiniteDifferenceManager.tpp>
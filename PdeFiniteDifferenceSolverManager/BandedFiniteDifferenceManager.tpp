@@ -0,0 +1,1695 @@
+#pragma once
+
+#include <BandedFiniteDifferenceManager.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace pde
+{
+	namespace detail
+	{
+		/**
+		* Truncated Taylor expansion of exp(dt * L): for a linear autonomous problem this is exactly what any explicit s-stage Runge-Kutta method of order s yields
+		*/
+		template<template<typename> class matrixType, typename stdType>
+		matrixType<stdType> MakeTaylorPropagator(const matrixType<stdType>& spaceDiscretizer, const double dt, const unsigned order)
+		{
+			// Horner: P = I + dt * L / order; P = I + dt * L * P / k
+			matrixType<stdType> propagator(spaceDiscretizer);
+			propagator.Scale(static_cast<stdType>(dt / order));
+			propagator.AddIdentity();
+			for (unsigned k = order - 1; k >= 1; --k)
+			{
+				propagator = Multiply(spaceDiscretizer, propagator, static_cast<stdType>(dt / k));
+				propagator.AddIdentity();
+			}
+
+			DetectConstantCoefficients(propagator);
+			return propagator;
+		}
+
+		inline unsigned GetTaylorOrder(const SolverType solverType) noexcept
+		{
+			switch (solverType)
+			{
+				case SolverType::ExplicitEuler:
+					return 1;
+				case SolverType::RungeKuttaRalston:
+					return 2;
+				case SolverType::RungeKutta3:
+					return 3;
+				case SolverType::RungeKutta4:
+				case SolverType::RungeKuttaThreeEight:
+					return 4;
+				default:
+					return 0;
+			}
+		}
+
+		inline bool IsAdi(const ExtendedSolverType solverType) noexcept
+		{
+			return solverType == ExtendedSolverType::PeacemanRachford || solverType == ExtendedSolverType::Douglas;
+		}
+
+		inline bool IsEmbeddedRungeKutta(const ExtendedSolverType solverType) noexcept
+		{
+			return solverType == ExtendedSolverType::BogackiShampine32 || solverType == ExtendedSolverType::DormandPrince54;
+		}
+
+		inline bool IsImex(const ExtendedSolverType solverType) noexcept
+		{
+			return solverType == ExtendedSolverType::ImexEuler || solverType == ExtendedSolverType::ImexCrankNicolsonAdamsBashforth2 || solverType == ExtendedSolverType::ImexAdditiveRungeKutta2;
+		}
+
+		inline bool IsLinearMultiStep(const ExtendedSolverType solverType) noexcept
+		{
+			switch (solverType)
+			{
+				case ExtendedSolverType::AdamsBashforth3:
+				case ExtendedSolverType::AdamsBashforth4:
+				case ExtendedSolverType::BackwardDifferentiation2:
+				case ExtendedSolverType::BackwardDifferentiation3:
+				case ExtendedSolverType::BackwardDifferentiation4:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		inline double GetLinearMultiStepImplicitWeight(const ExtendedSolverType solverType) noexcept
+		{
+			switch (solverType)
+			{
+				case ExtendedSolverType::BackwardDifferentiation2:
+					return 2.0 / 3.0;
+				case ExtendedSolverType::BackwardDifferentiation3:
+					return 6.0 / 11.0;
+				case ExtendedSolverType::BackwardDifferentiation4:
+					return 12.0 / 25.0;
+				default:
+					return 0.0;
+			}
+		}
+
+		/**
+		* Weight of D in the implicit systems: gamma = 1 - 1 / sqrt(2) is the diagonal of the implicit ARS(2, 2, 2) tableau
+		*/
+		inline double GetImexImplicitWeight(const ExtendedSolverType solverType) noexcept
+		{
+			switch (solverType)
+			{
+				case ExtendedSolverType::ImexEuler:
+					return 1.0;
+				case ExtendedSolverType::ImexCrankNicolsonAdamsBashforth2:
+					return .5;
+				case ExtendedSolverType::ImexAdditiveRungeKutta2:
+					return 1.0 - 1.0 / std::sqrt(2.0);
+				default:
+					return 0.0;
+			}
+		}
+
+		template<typename stdType>
+		bool IsPeriodic(const HostFiniteDifferenceInput1D<stdType>& input) noexcept
+		{
+			return input.boundaryConditions.left.type == BoundaryConditionType::Periodic && input.boundaryConditions.right.type == BoundaryConditionType::Periodic;
+		}
+
+		template<typename stdType>
+		StencilWeights<stdType> MakeStencilWeights(const stdType dxMinus, const stdType dxPlus, const stdType velocity, stdType diffusion, const SpaceDiscretizerType spaceDiscretizerType, const double dt)
+		{
+			StencilWeights<stdType> weights;
+			const stdType denominator = dxMinus * dxPlus * (dxMinus + dxPlus);
+
+			// second order centered first derivative on a non-uniform grid
+			const stdType firstMinus = -dxPlus * dxPlus / denominator;
+			const stdType firstMain = (dxPlus * dxPlus - dxMinus * dxMinus) / denominator;
+			const stdType firstPlus = dxMinus * dxMinus / denominator;
+
+			switch (spaceDiscretizerType)
+			{
+				case SpaceDiscretizerType::Centered:
+					weights.minus -= velocity * firstMinus;
+					weights.main -= velocity * firstMain;
+					weights.plus -= velocity * firstPlus;
+					break;
+				case SpaceDiscretizerType::Upwind:
+					if (velocity > 0)
+					{
+						weights.minus += velocity / dxMinus;
+						weights.main -= velocity / dxMinus;
+					}
+					else
+					{
+						weights.main += velocity / dxPlus;
+						weights.plus -= velocity / dxPlus;
+					}
+					break;
+				case SpaceDiscretizerType::LaxWendroff:
+					// centered advection plus the .5 * v^2 * dt diffusive correction
+					weights.minus -= velocity * firstMinus;
+					weights.main -= velocity * firstMain;
+					weights.plus -= velocity * firstPlus;
+					diffusion += static_cast<stdType>(.5 * dt) * velocity * velocity;
+					break;
+				default:
+					break;
+			}
+
+			// second order centered second derivative on a non-uniform grid
+			weights.minus += 2 * diffusion * dxPlus / denominator;
+			weights.main -= 2 * diffusion * (dxPlus + dxMinus) / denominator;
+			weights.plus += 2 * diffusion * dxMinus / denominator;
+
+			return weights;
+		}
+
+		template<typename stdType>
+		void MakeSpaceDiscretizer1D(BandedMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input)
+		{
+			const unsigned nRows = static_cast<unsigned>(input.spaceGrid.size());
+			spaceDiscretizer = BandedMatrix<stdType>(nRows, 1, 1);
+
+			stdType* lower = spaceDiscretizer.Diagonal(-1);
+			stdType* main = spaceDiscretizer.Diagonal(0);
+			stdType* upper = spaceDiscretizer.Diagonal(1);
+
+			const auto& x = input.spaceGrid;
+			for (unsigned i = 1; i + 1 < nRows; ++i)
+			{
+				const auto weights = MakeStencilWeights(x[i] - x[i - 1], x[i + 1] - x[i], input.velocity[i], input.diffusion[i], input.spaceDiscretizerType, input.dt);
+				lower[i] = weights.minus;
+				main[i] = weights.main;
+				upper[i] = weights.plus;
+			}
+
+			if (!IsPeriodic(input))
+			{
+				spaceDiscretizer.DetectConstantCoefficients();
+				return;
+			}
+
+			spaceDiscretizer = MakePeriodicOperator(spaceDiscretizer);
+			spaceDiscretizer.DetectConstantCoefficients();
+		}
+
+		template<typename stdType>
+		BandedMatrix<stdType> MakePeriodicOperator(const BandedMatrix<stdType>& spaceDiscretizer)
+		{
+			// drop the ghost rows: row i - 1 of the periodic matrix is the stencil of point i, whose ghost neighbours 0 and n - 1 are the points n - 2 and 1,
+			// i.e. the wrapped slots (0, -1) and (n - 3, +1)
+			const unsigned nRows = spaceDiscretizer.nRows();
+			BandedMatrix<stdType> periodicSpaceDiscretizer(nRows - 2, 1, 1, stdType(0.0), true);
+			for (int k = -1; k <= 1; ++k)
+				std::copy(spaceDiscretizer.Diagonal(k) + 1, spaceDiscretizer.Diagonal(k) + nRows - 1, periodicSpaceDiscretizer.Diagonal(k));
+
+			return periodicSpaceDiscretizer;
+		}
+
+		template<typename stdType>
+		bool GetPeriodicity(const HostFiniteDifferenceInput2D<stdType>& input, bool& xPeriodic, bool& yPeriodic) noexcept
+		{
+			const auto& bc = input.boundaryConditions;
+			xPeriodic = bc.up.type == BoundaryConditionType::Periodic;
+			yPeriodic = bc.left.type == BoundaryConditionType::Periodic;
+
+			return xPeriodic == (bc.down.type == BoundaryConditionType::Periodic) && yPeriodic == (bc.right.type == BoundaryConditionType::Periodic);
+		}
+
+		template<typename stdType>
+		StencilWeights<stdType> MakeXStencilWeights(const HostFiniteDifferenceInput2D<stdType>& input, const size_t i, const size_t j)
+		{
+			const auto& x = input.xSpaceGrid;
+			const size_t dimension = x.size() * input.ySpaceGrid.size();
+			const size_t k = i + j * x.size();
+
+			const stdType velocity = input.xVelocity.size() == dimension ? input.xVelocity[k] : input.xVelocity[i];
+			return MakeStencilWeights(x[i] - x[i - 1], x[i + 1] - x[i], velocity, input.diffusion[k], input.spaceDiscretizerType, input.dt);
+		}
+
+		template<typename stdType>
+		StencilWeights<stdType> MakeYStencilWeights(const HostFiniteDifferenceInput2D<stdType>& input, const size_t i, const size_t j)
+		{
+			const auto& y = input.ySpaceGrid;
+			const size_t dimension = input.xSpaceGrid.size() * y.size();
+			const size_t k = i + j * input.xSpaceGrid.size();
+
+			const stdType velocity = input.yVelocity.size() == dimension ? input.yVelocity[k] : input.yVelocity[j];
+			return MakeStencilWeights(y[j] - y[j - 1], y[j + 1] - y[j], velocity, input.diffusion[k], input.spaceDiscretizerType, input.dt);
+		}
+
+		template<typename stdType>
+		void MakeSpaceDiscretizers2D(SparseDiagonalMatrix<stdType>& xSpaceDiscretizer, SparseDiagonalMatrix<stdType>& ySpaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input)
+		{
+			const unsigned nRows = static_cast<unsigned>(input.xSpaceGrid.size());
+			const unsigned nCols = static_cast<unsigned>(input.ySpaceGrid.size());
+			xSpaceDiscretizer = SparseDiagonalMatrix<stdType>(nRows * nCols);
+			ySpaceDiscretizer = SparseDiagonalMatrix<stdType>(nRows * nCols);
+
+			stdType* xMain = xSpaceDiscretizer.AddDiagonal(0);
+			stdType* xMinus = xSpaceDiscretizer.AddDiagonal(-1);
+			stdType* xPlus = xSpaceDiscretizer.AddDiagonal(1);
+			stdType* yMain = ySpaceDiscretizer.AddDiagonal(0);
+			stdType* yMinus = ySpaceDiscretizer.AddDiagonal(-static_cast<int>(nRows));
+			stdType* yPlus = ySpaceDiscretizer.AddDiagonal(static_cast<int>(nRows));
+
+			for (unsigned j = 1; j + 1 < nCols; ++j)
+			{
+				for (unsigned i = 1; i + 1 < nRows; ++i)
+				{
+					const unsigned k = i + j * nRows;
+					const auto xWeights = MakeXStencilWeights(input, i, j);
+					const auto yWeights = MakeYStencilWeights(input, i, j);
+
+					xMinus[k] = xWeights.minus;
+					xMain[k] = xWeights.main;
+					xPlus[k] = xWeights.plus;
+					yMinus[k] = yWeights.minus;
+					yMain[k] = yWeights.main;
+					yPlus[k] = yWeights.plus;
+				}
+			}
+		}
+
+		template<typename stdType>
+		bool MakeKroneckerOperator2D(KroneckerOperator2D<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input)
+		{
+			const size_t nRows = input.xSpaceGrid.size();
+			const size_t nCols = input.ySpaceGrid.size();
+			if (nRows < 3 || nCols < 3)
+				return false;
+
+			auto& xOperator = spaceDiscretizer.xOperator;
+			auto& yOperator = spaceDiscretizer.yOperator;
+			xOperator = BandedMatrix<stdType>(static_cast<unsigned>(nRows), 1, 1);
+			yOperator = BandedMatrix<stdType>(static_cast<unsigned>(nCols), 1, 1);
+
+			// the first interior line sets the 1D stencils, and all the others have to match it:
+			// separable coefficients go through the same arithmetic, so they compare exactly equal
+			const auto setOrMatch = [](BandedMatrix<stdType>& matrix, const size_t row, const StencilWeights<stdType>& weights, const bool set)
+			{
+				stdType& minus = matrix.Diagonal(-1)[row];
+				stdType& main = matrix.Diagonal(0)[row];
+				stdType& plus = matrix.Diagonal(1)[row];
+				if (set)
+				{
+					minus = weights.minus;
+					main = weights.main;
+					plus = weights.plus;
+					return true;
+				}
+
+				return minus == weights.minus && main == weights.main && plus == weights.plus;
+			};
+
+			for (size_t j = 1; j + 1 < nCols; ++j)
+			{
+				for (size_t i = 1; i + 1 < nRows; ++i)
+				{
+					if (!setOrMatch(xOperator, i, MakeXStencilWeights(input, i, j), j == 1))
+						return false;
+					if (!setOrMatch(yOperator, j, MakeYStencilWeights(input, i, j), i == 1))
+						return false;
+				}
+			}
+
+			// KroneckerDotY already applies one weight per grid column; the x stencils are constant too on a uniform grid
+			xOperator.DetectConstantCoefficients();
+			return true;
+		}
+
+		template<typename stdType>
+		void MakeSpaceDiscretizer2D(SparseDiagonalMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input)
+		{
+			SparseDiagonalMatrix<stdType> ySpaceDiscretizer;
+			MakeSpaceDiscretizers2D(spaceDiscretizer, ySpaceDiscretizer, input);
+			spaceDiscretizer.AddEqual(ySpaceDiscretizer);
+		}
+
+		template<typename stdType>
+		void ApplySpaceDiscretizer2D(stdType* out, const stdType* in, const HostFiniteDifferenceInput2D<stdType>& input)
+		{
+			const size_t nRows = input.xSpaceGrid.size();
+			const size_t nCols = input.ySpaceGrid.size();
+
+			std::fill(out, out + nRows, stdType(0.0));
+			std::fill(out + (nCols - 1) * nRows, out + nCols * nRows, stdType(0.0));
+			for (size_t j = 1; j + 1 < nCols; ++j)
+			{
+				const size_t column = j * nRows;
+				out[column] = stdType(0.0);
+				out[column + nRows - 1] = stdType(0.0);
+
+				for (size_t i = 1; i + 1 < nRows; ++i)
+				{
+					const size_t k = i + column;
+					const auto xWeights = MakeXStencilWeights(input, i, j);
+					const auto yWeights = MakeYStencilWeights(input, i, j);
+
+					out[k] = xWeights.minus * in[k - 1] + xWeights.plus * in[k + 1] +
+							 yWeights.minus * in[k - nRows] + yWeights.plus * in[k + nRows] +
+							 (xWeights.main + yWeights.main) * in[k];
+				}
+			}
+		}
+
+		template<typename stdType>
+		void KroneckerDotX(stdType* out, const stdType* in, const BandedMatrix<stdType>& xOperator, const size_t nCols, const stdType alpha)
+		{
+			// the boundary rows of xOperator are empty
+			const size_t nRows = xOperator.nRows();
+			for (size_t j = 1; j + 1 < nCols; ++j)
+				xOperator.Dot(out + j * nRows, in + j * nRows, alpha, stdType(1.0));
+		}
+
+		template<typename stdType>
+		void KroneckerDotY(stdType* out, const stdType* in, const BandedMatrix<stdType>& yOperator, const size_t nRows, const stdType alpha)
+		{
+			// a whole grid column at a time, so that the inner loop runs on contiguous memory
+			const size_t nCols = yOperator.nRows();
+			for (size_t j = 1; j + 1 < nCols; ++j)
+			{
+				stdType* outColumn = out + j * nRows;
+				for (int k = -static_cast<int>(yOperator.lowerBandwidth()); k <= static_cast<int>(yOperator.upperBandwidth()); ++k)
+				{
+					const stdType weight = alpha * yOperator.Diagonal(k)[j];
+					const stdType* inColumn = in + (j + k) * nRows;
+					for (size_t i = 1; i + 1 < nRows; ++i)
+						outColumn[i] += weight * inColumn[i];
+				}
+			}
+		}
+
+		template<typename stdType>
+		void ApplySpaceDiscretizer2D(stdType* out, const stdType* in, const KroneckerOperator2D<stdType>& spaceDiscretizer)
+		{
+			const size_t nRows = spaceDiscretizer.xOperator.nRows();
+			const size_t nCols = spaceDiscretizer.yOperator.nRows();
+
+			std::fill(out, out + nRows * nCols, stdType(0.0));
+			KroneckerDotX(out, in, spaceDiscretizer.xOperator, nCols, stdType(1.0));
+			KroneckerDotY(out, in, spaceDiscretizer.yOperator, nRows, stdType(1.0));
+		}
+
+		template<typename stdType>
+		void DetectConstantCoefficients(BandedMatrix<stdType>& matrix)
+		{
+			matrix.DetectConstantCoefficients();
+		}
+
+		template<typename stdType>
+		void DetectConstantCoefficients(SparseDiagonalMatrix<stdType>&) noexcept
+		{
+		}
+
+		template<typename stdType>
+		std::shared_ptr<BandedLuFactorization<stdType>> MakeImplicitFactorization(const BandedMatrix<stdType>& matrix)
+		{
+			return std::make_shared<BandedLuFactorization<stdType>>(matrix);
+		}
+
+		template<typename stdType>
+		std::shared_ptr<BandedLuFactorization<stdType>> MakeImplicitFactorization(const SparseDiagonalMatrix<stdType>& matrix)
+		{
+			return std::make_shared<BandedLuFactorization<stdType>>(matrix.ToBanded());
+		}
+
+		template<typename stdType>
+		std::shared_ptr<MultigridSolver<stdType>> MakeMultigridSolver(const HostFiniteDifferenceInput2D<stdType>& input, const double implicitWeight, const LinearSolverSettings& settings)
+		{
+			// every other line, plus the last one
+			auto coarsen = [](const unsigned n)
+			{
+				std::vector<unsigned> lines;
+				for (unsigned i = 0; i < n; i += 2)
+					lines.push_back(i);
+				if (lines.back() != n - 1)
+					lines.push_back(n - 1);
+
+				return lines;
+			};
+
+			std::vector<MultigridLevel<stdType>> levels;
+			HostFiniteDifferenceInput2D<stdType> levelInput(input);
+			std::vector<unsigned> fineRows, fineCols;
+			while (true)
+			{
+				MultigridLevel<stdType> level;
+				SparseDiagonalMatrix<stdType> spaceDiscretizer;
+				MakeSpaceDiscretizer2D(spaceDiscretizer, levelInput);
+				level.matrix = MakeTaylorPropagator(spaceDiscretizer, -implicitWeight, 1);
+				level.nRows = static_cast<unsigned>(levelInput.xSpaceGrid.size());
+				level.nCols = static_cast<unsigned>(levelInput.ySpaceGrid.size());
+				level.fineRows = std::move(fineRows);
+				level.fineCols = std::move(fineCols);
+				levels.push_back(std::move(level));
+
+				const unsigned nRows = levels.back().nRows;
+				const unsigned nCols = levels.back().nCols;
+				if (nRows <= 8 && nCols <= 8)
+					break;
+
+				fineRows = nRows > 8 ? coarsen(nRows) : std::vector<unsigned>();
+				fineCols = nCols > 8 ? coarsen(nCols) : std::vector<unsigned>();
+				if (fineRows.empty())
+					for (unsigned i = 0; i < nRows; ++i)
+						fineRows.push_back(i);
+				if (fineCols.empty())
+					for (unsigned j = 0; j < nCols; ++j)
+						fineCols.push_back(j);
+
+				// coefficients are sampled on the coarse points
+				HostFiniteDifferenceInput2D<stdType> coarseInput(levelInput);
+				auto sampleGrid = [](const std::vector<stdType>& in, const std::vector<unsigned>& lines)
+				{
+					std::vector<stdType> out;
+					for (const unsigned i : lines)
+						out.push_back(in[i]);
+					return out;
+				};
+				auto sampleField = [&](const std::vector<stdType>& in)
+				{
+					std::vector<stdType> out;
+					for (const unsigned j : fineCols)
+						for (const unsigned i : fineRows)
+							out.push_back(in[i + j * nRows]);
+					return out;
+				};
+				coarseInput.xSpaceGrid = sampleGrid(levelInput.xSpaceGrid, fineRows);
+				coarseInput.ySpaceGrid = sampleGrid(levelInput.ySpaceGrid, fineCols);
+				coarseInput.xVelocity = levelInput.xVelocity.size() == nRows ? sampleGrid(levelInput.xVelocity, fineRows) : sampleField(levelInput.xVelocity);
+				coarseInput.yVelocity = levelInput.yVelocity.size() == nCols ? sampleGrid(levelInput.yVelocity, fineCols) : sampleField(levelInput.yVelocity);
+				coarseInput.diffusion = sampleField(levelInput.diffusion);
+				levelInput = std::move(coarseInput);
+			}
+
+			return std::make_shared<MultigridSolver<stdType>>(std::move(levels), settings);
+		}
+
+		template<typename stdType>
+		void MakeImplicitSolver(BandedTimeDiscretizer<stdType, BandedMatrix>& timeDiscretizer, const BandedMatrix<stdType>& matrix, const LinearSolverSettings& /*settings*/, std::shared_ptr<MultigridSolver<stdType>> /*multigrid*/)
+		{
+			timeDiscretizer.implicitFactorization = MakeImplicitFactorization(matrix);
+		}
+
+		template<typename stdType>
+		void MakeImplicitSolver(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const SparseDiagonalMatrix<stdType>& matrix, const LinearSolverSettings& settings, std::shared_ptr<MultigridSolver<stdType>> multigrid)
+		{
+			switch (settings.solverType)
+			{
+				case LinearSolverType::Multigrid:
+					if (multigrid)
+					{
+						timeDiscretizer.multigridSolver = std::move(multigrid);
+						break;
+					}
+					// fall through
+				case LinearSolverType::Krylov:
+					timeDiscretizer.iterativeSolver = std::make_shared<KrylovSolver<stdType>>(matrix, settings, std::move(multigrid));
+					break;
+				default:
+					timeDiscretizer.implicitFactorization = MakeImplicitFactorization(matrix);
+					break;
+			}
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		void MakeImplicitSolver(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const double implicitWeight, const LinearSolverSettings& settings, const HostFiniteDifferenceInput2D<stdType>* input)
+		{
+			std::shared_ptr<MultigridSolver<stdType>> multigrid;
+			if (input && (settings.solverType == LinearSolverType::Multigrid || (settings.solverType == LinearSolverType::Krylov && settings.preconditionerType == PreconditionerType::Multigrid)))
+				multigrid = MakeMultigridSolver(*input, implicitWeight, settings);
+
+			MakeImplicitSolver(timeDiscretizer, MakeTaylorPropagator(spaceDiscretizer, -implicitWeight, 1), settings, std::move(multigrid));
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		void SolveImplicit(const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, stdType* x, const stdType* initialGuess)
+		{
+			if (timeDiscretizer.implicitFactorization)
+				timeDiscretizer.implicitFactorization->Solve(x);
+			else if (timeDiscretizer.iterativeSolver)
+			{
+				if (!timeDiscretizer.iterativeSolver->Solve(x, initialGuess))
+					throw LinearSolverNotConvergedException("the Krylov solver took " + std::to_string(timeDiscretizer.iterativeSolver->lastIterations()) + " iterations");
+			}
+			else if (timeDiscretizer.multigridSolver)
+			{
+				if (!timeDiscretizer.multigridSolver->Solve(x, initialGuess))
+					throw LinearSolverNotConvergedException("the multigrid solver took " + std::to_string(timeDiscretizer.multigridSolver->lastIterations()) + " V-cycles");
+			}
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeTimeDiscretizerAdvectionDiffusion(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const SolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings, const HostFiniteDifferenceInput2D<stdType>* input)
+		{
+			timeDiscretizer.ResetStrategies();
+
+			switch (solverType)
+			{
+				case SolverType::ExplicitEuler:
+				case SolverType::RungeKuttaRalston:
+				case SolverType::RungeKutta3:
+				case SolverType::RungeKutta4:
+				case SolverType::RungeKuttaThreeEight:
+					timeDiscretizer.matrices.push_back(MakeTaylorPropagator(spaceDiscretizer, dt, GetTaylorOrder(solverType)));
+					break;
+				case SolverType::AdamsBashforth2:
+				{
+					// u_{n + 1} = (I + 1.5 * dt * L) * u_n - .5 * dt * L * u_{n - 1}
+					timeDiscretizer.matrices.push_back(MakeTaylorPropagator(spaceDiscretizer, 1.5 * dt, 1));
+
+					matrixType<stdType> previousStep(spaceDiscretizer);
+					previousStep.Scale(static_cast<stdType>(-.5 * dt));
+					timeDiscretizer.matrices.push_back(std::move(previousStep));
+					break;
+				}
+				case SolverType::ImplicitEuler:
+					// (I - dt * L) * u_{n + 1} = u_n
+					timeDiscretizer.matrices.push_back(matrixType<stdType>::Identity(spaceDiscretizer.nRows()));
+					MakeImplicitSolver(timeDiscretizer, spaceDiscretizer, dt, linearSolverSettings, input);
+					break;
+				case SolverType::CrankNicolson:
+					// (I - .5 * dt * L) * u_{n + 1} = (I + .5 * dt * L) * u_n
+					timeDiscretizer.matrices.push_back(MakeTaylorPropagator(spaceDiscretizer, .5 * dt, 1));
+					MakeImplicitSolver(timeDiscretizer, spaceDiscretizer, .5 * dt, linearSolverSettings, input);
+					break;
+				case SolverType::RungeKuttaGaussLegendre4:
+				{
+					// the periodic L^2 has two corner diagonals, which a rank one correction can't handle
+					if (spaceDiscretizer.periodic())
+						return false;
+
+					// on a linear problem the 2-stage Gauss-Legendre method is the (2, 2) Pade approximant of exp(dt * L):
+					// (I - .5 * dt * L + dt^2 / 12 * L^2) * u_{n + 1} = (I + .5 * dt * L + dt^2 / 12 * L^2) * u_n
+					matrixType<stdType> rhs = Multiply(spaceDiscretizer, spaceDiscretizer, static_cast<stdType>(dt * dt / 12.0));
+					matrixType<stdType> lhs(rhs);
+					lhs.AddEqual(spaceDiscretizer, static_cast<stdType>(-.5 * dt));
+					lhs.AddIdentity();
+					rhs.AddEqual(spaceDiscretizer, static_cast<stdType>(.5 * dt));
+					rhs.AddIdentity();
+
+					timeDiscretizer.matrices.push_back(std::move(rhs));
+					MakeImplicitSolver(timeDiscretizer, lhs, linearSolverSettings);
+					break;
+				}
+				case SolverType::AdamsMouldon2:
+				{
+					// (I - 5 / 12 * dt * L) * u_{n + 1} = (I + 8 / 12 * dt * L) * u_n - 1 / 12 * dt * L * u_{n - 1}
+					timeDiscretizer.matrices.push_back(MakeTaylorPropagator(spaceDiscretizer, 8.0 / 12.0 * dt, 1));
+
+					matrixType<stdType> previousStep(spaceDiscretizer);
+					previousStep.Scale(static_cast<stdType>(-dt / 12.0));
+					timeDiscretizer.matrices.push_back(std::move(previousStep));
+
+					MakeImplicitSolver(timeDiscretizer, spaceDiscretizer, 5.0 / 12.0 * dt, linearSolverSettings, input);
+					break;
+				}
+				default:
+					// Richardson extrapolation propagators are a combination of inverses with no banded form
+					return false;
+			}
+
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeKrylovExponentialTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const double dt)
+		{
+			if (solverType != ExtendedSolverType::KrylovExponential)
+				return false;
+
+			timeDiscretizer.ResetStrategies();
+			timeDiscretizer.krylovExponential = std::make_shared<KrylovExponential<stdType, matrixType>>(spaceDiscretizer, dt);
+
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeImexTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& diffusion, const matrixType<stdType>& advection, const ExtendedSolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings, const HostFiniteDifferenceInput2D<stdType>* diffusionInput)
+		{
+			if (!IsImex(solverType))
+				return false;
+
+			timeDiscretizer.ResetStrategies();
+
+			auto imexSplitting = std::make_shared<ImexSplitting<stdType, matrixType>>();
+			imexSplitting->solverType = solverType;
+			imexSplitting->dt = dt;
+			imexSplitting->diffusion = diffusion;
+			imexSplitting->advection = advection;
+			timeDiscretizer.imexSplitting = std::move(imexSplitting);
+
+			MakeImplicitSolver(timeDiscretizer, diffusion, GetImexImplicitWeight(solverType) * dt, linearSolverSettings, diffusionInput);
+
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeLinearMultiStepTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings, const HostFiniteDifferenceInput2D<stdType>* input)
+		{
+			if (!IsLinearMultiStep(solverType))
+				return false;
+
+			timeDiscretizer.ResetStrategies();
+
+			// Adams-Bashforth: u_{n + 1} = u_n + dt * sum_j b_j * L * u_{n - j}
+			// backward differentiation: (I - beta * dt * L) * u_{n + 1} = sum_j a_j * u_{n - j}
+			std::vector<double> weights;
+			switch (solverType)
+			{
+				case ExtendedSolverType::AdamsBashforth3:
+					weights = { 23.0 / 12.0 * dt, -16.0 / 12.0 * dt, 5.0 / 12.0 * dt };
+					break;
+				case ExtendedSolverType::AdamsBashforth4:
+					weights = { 55.0 / 24.0 * dt, -59.0 / 24.0 * dt, 37.0 / 24.0 * dt, -9.0 / 24.0 * dt };
+					break;
+				case ExtendedSolverType::BackwardDifferentiation2:
+					weights = { 4.0 / 3.0, -1.0 / 3.0 };
+					break;
+				case ExtendedSolverType::BackwardDifferentiation3:
+					weights = { 18.0 / 11.0, -9.0 / 11.0, 2.0 / 11.0 };
+					break;
+				case ExtendedSolverType::BackwardDifferentiation4:
+					weights = { 48.0 / 25.0, -36.0 / 25.0, 16.0 / 25.0, -3.0 / 25.0 };
+					break;
+				default:
+					assert(false);
+					break;
+			}
+
+			const size_t n = spaceDiscretizer.nRows();
+			auto linearMultiStep = std::make_shared<LinearMultiStep<stdType, matrixType>>();
+			linearMultiStep->solverType = solverType;
+			linearMultiStep->spaceDiscretizer = spaceDiscretizer;
+			for (const double weight : weights)
+				linearMultiStep->weights.push_back(static_cast<stdType>(weight));
+			linearMultiStep->starter = std::make_shared<KrylovExponential<stdType, matrixType>>(spaceDiscretizer, dt);
+			linearMultiStep->history.assign(weights.size(), std::vector<stdType>(n));
+			timeDiscretizer.linearMultiStep = std::move(linearMultiStep);
+
+			const double implicitWeight = GetLinearMultiStepImplicitWeight(solverType);
+			if (implicitWeight > 0.0)
+				MakeImplicitSolver(timeDiscretizer, spaceDiscretizer, implicitWeight * dt, linearSolverSettings, input);
+
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeEmbeddedRungeKuttaTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const AdaptiveStepSettings& settings, const double dt)
+		{
+			if (!IsEmbeddedRungeKutta(solverType))
+				return false;
+
+			timeDiscretizer.ResetStrategies();
+			timeDiscretizer.embeddedRungeKutta = std::make_shared<EmbeddedRungeKutta<stdType, matrixType>>(spaceDiscretizer, solverType, settings, dt);
+
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeMatrixFreeTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const SolverType solverType)
+		{
+			timeDiscretizer.ResetStrategies();
+			timeDiscretizer.matrixFreeOrder = GetTaylorOrder(solverType);
+
+			return timeDiscretizer.matrixFreeOrder > 0;
+		}
+
+		/**
+		* Main diagonal and off-diagonal of a tridiagonal 1D factor whose interior rows are all (off, main, off), up to the rounding of a uniform grid
+		*/
+		template<typename stdType>
+		bool IsSymmetricToeplitz(const BandedMatrix<stdType>& matrix, stdType& main, stdType& offDiagonal)
+		{
+			const unsigned n = matrix.nRows();
+			main = matrix.Diagonal(0)[1];
+			offDiagonal = matrix.Diagonal(-1)[1];
+
+			const stdType tolerance = std::sqrt(std::numeric_limits<stdType>::epsilon()) * (std::abs(main) + std::abs(offDiagonal));
+			for (unsigned i = 1; i + 1 < n; ++i)
+			{
+				if (std::abs(matrix.Diagonal(0)[i] - main) > tolerance || std::abs(matrix.Diagonal(-1)[i] - offDiagonal) > tolerance || std::abs(matrix.Diagonal(1)[i] - offDiagonal) > tolerance)
+					return false;
+			}
+
+			return true;
+		}
+
+		template<typename stdType>
+		bool MakeFastDiagonalizationTimeDiscretizer(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const SolverType solverType)
+		{
+			auto fastDiagonalization = std::make_shared<FastDiagonalization2D<stdType>>();
+			switch (solverType)
+			{
+				case SolverType::ImplicitEuler:
+					fastDiagonalization->implicitWeight = static_cast<stdType>(input.dt);
+					break;
+				case SolverType::CrankNicolson:
+					fastDiagonalization->explicitWeight = static_cast<stdType>(.5 * input.dt);
+					fastDiagonalization->implicitWeight = static_cast<stdType>(.5 * input.dt);
+					break;
+				default:
+					return false;
+			}
+
+			// x is along the grid rows, whose ends are up/down; y is along the grid columns, whose ends are left/right
+			bool xPeriodic, yPeriodic;
+			const auto getPeriodicity = [](const BoundaryCondition& first, const BoundaryCondition& last, bool& periodic)
+			{
+				periodic = first.type == BoundaryConditionType::Periodic;
+				return first.type == last.type && (periodic || first.type == BoundaryConditionType::Dirichlet);
+			};
+			const auto& bc = input.boundaryConditions;
+			if (!getPeriodicity(bc.up, bc.down, xPeriodic) || !getPeriodicity(bc.left, bc.right, yPeriodic))
+				return false;
+
+			auto& spaceDiscretizer = fastDiagonalization->spaceDiscretizer;
+			if (!MakeKroneckerOperator2D(spaceDiscretizer, input))
+				return false;
+
+			stdType xMain, xOffDiagonal, yMain, yOffDiagonal;
+			if (!IsSymmetricToeplitz(spaceDiscretizer.xOperator, xMain, xOffDiagonal) || !IsSymmetricToeplitz(spaceDiscretizer.yOperator, yMain, yOffDiagonal))
+				return false;
+
+			// the transforms only act on the interior points: with periodic boundaries the first and last grid lines are ghosts
+			fastDiagonalization->xTransform = SpectralTransform<stdType>(spaceDiscretizer.xOperator.nRows() - 2, xPeriodic);
+			fastDiagonalization->yTransform = SpectralTransform<stdType>(spaceDiscretizer.yOperator.nRows() - 2, yPeriodic);
+			for (const stdType cosine : fastDiagonalization->xTransform.Cosines())
+				fastDiagonalization->xEigenvalues.push_back(xMain + stdType(2.0) * xOffDiagonal * cosine);
+			for (const stdType cosine : fastDiagonalization->yTransform.Cosines())
+				fastDiagonalization->yEigenvalues.push_back(yMain + stdType(2.0) * yOffDiagonal * cosine);
+
+			timeDiscretizer.ResetStrategies();
+			timeDiscretizer.fastDiagonalization = fastDiagonalization;
+
+			return true;
+		}
+
+		template<typename stdType>
+		bool MakeAdiTimeDiscretizer(AdiTimeDiscretizer<stdType>& timeDiscretizer, const SparseDiagonalMatrix<stdType>& xSpaceDiscretizer, const SparseDiagonalMatrix<stdType>& ySpaceDiscretizer, const ExtendedSolverType solverType, const double dt)
+		{
+			if (!IsAdi(solverType))
+				return false;
+
+			timeDiscretizer = AdiTimeDiscretizer<stdType>();
+			timeDiscretizer.solverType = solverType;
+			timeDiscretizer.halfStepX = xSpaceDiscretizer;
+			timeDiscretizer.halfStepX.Scale(static_cast<stdType>(.5 * dt));
+			timeDiscretizer.halfStepY = ySpaceDiscretizer;
+			timeDiscretizer.halfStepY.Scale(static_cast<stdType>(.5 * dt));
+
+			timeDiscretizer.xFactorization = std::make_shared<StridedTridiagonalFactorization<stdType>>(MakeTaylorPropagator(xSpaceDiscretizer, -.5 * dt, 1), 1);
+			// the y neighbours are nRows apart, which is the upper bandwidth of Ly
+			timeDiscretizer.yFactorization = std::make_shared<StridedTridiagonalFactorization<stdType>>(MakeTaylorPropagator(ySpaceDiscretizer, -.5 * dt, 1), ySpaceDiscretizer.upperBandwidth());
+
+			return true;
+		}
+
+		template<typename stdType>
+		bool MakeAdiTimeDiscretizer(AdiTimeDiscretizer<stdType>& timeDiscretizer, const KroneckerOperator2D<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const double dt, const bool xPeriodic, const bool yPeriodic)
+		{
+			if (!IsAdi(solverType))
+				return false;
+
+			timeDiscretizer = AdiTimeDiscretizer<stdType>();
+			timeDiscretizer.solverType = solverType;
+			timeDiscretizer.kroneckerHalfStep = std::make_shared<KroneckerOperator2D<stdType>>(spaceDiscretizer);
+			timeDiscretizer.kroneckerHalfStep->xOperator.Scale(static_cast<stdType>(.5 * dt));
+			timeDiscretizer.kroneckerHalfStep->yOperator.Scale(static_cast<stdType>(.5 * dt));
+			timeDiscretizer.xPeriodic = xPeriodic;
+			timeDiscretizer.yPeriodic = yPeriodic;
+
+			const auto makeLineFactorization = [dt](const BandedMatrix<stdType>& lineOperator, const bool periodic)
+			{
+				return MakeImplicitFactorization(MakeTaylorPropagator(periodic ? MakePeriodicOperator(lineOperator) : lineOperator, -.5 * dt, 1));
+			};
+			timeDiscretizer.xLineFactorization = makeLineFactorization(spaceDiscretizer.xOperator, xPeriodic);
+			timeDiscretizer.yLineFactorization = makeLineFactorization(spaceDiscretizer.yOperator, yPeriodic);
+
+			return true;
+		}
+
+		template<typename stdType>
+		bool MakeStrangSplittingTimeDiscretizer(StrangSplitting2D<stdType>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const SolverType lineSolverType)
+		{
+			const size_t nRows = input.xSpaceGrid.size();
+			const size_t nCols = input.ySpaceGrid.size();
+			const size_t dimension = nRows * nCols;
+			if (getNumberOfSteps(lineSolverType) != 1 || nRows < 3 || nCols < 3)
+				return false;
+
+			timeDiscretizer = StrangSplitting2D<stdType>();
+
+			const auto makeLine = [&input](const std::vector<stdType>& spaceGrid, const double dt, const BoundaryCondition& first, const BoundaryCondition& last)
+			{
+				HostFiniteDifferenceInput1D<stdType> line;
+				line.dt = dt;
+				line.spaceGrid = spaceGrid;
+				line.velocity.resize(spaceGrid.size());
+				line.diffusion.resize(spaceGrid.size());
+				line.spaceDiscretizerType = input.spaceDiscretizerType;
+				line.boundaryConditions.left = first;
+				line.boundaryConditions.right = last;
+				return line;
+			};
+
+			// grid column j goes along x, and its ends are the up/down boundaries
+			for (size_t j = 1; j + 1 < nCols; ++j)
+			{
+				auto line = makeLine(input.xSpaceGrid, .5 * input.dt, input.boundaryConditions.up, input.boundaryConditions.down);
+				for (size_t i = 0; i < nRows; ++i)
+				{
+					const size_t k = i + j * nRows;
+					line.velocity[i] = input.xVelocity.size() == dimension ? input.xVelocity[k] : input.xVelocity[i];
+					line.diffusion[i] = input.diffusion[k];
+				}
+				timeDiscretizer.xLines.push_back(std::move(line));
+			}
+
+			// grid row i goes along y, and its ends are the left/right boundaries
+			for (size_t i = 1; i + 1 < nRows; ++i)
+			{
+				auto line = makeLine(input.ySpaceGrid, input.dt, input.boundaryConditions.left, input.boundaryConditions.right);
+				for (size_t j = 0; j < nCols; ++j)
+				{
+					const size_t k = i + j * nRows;
+					line.velocity[j] = input.yVelocity.size() == dimension ? input.yVelocity[k] : input.yVelocity[j];
+					line.diffusion[j] = input.diffusion[k];
+				}
+				timeDiscretizer.yLines.push_back(std::move(line));
+			}
+
+			const auto makeTimeDiscretizers = [lineSolverType](const std::vector<HostFiniteDifferenceInput1D<stdType>>& lines, std::vector<BandedTimeDiscretizer<stdType>>& timeDiscretizers, std::vector<size_t>& lineTimeDiscretizers)
+			{
+				for (size_t l = 0; l < lines.size(); ++l)
+				{
+					// comparing with the previous line only keeps this linear in the number of grid points
+					if (l > 0 && lines[l].velocity == lines[l - 1].velocity && lines[l].diffusion == lines[l - 1].diffusion)
+					{
+						lineTimeDiscretizers.push_back(lineTimeDiscretizers.back());
+						continue;
+					}
+
+					BandedMatrix<stdType> spaceDiscretizer;
+					MakeSpaceDiscretizer1D(spaceDiscretizer, lines[l]);
+					timeDiscretizers.emplace_back();
+					if (!MakeTimeDiscretizerAdvectionDiffusion(timeDiscretizers.back(), spaceDiscretizer, lineSolverType, lines[l].dt))
+						return false;
+					lineTimeDiscretizers.push_back(timeDiscretizers.size() - 1);
+				}
+
+				return true;
+			};
+			if (!makeTimeDiscretizers(timeDiscretizer.xLines, timeDiscretizer.xTimeDiscretizers, timeDiscretizer.xLineTimeDiscretizers) ||
+				!makeTimeDiscretizers(timeDiscretizer.yLines, timeDiscretizer.yTimeDiscretizers, timeDiscretizer.yLineTimeDiscretizers))
+				return false;
+
+			timeDiscretizer.solverType = ExtendedSolverType::StrangSplitting;
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeStormerVerletTimeDiscretizer(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const ExtendedSolverType solverType)
+		{
+			if (solverType != ExtendedSolverType::StormerVerlet)
+				return false;
+
+			timeDiscretizer.ResetStrategies();
+			timeDiscretizer.stormerVerlet = true;
+
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		bool MakeTimeDiscretizerWaveEquation(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const SolverType solverType, const double dt, const LinearSolverSettings& linearSolverSettings, const HostFiniteDifferenceInput2D<stdType>* input)
+		{
+			timeDiscretizer.ResetStrategies();
+
+			timeDiscretizer.matrices.push_back(matrixType<stdType>::Identity(spaceDiscretizer.nRows()));
+			switch (solverType)
+			{
+				case SolverType::ExplicitEuler:
+					break;
+				case SolverType::ImplicitEuler:
+					// (I - dt^2 * L) * u_{n + 1} = u_n + dt * v_n
+					MakeImplicitSolver(timeDiscretizer, spaceDiscretizer, dt * dt, linearSolverSettings, input);
+					break;
+				default:
+					return false;
+			}
+
+			return true;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		BandedTimeDiscretizer<stdType, matrixType> SaveStepState(const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer)
+		{
+			BandedTimeDiscretizer<stdType, matrixType> state;
+			if (timeDiscretizer.krylovExponential)
+				state.krylovExponential = std::make_shared<KrylovExponential<stdType, matrixType>>(*timeDiscretizer.krylovExponential);
+			if (timeDiscretizer.embeddedRungeKutta)
+				state.embeddedRungeKutta = std::make_shared<EmbeddedRungeKutta<stdType, matrixType>>(*timeDiscretizer.embeddedRungeKutta);
+
+			return state;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		void RestoreStepState(BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const BandedTimeDiscretizer<stdType, matrixType>& state)
+		{
+			if (state.krylovExponential)
+				*timeDiscretizer.krylovExponential = *state.krylovExponential;
+			if (state.embeddedRungeKutta)
+				*timeDiscretizer.embeddedRungeKutta = *state.embeddedRungeKutta;
+		}
+
+		template<typename stdType, template<typename> class matrixType>
+		void ResetStepHistory(const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer) noexcept
+		{
+			if (timeDiscretizer.linearMultiStep)
+				timeDiscretizer.linearMultiStep->nFilled = 0;
+			if (timeDiscretizer.imexSplitting)
+				timeDiscretizer.imexSplitting->previousAdvection.clear();
+		}
+
+		template<typename stdType>
+		void SetBoundaryConditions1D(stdType* solution, const HostFiniteDifferenceInput1D<stdType>& input)
+		{
+			const auto& x = input.spaceGrid;
+			const size_t n = x.size();
+
+			const auto& left = input.boundaryConditions.left;
+			switch (left.type)
+			{
+				case BoundaryConditionType::Dirichlet:
+					solution[0] = static_cast<stdType>(left.value);
+					break;
+				case BoundaryConditionType::Neumann:
+					solution[0] = solution[1] - static_cast<stdType>(left.value) * (x[1] - x[0]);
+					break;
+				case BoundaryConditionType::Periodic:
+					solution[0] = solution[n - 2];
+					break;
+				default:
+					break;
+			}
+
+			const auto& right = input.boundaryConditions.right;
+			switch (right.type)
+			{
+				case BoundaryConditionType::Dirichlet:
+					solution[n - 1] = static_cast<stdType>(right.value);
+					break;
+				case BoundaryConditionType::Neumann:
+					solution[n - 1] = solution[n - 2] - static_cast<stdType>(right.value) * (x[n - 1] - x[n - 2]);
+					break;
+				case BoundaryConditionType::Periodic:
+					solution[n - 1] = solution[1];
+					break;
+				default:
+					break;
+			}
+		}
+
+		template<typename stdType>
+		void SetBoundaryConditions2D(stdType* solution, const HostFiniteDifferenceInput2D<stdType>& input)
+		{
+			const auto& x = input.xSpaceGrid;
+			const auto& y = input.ySpaceGrid;
+			const size_t nRows = x.size();
+			const size_t nCols = y.size();
+
+			// up/down: first and last grid row (x), as when looking at the solution matrix, one grid column at a time
+			for (size_t j = 0; j < nCols; ++j)
+			{
+				stdType* column = solution + j * nRows;
+
+				const auto& up = input.boundaryConditions.up;
+				switch (up.type)
+				{
+					case BoundaryConditionType::Dirichlet:
+						column[0] = static_cast<stdType>(up.value);
+						break;
+					case BoundaryConditionType::Neumann:
+						column[0] = column[1] - static_cast<stdType>(up.value) * (x[1] - x[0]);
+						break;
+					case BoundaryConditionType::Periodic:
+						column[0] = column[nRows - 2];
+						break;
+					default:
+						break;
+				}
+
+				const auto& down = input.boundaryConditions.down;
+				switch (down.type)
+				{
+					case BoundaryConditionType::Dirichlet:
+						column[nRows - 1] = static_cast<stdType>(down.value);
+						break;
+					case BoundaryConditionType::Neumann:
+						column[nRows - 1] = column[nRows - 2] - static_cast<stdType>(down.value) * (x[nRows - 1] - x[nRows - 2]);
+						break;
+					case BoundaryConditionType::Periodic:
+						column[nRows - 1] = column[1];
+						break;
+					default:
+						break;
+				}
+			}
+
+			// left/right: first and last grid column (y)
+			stdType* first = solution;
+			stdType* last = solution + (nCols - 1) * nRows;
+			for (size_t i = 0; i < nRows; ++i)
+			{
+				const auto& left = input.boundaryConditions.left;
+				switch (left.type)
+				{
+					case BoundaryConditionType::Dirichlet:
+						first[i] = static_cast<stdType>(left.value);
+						break;
+					case BoundaryConditionType::Neumann:
+						first[i] = first[i + nRows] - static_cast<stdType>(left.value) * (y[1] - y[0]);
+						break;
+					case BoundaryConditionType::Periodic:
+						first[i] = solution[i + (nCols - 2) * nRows];
+						break;
+					default:
+						break;
+				}
+
+				const auto& right = input.boundaryConditions.right;
+				switch (right.type)
+				{
+					case BoundaryConditionType::Dirichlet:
+						last[i] = static_cast<stdType>(right.value);
+						break;
+					case BoundaryConditionType::Neumann:
+						last[i] = last[i - nRows] - static_cast<stdType>(right.value) * (y[nCols - 1] - y[nCols - 2]);
+						break;
+					case BoundaryConditionType::Periodic:
+						last[i] = solution[i + nRows];
+						break;
+					default:
+						break;
+				}
+			}
+		}
+
+		/**
+		* IMEX steps of the first column of solution, with M = I - implicitWeight * D solved by the implicit solver of timeDiscretizer.
+		* Boundary conditions are set on each stage, as the implicit part reads the boundary values
+		*/
+		template<typename stdType, template<typename> class matrixType, class boundaryConditionSetter>
+		void IterateImex(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const size_t nRows, const size_t offset, const boundaryConditionSetter& setBoundaryConditions, const unsigned nSteps)
+		{
+			const auto& splitting = *timeDiscretizer.imexSplitting;
+			const size_t n = splitting.diffusion.nRows();
+			const stdType dt = static_cast<stdType>(splitting.dt);
+			stdType* u = solution.data();
+
+			std::vector<stdType> rhs(nRows), advection(n), stage, stageAdvection;
+			if (splitting.solverType == ExtendedSolverType::ImexAdditiveRungeKutta2)
+			{
+				stage.resize(nRows);
+				stageAdvection.resize(n);
+			}
+
+			for (unsigned step = 0; step < nSteps; ++step)
+			{
+				splitting.advection.Dot(advection.data(), u + offset);
+				std::copy(u, u + nRows, rhs.begin());
+
+				switch (splitting.solverType)
+				{
+					case ExtendedSolverType::ImexEuler:
+						// (I - dt * D) * u_{n + 1} = u_n + dt * A * u_n
+						for (size_t i = 0; i < n; ++i)
+							rhs[offset + i] += dt * advection[i];
+						break;
+					case ExtendedSolverType::ImexCrankNicolsonAdamsBashforth2:
+					{
+						// (I - .5 * dt * D) * u_{n + 1} = (I + .5 * dt * D) * u_n + dt * (1.5 * A * u_n - .5 * A * u_{n - 1})
+						if (splitting.previousAdvection.size() != n)
+							splitting.previousAdvection = advection;
+
+						splitting.diffusion.Dot(rhs.data() + offset, u + offset, static_cast<stdType>(.5 * dt), stdType(1.0));
+						for (size_t i = 0; i < n; ++i)
+							rhs[offset + i] += dt * (stdType(1.5) * advection[i] - stdType(.5) * splitting.previousAdvection[i]);
+						splitting.previousAdvection.swap(advection);
+						break;
+					}
+					case ExtendedSolverType::ImexAdditiveRungeKutta2:
+					{
+						// ARS(2, 2, 2), which is stiffly accurate: the new solution is the last stage
+						// (I - gamma * dt * D) * U = u_n + gamma * dt * A * u_n
+						// (I - gamma * dt * D) * u_{n + 1} = u_n + dt * (delta * A * u_n + (1 - delta) * A * U + (1 - gamma) * D * U)
+						const double gamma = GetImexImplicitWeight(splitting.solverType);
+						const double delta = 1.0 - 1.0 / (2.0 * gamma);
+
+						for (size_t i = 0; i < n; ++i)
+							rhs[offset + i] += static_cast<stdType>(gamma * dt) * advection[i];
+						std::copy(rhs.begin(), rhs.end(), stage.begin());
+						SolveImplicit(timeDiscretizer, stage.data() + offset, u + offset);
+						setBoundaryConditions(stage.data());
+						splitting.advection.Dot(stageAdvection.data(), stage.data() + offset);
+
+						std::copy(u, u + nRows, rhs.begin());
+						splitting.diffusion.Dot(rhs.data() + offset, stage.data() + offset, static_cast<stdType>((1.0 - gamma) * dt), stdType(1.0));
+						for (size_t i = 0; i < n; ++i)
+							rhs[offset + i] += static_cast<stdType>(delta * dt) * advection[i] + static_cast<stdType>((1.0 - delta) * dt) * stageAdvection[i];
+						break;
+					}
+					default:
+						assert(false);
+						break;
+				}
+
+				SolveImplicit(timeDiscretizer, rhs.data() + offset, u + offset);
+				setBoundaryConditions(rhs.data());
+				std::copy(rhs.begin(), rhs.end(), u);
+			}
+		}
+
+		template<typename stdType, template<typename> class matrixType, class boundaryConditionSetter>
+		void IterateLinearMultiStep(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const size_t nRows, const size_t offset, const boundaryConditionSetter& setBoundaryConditions, const unsigned nSteps)
+		{
+			const auto& multiStep = *timeDiscretizer.linearMultiStep;
+			const size_t n = multiStep.spaceDiscretizer.nRows();
+			const size_t nHistory = multiStep.weights.size();
+			const bool isExplicit = multiStep.solverType == ExtendedSolverType::AdamsBashforth3 || multiStep.solverType == ExtendedSolverType::AdamsBashforth4;
+			stdType* u = solution.data();
+
+			// entry of u_{n - j}
+			const auto getEntry = [&multiStep, nHistory](const size_t j) -> std::vector<stdType>& { return multiStep.history[(multiStep.newest + j) % nHistory]; };
+
+			// the caller resets the history (ResetStepHistory) whenever u isn't where the last step left it
+			if (multiStep.nFilled == 0)
+			{
+				if (isExplicit)
+					multiStep.spaceDiscretizer.Dot(getEntry(0).data(), u + offset);
+				else
+					std::copy(u + offset, u + offset + n, getEntry(0).begin());
+				multiStep.nFilled = 1;
+			}
+
+			std::vector<stdType> rhs(nRows);
+			for (unsigned step = 0; step < nSteps; ++step)
+			{
+				if (multiStep.nFilled < nHistory)
+				{
+					multiStep.starter->Apply(u + offset);
+					setBoundaryConditions(u);
+				}
+				else
+				{
+					std::copy(u, u + nRows, rhs.begin());
+					if (!isExplicit)
+						std::fill(rhs.begin() + offset, rhs.begin() + offset + n, stdType(0.0));
+
+					for (size_t j = 0; j < nHistory; ++j)
+					{
+						const stdType weight = multiStep.weights[j];
+						const std::vector<stdType>& entry = getEntry(j);
+						for (size_t i = 0; i < n; ++i)
+							rhs[offset + i] += weight * entry[i];
+					}
+
+					// Adams-Bashforth has no M, and this is a no-op
+					SolveImplicit(timeDiscretizer, rhs.data() + offset, u + offset);
+					setBoundaryConditions(rhs.data());
+					std::copy(rhs.begin(), rhs.end(), u);
+				}
+
+				// the oldest entry becomes the newest one, and the explicit schemes apply L there once per step
+				multiStep.newest = (multiStep.newest + nHistory - 1) % nHistory;
+				if (isExplicit)
+					multiStep.spaceDiscretizer.Dot(getEntry(0).data(), u + offset);
+				else
+					std::copy(u + offset, u + offset + n, getEntry(0).begin());
+				multiStep.nFilled = std::min(multiStep.nFilled + 1, nHistory);
+			}
+		}
+
+		/**
+		* Shared by Iterate1D and Iterate2D: the propagators act on the nRows - 2 * offset points after the first offset ones.
+		* buffer holds the new step of the matrix propagators, and trades its storage with a single column solution, so that neither reallocates once both are nRows long
+		*/
+		template<typename stdType, template<typename> class matrixType, class boundaryConditionSetter>
+		void IterateMultiStep(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const size_t nRows, const size_t offset, const boundaryConditionSetter& setBoundaryConditions, const unsigned nSteps, std::vector<stdType>& buffer)
+		{
+			if (timeDiscretizer.krylovExponential)
+			{
+				// one-step: only the current solution, which is the first column, is advanced
+				for (unsigned n = 0; n < nSteps; ++n)
+				{
+					timeDiscretizer.krylovExponential->Apply(solution.data() + offset);
+					setBoundaryConditions(solution.data());
+				}
+				return;
+			}
+
+			if (timeDiscretizer.imexSplitting)
+			{
+				// one-step (or carrying its own history): only the current solution, which is the first column, is advanced
+				IterateImex(solution, timeDiscretizer, nRows, offset, setBoundaryConditions, nSteps);
+				return;
+			}
+
+			if (timeDiscretizer.linearMultiStep)
+			{
+				// only the current solution, which is the first column, is advanced: the history is kept in the time discretizer
+				IterateLinearMultiStep(solution, timeDiscretizer, nRows, offset, setBoundaryConditions, nSteps);
+				return;
+			}
+
+			if (timeDiscretizer.embeddedRungeKutta)
+			{
+				// adaptive: the steps taken don't need to match nSteps, only the time covered does
+				timeDiscretizer.embeddedRungeKutta->Advance(solution.data(), offset, nSteps * timeDiscretizer.embeddedRungeKutta->nominalStep(), setBoundaryConditions);
+				return;
+			}
+
+			const size_t nCols = timeDiscretizer.size();
+			assert(solution.size() == nRows * nCols);
+
+			buffer.resize(nRows);
+			for (unsigned n = 0; n < nSteps; ++n)
+			{
+				// u_{n + 1} = M^{-1} * sum_j A_j * u_{n - j}
+				timeDiscretizer.matrices[0].Dot(buffer.data() + offset, solution.data() + offset);
+				for (size_t j = 1; j < nCols; ++j)
+					timeDiscretizer.matrices[j].Dot(buffer.data() + offset, solution.data() + j * nRows + offset, stdType(1.0), stdType(1.0));
+				// the previous step is a good starting point for the iterative solver
+				SolveImplicit(timeDiscretizer, buffer.data() + offset, solution.data() + offset);
+
+				setBoundaryConditions(buffer.data());
+
+				if (nCols == 1)
+					solution.swap(buffer);
+				else
+				{
+					// shift the history by one step, dropping the oldest
+					std::copy_backward(solution.begin(), solution.end() - nRows, solution.end());
+					std::copy(buffer.begin(), buffer.end(), solution.begin());
+				}
+			}
+		}
+
+		template<typename stdType, template<typename> class matrixType, class boundaryConditionSetter>
+		void IterateWaveEquation(std::vector<stdType>& solution, std::vector<stdType>& solutionDerivative, const BandedTimeDiscretizer<stdType, matrixType>& timeDiscretizer, const matrixType<stdType>& spaceDiscretizer, const double dt, const size_t offset, const boundaryConditionSetter& setBoundaryConditions, const unsigned nSteps)
+		{
+			const size_t nRows = solution.size();
+			const stdType _dt = static_cast<stdType>(dt);
+
+			if (timeDiscretizer.stormerVerlet)
+			{
+				if (nSteps == 0)
+					return;
+
+				// u_{n + 1/2} = u_n + dt / 2 * v_n; v_{n + 1} = v_n + dt * L * u_{n + 1/2}; u_{n + 1} = u_{n + 1/2} + dt / 2 * v_{n + 1}:
+				// the closing half drift of a step and the opening one of the next are merged, so that each step is one stencil sweep and one vector update
+				stdType drift = stdType(.5) * _dt;
+				for (unsigned n = 0; n < nSteps; ++n)
+				{
+					for (size_t i = 0; i < nRows; ++i)
+						solution[i] += drift * solutionDerivative[i];
+					setBoundaryConditions(solution.data());
+
+					spaceDiscretizer.Dot(solutionDerivative.data() + offset, solution.data() + offset, _dt, stdType(1.0));
+					setBoundaryConditions(solutionDerivative.data());
+
+					drift = _dt;
+				}
+
+				for (size_t i = 0; i < nRows; ++i)
+					solution[i] += stdType(.5) * _dt * solutionDerivative[i];
+				setBoundaryConditions(solution.data());
+				return;
+			}
+
+			std::vector<stdType> solutionBuffer(nRows), solutionDerivativeBuffer(nRows), workBuffer(nRows);
+			for (unsigned n = 0; n < nSteps; ++n)
+			{
+				for (size_t i = 0; i < nRows; ++i)
+					workBuffer[i] = solution[i] + _dt * solutionDerivative[i];
+				timeDiscretizer.matrices[0].Dot(solutionBuffer.data() + offset, workBuffer.data() + offset);
+				SolveImplicit(timeDiscretizer, solutionBuffer.data() + offset, solution.data() + offset);
+				setBoundaryConditions(solutionBuffer.data());
+
+				std::copy(solutionDerivative.begin(), solutionDerivative.end(), workBuffer.begin());
+				spaceDiscretizer.Dot(workBuffer.data() + offset, solution.data() + offset, _dt, stdType(1.0));
+				timeDiscretizer.matrices[0].Dot(solutionDerivativeBuffer.data() + offset, workBuffer.data() + offset);
+				SolveImplicit(timeDiscretizer, solutionDerivativeBuffer.data() + offset, solutionDerivative.data() + offset);
+				setBoundaryConditions(solutionDerivativeBuffer.data());
+
+				solution.swap(solutionBuffer);
+				solutionDerivative.swap(solutionDerivativeBuffer);
+			}
+		}
+
+		template<typename stdType>
+		void Iterate1D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const unsigned nSteps)
+		{
+			std::vector<stdType> stepBuffer;
+			Iterate1D(solution, timeDiscretizer, input, nSteps, stepBuffer);
+		}
+
+		template<typename stdType>
+		void Iterate1D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const unsigned nSteps, std::vector<stdType>& stepBuffer)
+		{
+			// periodic propagators skip the ghost points
+			const size_t offset = IsPeriodic(input) ? 1 : 0;
+			IterateMultiStep(solution, timeDiscretizer, input.spaceGrid.size(), offset, [&input](stdType* buffer) { SetBoundaryConditions1D(buffer, input); }, nSteps, stepBuffer);
+		}
+
+		template<typename stdType>
+		bool AdvanceAdaptive1D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const double duration)
+		{
+			if (!timeDiscretizer.embeddedRungeKutta)
+				return false;
+
+			const size_t offset = IsPeriodic(input) ? 1 : 0;
+			timeDiscretizer.embeddedRungeKutta->Advance(solution.data(), offset, duration, [&input](stdType* buffer) { SetBoundaryConditions1D(buffer, input); });
+			return true;
+		}
+
+		template<typename stdType>
+		void IterateWaveEquation1D(std::vector<stdType>& solution, std::vector<stdType>& solutionDerivative, const BandedTimeDiscretizer<stdType>& timeDiscretizer, const BandedMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput1D<stdType>& input, const unsigned nSteps)
+		{
+			const size_t offset = IsPeriodic(input) ? 1 : 0;
+			IterateWaveEquation(solution, solutionDerivative, timeDiscretizer, spaceDiscretizer, input.dt, offset, [&input](stdType* buffer) { SetBoundaryConditions1D(buffer, input); }, nSteps);
+		}
+
+		/**
+		* u_{n + 1} = P(dt * L) * u_n with P the Taylor polynomial of the given order: by Horner, order stencil sweeps per step and two work buffers
+		*/
+		template<typename stdType>
+		void IterateMatrixFree2D(std::vector<stdType>& solution, const unsigned order, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps, const KroneckerOperator2D<stdType>* kroneckerSpaceDiscretizer)
+		{
+			const size_t dimension = solution.size();
+			std::vector<stdType> propagated(dimension), work(dimension);
+			for (unsigned n = 0; n < nSteps; ++n)
+			{
+				// w = u; w = u + dt / k * L * w, for k = order, ..., 1
+				std::copy(solution.begin(), solution.end(), propagated.begin());
+				for (unsigned k = order; k >= 1; --k)
+				{
+					if (kroneckerSpaceDiscretizer)
+						ApplySpaceDiscretizer2D(work.data(), propagated.data(), *kroneckerSpaceDiscretizer);
+					else
+						ApplySpaceDiscretizer2D(work.data(), propagated.data(), input);
+
+					const stdType alpha = static_cast<stdType>(input.dt / k);
+					for (size_t i = 0; i < dimension; ++i)
+						propagated[i] = solution[i] + alpha * work[i];
+				}
+
+				SetBoundaryConditions2D(propagated.data(), input);
+				solution.swap(propagated);
+			}
+		}
+
+		template<typename stdType>
+		void IterateFastDiagonalization2D(std::vector<stdType>& solution, const FastDiagonalization2D<stdType>& fastDiagonalization, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps)
+		{
+			const auto& spaceDiscretizer = fastDiagonalization.spaceDiscretizer;
+			const auto& xTransform = fastDiagonalization.xTransform;
+			const auto& yTransform = fastDiagonalization.yTransform;
+			const size_t nRows = input.xSpaceGrid.size();
+			const size_t nCols = input.ySpaceGrid.size();
+			const size_t mRows = xTransform.size();
+			const size_t mCols = yTransform.size();
+
+			// only the Dirichlet boundary values couple with the interior: periodic ghosts are accounted for by the Fourier modes
+			const auto& bc = input.boundaryConditions;
+			const bool xDirichlet = bc.up.type == BoundaryConditionType::Dirichlet;
+			const bool yDirichlet = bc.left.type == BoundaryConditionType::Dirichlet;
+			const auto isDirichletBoundary = [&](const size_t i, const size_t j)
+			{
+				return (xDirichlet && (i == 0 || i == nRows - 1)) || (yDirichlet && (j == 0 || j == nCols - 1));
+			};
+
+			std::vector<stdType> rhs(nRows * nCols), work(nRows * nCols), boundaryValues(nRows * nCols);
+			std::vector<stdType> interior(mRows * mCols), transposed(mRows * mCols);
+			for (unsigned n = 0; n < nSteps; ++n)
+			{
+				stdType* u = solution.data();
+
+				// rhs = (I + explicitWeight * L) * u_n, whose boundary values are the ones of u_n
+				std::copy(u, u + rhs.size(), rhs.begin());
+				if (fastDiagonalization.explicitWeight != stdType(0.0))
+				{
+					ApplySpaceDiscretizer2D(work.data(), u, spaceDiscretizer);
+					for (size_t k = 0; k < rhs.size(); ++k)
+						rhs[k] += fastDiagonalization.explicitWeight * work[k];
+				}
+
+				// the boundary rows of I - implicitWeight * L are the identity: their contribution to the interior rows moves to the right hand side
+				if (xDirichlet || yDirichlet)
+				{
+					for (size_t j = 0; j < nCols; ++j)
+						for (size_t i = 0; i < nRows; ++i)
+							boundaryValues[i + j * nRows] = isDirichletBoundary(i, j) ? rhs[i + j * nRows] : stdType(0.0);
+					ApplySpaceDiscretizer2D(work.data(), boundaryValues.data(), spaceDiscretizer);
+					for (size_t k = 0; k < rhs.size(); ++k)
+						rhs[k] += fastDiagonalization.implicitWeight * work[k];
+				}
+
+				// x transform on every interior grid column, then y transform on every interior grid row (through a transposed copy, so that it's contiguous)
+				for (size_t j = 0; j < mCols; ++j)
+				{
+					std::copy(rhs.begin() + 1 + (j + 1) * nRows, rhs.begin() + 1 + (j + 1) * nRows + mRows, interior.begin() + j * mRows);
+					xTransform.Forward(interior.data() + j * mRows);
+				}
+				for (size_t j = 0; j < mCols; ++j)
+					for (size_t i = 0; i < mRows; ++i)
+						transposed[j + i * mCols] = interior[i + j * mRows];
+
+				for (size_t i = 0; i < mRows; ++i)
+				{
+					stdType* row = transposed.data() + i * mCols;
+					yTransform.Forward(row);
+					for (size_t j = 0; j < mCols; ++j)
+						row[j] /= stdType(1.0) - fastDiagonalization.implicitWeight * (fastDiagonalization.xEigenvalues[i] + fastDiagonalization.yEigenvalues[j]);
+					yTransform.Backward(row);
+				}
+
+				for (size_t j = 0; j < mCols; ++j)
+					for (size_t i = 0; i < mRows; ++i)
+						interior[i + j * mRows] = transposed[j + i * mCols];
+				for (size_t j = 0; j < mCols; ++j)
+				{
+					xTransform.Backward(interior.data() + j * mRows);
+					std::copy(interior.begin() + j * mRows, interior.begin() + (j + 1) * mRows, u + 1 + (j + 1) * nRows);
+				}
+
+				SetBoundaryConditions2D(u, input);
+			}
+		}
+
+		template<typename stdType>
+		bool AdvanceAdaptive2D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const double duration)
+		{
+			if (!timeDiscretizer.embeddedRungeKutta)
+				return false;
+
+			timeDiscretizer.embeddedRungeKutta->Advance(solution.data(), 0, duration, [&input](stdType* buffer) { SetBoundaryConditions2D(buffer, input); });
+			return true;
+		}
+
+		template<typename stdType>
+		void Iterate2D(std::vector<stdType>& solution, const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps, const KroneckerOperator2D<stdType>* kroneckerSpaceDiscretizer)
+		{
+			if (timeDiscretizer.fastDiagonalization)
+			{
+				IterateFastDiagonalization2D(solution, *timeDiscretizer.fastDiagonalization, input, nSteps);
+				return;
+			}
+
+			if (timeDiscretizer.matrixFreeOrder > 0)
+			{
+				IterateMatrixFree2D(solution, timeDiscretizer.matrixFreeOrder, input, nSteps, kroneckerSpaceDiscretizer);
+				return;
+			}
+
+			std::vector<stdType> stepBuffer;
+			IterateMultiStep(solution, timeDiscretizer, input.xSpaceGrid.size() * input.ySpaceGrid.size(), 0, [&input](stdType* buffer) { SetBoundaryConditions2D(buffer, input); }, nSteps, stepBuffer);
+		}
+
+		template<typename stdType>
+		void IterateAdi2D(std::vector<stdType>& solution, const AdiTimeDiscretizer<stdType>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps)
+		{
+			const size_t nRows = input.xSpaceGrid.size();
+			const size_t nCols = input.ySpaceGrid.size();
+			const size_t dimension = nRows * nCols;
+			assert(solution.size() >= dimension);
+
+			const KroneckerOperator2D<stdType>* kroneckerHalfStep = timeDiscretizer.kroneckerHalfStep.get();
+			std::vector<stdType> intermediate(dimension);
+			std::vector<stdType> transposed(kroneckerHalfStep ? dimension : 0);
+
+			// the periodic line factorizations only span the interior points
+			const size_t xOffset = timeDiscretizer.xPeriodic ? 1 : 0;
+			const size_t yOffset = timeDiscretizer.yPeriodic ? 1 : 0;
+
+			// periodic axes: the explicit half steps read the ghost lines, which have to be copies of the interior ones, as SetBoundaryConditions2D leaves them
+			const auto wrapGhosts = [&](stdType* x)
+			{
+				if (timeDiscretizer.xPeriodic)
+				{
+					for (size_t j = 0; j < nCols; ++j)
+					{
+						x[j * nRows] = x[j * nRows + nRows - 2];
+						x[j * nRows + nRows - 1] = x[j * nRows + 1];
+					}
+				}
+				if (timeDiscretizer.yPeriodic)
+				{
+					std::copy(x + (nCols - 2) * nRows, x + (nCols - 1) * nRows, x);
+					std::copy(x + nRows, x + 2 * nRows, x + (nCols - 1) * nRows);
+				}
+			};
+
+			// out += alpha * .5 * dt * Lx * in
+			const auto dotX = [&](stdType* out, const stdType* in, const stdType alpha)
+			{
+				if (kroneckerHalfStep)
+					KroneckerDotX(out, in, kroneckerHalfStep->xOperator, nCols, alpha);
+				else
+					timeDiscretizer.halfStepX.Dot(out, in, alpha, stdType(1.0));
+			};
+			const auto dotY = [&](stdType* out, const stdType* in, const stdType alpha)
+			{
+				if (kroneckerHalfStep)
+					KroneckerDotY(out, in, kroneckerHalfStep->yOperator, nRows, alpha);
+				else
+					timeDiscretizer.halfStepY.Dot(out, in, alpha, stdType(1.0));
+			};
+
+			// x = (I - .5 * dt * Lx)^{-1} * x: the boundary grid columns are left untouched
+			const auto solveX = [&](stdType* x)
+			{
+				if (!kroneckerHalfStep)
+				{
+					timeDiscretizer.xFactorization->Solve(x);
+					return;
+				}
+
+				for (size_t j = 1; j + 1 < nCols; ++j)
+					timeDiscretizer.xLineFactorization->Solve(x + j * nRows + xOffset);
+			};
+
+			// x = (I - .5 * dt * Ly)^{-1} * x: the 1D factorization needs contiguous grid rows, so the interior ones go through a transposed copy
+			const auto solveY = [&](stdType* x)
+			{
+				if (!kroneckerHalfStep)
+				{
+					timeDiscretizer.yFactorization->Solve(x);
+					return;
+				}
+
+				for (size_t j = 0; j < nCols; ++j)
+					for (size_t i = 1; i + 1 < nRows; ++i)
+						transposed[j + i * nCols] = x[i + j * nRows];
+				for (size_t i = 1; i + 1 < nRows; ++i)
+					timeDiscretizer.yLineFactorization->Solve(transposed.data() + i * nCols + yOffset);
+				for (size_t j = 0; j < nCols; ++j)
+					for (size_t i = 1; i + 1 < nRows; ++i)
+						x[i + j * nRows] = transposed[j + i * nCols];
+			};
+
+			for (unsigned n = 0; n < nSteps; ++n)
+			{
+				stdType* u = solution.data();
+				wrapGhosts(u);
+				switch (timeDiscretizer.solverType)
+				{
+					case ExtendedSolverType::PeacemanRachford:
+						// (I - .5 * dt * Lx) * u* = (I + .5 * dt * Ly) * u_n
+						std::copy(u, u + dimension, intermediate.begin());
+						dotY(intermediate.data(), u, stdType(1.0));
+						solveX(intermediate.data());
+						wrapGhosts(intermediate.data());
+
+						// (I - .5 * dt * Ly) * u_{n + 1} = (I + .5 * dt * Lx) * u*
+						std::copy(intermediate.begin(), intermediate.end(), u);
+						dotX(u, intermediate.data(), stdType(1.0));
+						solveY(u);
+						break;
+					case ExtendedSolverType::Douglas:
+						// (I - .5 * dt * Lx) * u* = (I + .5 * dt * Lx + dt * Ly) * u_n
+						std::copy(u, u + dimension, intermediate.begin());
+						dotX(intermediate.data(), u, stdType(1.0));
+						dotY(intermediate.data(), u, stdType(2.0));
+						solveX(intermediate.data());
+
+						// (I - .5 * dt * Ly) * u_{n + 1} = u* - .5 * dt * Ly * u_n
+						dotY(intermediate.data(), u, stdType(-1.0));
+						std::copy(intermediate.begin(), intermediate.end(), u);
+						solveY(u);
+						break;
+					default:
+						assert(false);
+						break;
+				}
+
+				SetBoundaryConditions2D(u, input);
+			}
+		}
+
+		template<typename stdType>
+		void IterateStrangSplitting2D(std::vector<stdType>& solution, const StrangSplitting2D<stdType>& timeDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps)
+		{
+			const size_t nRows = input.xSpaceGrid.size();
+			assert(solution.size() >= nRows * input.ySpaceGrid.size());
+
+			// line l starts at (l + 1) * lineStride, and its points are pointStride apart: the grid rows go through a contiguous copy, as in IterateAdi2D
+			const auto sweep = [&solution](const std::vector<HostFiniteDifferenceInput1D<stdType>>& lines, const std::vector<BandedTimeDiscretizer<stdType>>& timeDiscretizers, const std::vector<size_t>& lineTimeDiscretizers, const size_t lineStride, const size_t pointStride)
+			{
+				const int nLines = static_cast<int>(lines.size());
+
+				// each line only reads and writes its own points, and the time discretizers are only read:
+				// the copy of the line and the new step are per thread scratch, which only allocates on the first line of each thread
+				#pragma omp parallel
+				{
+					std::vector<stdType> line;
+					std::vector<stdType> stepBuffer;
+
+					#pragma omp for
+					for (int l = 0; l < nLines; ++l)
+					{
+						const size_t nPoints = lines[l].spaceGrid.size();
+						stdType* first = solution.data() + (l + 1) * lineStride;
+
+						line.resize(nPoints);
+						for (size_t p = 0; p < nPoints; ++p)
+							line[p] = first[p * pointStride];
+						Iterate1D(line, timeDiscretizers[lineTimeDiscretizers[l]], lines[l], 1, stepBuffer);
+						for (size_t p = 0; p < nPoints; ++p)
+							first[p * pointStride] = line[p];
+					}
+				}
+			};
+
+			for (unsigned n = 0; n < nSteps; ++n)
+			{
+				sweep(timeDiscretizer.xLines, timeDiscretizer.xTimeDiscretizers, timeDiscretizer.xLineTimeDiscretizers, nRows, 1);
+				sweep(timeDiscretizer.yLines, timeDiscretizer.yTimeDiscretizers, timeDiscretizer.yLineTimeDiscretizers, 1, nRows);
+				sweep(timeDiscretizer.xLines, timeDiscretizer.xTimeDiscretizers, timeDiscretizer.xLineTimeDiscretizers, nRows, 1);
+
+				// the sweeps have set the boundary lines, but the corners
+				SetBoundaryConditions2D(solution.data(), input);
+			}
+		}
+
+		template<typename stdType>
+		void IterateWaveEquation2D(std::vector<stdType>& solution, std::vector<stdType>& solutionDerivative, const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizer, const SparseDiagonalMatrix<stdType>& spaceDiscretizer, const HostFiniteDifferenceInput2D<stdType>& input, const unsigned nSteps)
+		{
+			IterateWaveEquation(solution, solutionDerivative, timeDiscretizer, spaceDiscretizer, input.dt, 0, [&input](stdType* buffer) { SetBoundaryConditions2D(buffer, input); }, nSteps);
+		}
+	}
+}
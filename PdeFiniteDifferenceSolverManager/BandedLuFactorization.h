@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <BandedMatrix.h>
+
+namespace pde
+{
+	/**
+	*	LU factorization of a banded matrix without pivoting, computed once and then applied with a forward/back substitution in O(nRows * nDiagonals).
+	*	For a tridiagonal matrix this is the Thomas algorithm.
+	*	No pivoting means no fill-in outside the band: this is safe for the diagonally dominant I - c * dt * L matrices of the implicit schemes.
+	*	A periodic tridiagonal matrix is split into a tridiagonal one plus a rank one correction for its corners (Sherman-Morrison), so that it is still solved in O(nRows).
+	*/
+	template<typename stdType>
+	class BandedLuFactorization
+	{
+	public:
+		explicit BandedLuFactorization(const BandedMatrix<stdType>& matrix);
+
+		virtual ~BandedLuFactorization() noexcept = default;
+		BandedLuFactorization(const BandedLuFactorization& rhs) = default;
+		BandedLuFactorization(BandedLuFactorization&& rhs) noexcept = default;
+		BandedLuFactorization& operator=(const BandedLuFactorization& rhs) = default;
+		BandedLuFactorization& operator=(BandedLuFactorization&& rhs) noexcept = default;
+
+		unsigned nRows() const noexcept { return factors.nRows(); }
+
+		/**
+		* x = A^{-1} * x
+		*/
+		void Solve(stdType* x) const;
+
+	private:
+		void Factorize();
+		void SolveBanded(stdType* x) const;
+
+		/**
+		* Unit lower triangular factor below the main diagonal, upper triangular factor on and above it
+		*/
+		BandedMatrix<stdType> factors;
+
+		/**
+		* Reciprocal of the upper factor diagonal, so that the back substitution has no divisions
+		*/
+		std::vector<stdType> inverseDiagonal;
+
+		/**
+		* Periodic matrices only: A = B + u * v^T, with u = (gamma, 0, ..., 0, A(n - 1, 0)) and v = (1, 0, ..., 0, A(0, n - 1) / gamma).
+		* correction = B^{-1} * u is computed once, so that A^{-1} * x = y - (v^T * y) / (1 + v^T * correction) * correction, with y = B^{-1} * x
+		*/
+		std::vector<stdType> correction;
+		stdType cornerRatio = stdType(0.0);
+		stdType correctionScale = stdType(0.0);
+	};
+}
+
+#include <BandedLuFactorization.tpp>
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <BandedLuFactorization.h>
+#include <algorithm>
+#include <cassert>
+
+namespace pde
+{
+	template<typename stdType>
+	BandedLuFactorization<stdType>::BandedLuFactorization(const BandedMatrix<stdType>& matrix)
+		: factors(matrix.nRows(), matrix.lowerBandwidth(), matrix.upperBandwidth()),
+		inverseDiagonal(matrix.nRows())
+	{
+		const unsigned n = matrix.nRows();
+		for (int k = -static_cast<int>(matrix.lowerBandwidth()); k <= static_cast<int>(matrix.upperBandwidth()); ++k)
+			std::copy(matrix.Diagonal(k), matrix.Diagonal(k) + n, factors.Diagonal(k));
+
+		if (!matrix.periodic())
+		{
+			Factorize();
+			return;
+		}
+
+		assert(matrix.lowerBandwidth() == 1 && matrix.upperBandwidth() == 1 && n >= 3);
+
+		// the corners are stored in the wrapped slots of the off-diagonals, which the non-periodic factors never read
+		const stdType topRight = matrix(0, n - 1);
+		const stdType bottomLeft = matrix(n - 1, 0);
+		const stdType gamma = -matrix(0, 0);
+		cornerRatio = topRight / gamma;
+
+		factors(0, 0) -= gamma;
+		factors(n - 1, n - 1) -= bottomLeft * cornerRatio;
+		Factorize();
+
+		correction.assign(n, stdType(0.0));
+		correction[0] = gamma;
+		correction[n - 1] = bottomLeft;
+		SolveBanded(correction.data());
+		correctionScale = stdType(1.0) / (stdType(1.0) + correction[0] + cornerRatio * correction[n - 1]);
+	}
+
+	template<typename stdType>
+	void BandedLuFactorization<stdType>::Factorize()
+	{
+		const unsigned n = factors.nRows();
+		const unsigned lowerBandwidth = factors.lowerBandwidth();
+		const unsigned upperBandwidth = factors.upperBandwidth();
+
+		for (unsigned k = 0; k < n; ++k)
+		{
+			assert(factors(k, k) != stdType(0.0));
+			inverseDiagonal[k] = stdType(1.0) / factors(k, k);
+
+			const unsigned iEnd = std::min(n, k + lowerBandwidth + 1);
+			const unsigned jEnd = std::min(n, k + upperBandwidth + 1);
+			for (unsigned i = k + 1; i < iEnd; ++i)
+			{
+				const stdType multiplier = factors(i, k) * inverseDiagonal[k];
+				factors(i, k) = multiplier;
+				for (unsigned j = k + 1; j < jEnd; ++j)
+					factors(i, j) -= multiplier * factors(k, j);
+			}
+		}
+	}
+
+	template<typename stdType>
+	void BandedLuFactorization<stdType>::Solve(stdType* x) const
+	{
+		SolveBanded(x);
+		if (correction.empty())
+			return;
+
+		const unsigned n = factors.nRows();
+		const stdType projection = (x[0] + cornerRatio * x[n - 1]) * correctionScale;
+		for (unsigned i = 0; i < n; ++i)
+			x[i] -= projection * correction[i];
+	}
+
+	template<typename stdType>
+	void BandedLuFactorization<stdType>::SolveBanded(stdType* x) const
+	{
+		const unsigned n = factors.nRows();
+		const unsigned lowerBandwidth = factors.lowerBandwidth();
+		const unsigned upperBandwidth = factors.upperBandwidth();
+
+		// forward substitution: L * y = x
+		for (unsigned i = 1; i < n; ++i)
+		{
+			const unsigned kBegin = i > lowerBandwidth ? i - lowerBandwidth : 0;
+			for (unsigned k = kBegin; k < i; ++k)
+				x[i] -= factors(i, k) * x[k];
+		}
+
+		// back substitution: U * x = y
+		for (unsigned i = n; i-- > 0;)
+		{
+			const unsigned jEnd = std::min(n, i + upperBandwidth + 1);
+			for (unsigned j = i + 1; j < jEnd; ++j)
+				x[i] -= factors(i, j) * x[j];
+			x[i] *= inverseDiagonal[i];
+		}
+	}
+}
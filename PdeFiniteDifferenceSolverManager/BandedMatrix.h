@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vector>
+
+namespace pde
+{
+	/**
+	*	Kernel policies of BandedMatrix::Dot: FieldCoefficients reads one weight per element of each diagonal,
+	*	ConstantCoefficients applies the same weight to a whole diagonal, so that only the input is streamed
+	*/
+	struct FieldCoefficients {};
+	struct ConstantCoefficients {};
+
+	/**
+	*	Square matrix stored by diagonals: only the lowerBandwidth sub-diagonals, the main diagonal and the upperBandwidth super-diagonals are kept.
+	*	Diagonal k (with -lowerBandwidth <= k <= upperBandwidth) is stored contiguously, so that element (i, i + k) lives at diagonals[(k + lowerBandwidth) * nRows + i].
+	*	Entries of a diagonal that fall outside the matrix are never read, unless the matrix is periodic: in that case the diagonals wrap around,
+	*	so that element (i, (i + k) mod nRows) lives at diagonals[(k + lowerBandwidth) * nRows + i], and the corner entries use the otherwise unused slots.
+	*/
+	template<typename stdType>
+	class BandedMatrix
+	{
+	public:
+		BandedMatrix(const unsigned nRows = 0, const unsigned lowerBandwidth = 0, const unsigned upperBandwidth = 0, const stdType value = stdType(0.0), const bool periodic = false);
+
+		virtual ~BandedMatrix() noexcept = default;
+		BandedMatrix(const BandedMatrix& rhs) = default;
+		BandedMatrix(BandedMatrix&& rhs) noexcept = default;
+		BandedMatrix& operator=(const BandedMatrix& rhs) = default;
+		BandedMatrix& operator=(BandedMatrix&& rhs) noexcept = default;
+
+		static BandedMatrix Identity(const unsigned nRows);
+
+		unsigned nRows() const noexcept { return _nRows; }
+		unsigned lowerBandwidth() const noexcept { return _lowerBandwidth; }
+		unsigned upperBandwidth() const noexcept { return _upperBandwidth; }
+		unsigned nDiagonals() const noexcept { return _lowerBandwidth + _upperBandwidth + 1; }
+		bool periodic() const noexcept { return _periodic; }
+
+		/**
+		* Pointer to the first element of the k-th diagonal: element (i, i + k) is at Diagonal(k)[i].
+		* Writing through it does not update the constant rows: call DropConstantCoefficients or DetectConstantCoefficients afterwards
+		*/
+		stdType* Diagonal(const int k) noexcept { return diagonals.data() + (k + static_cast<int>(_lowerBandwidth)) * _nRows; }
+		const stdType* Diagonal(const int k) const noexcept { return diagonals.data() + (k + static_cast<int>(_lowerBandwidth)) * _nRows; }
+
+		/**
+		* Element access: (i, j) must lie within the band
+		*/
+		stdType& operator()(const unsigned i, const unsigned j) noexcept { return Diagonal(DiagonalIndex(i, j))[i]; }
+		const stdType& operator()(const unsigned i, const unsigned j) const noexcept { return Diagonal(DiagonalIndex(i, j))[i]; }
+
+		void Set(const stdType value);
+		void Scale(const stdType alpha);
+
+		/**
+		* this += alpha * I
+		*/
+		void AddIdentity(const stdType alpha = stdType(1.0));
+
+		/**
+		* this += alpha * rhs: rhs bandwidths must not exceed this bandwidths
+		*/
+		void AddEqual(const BandedMatrix& rhs, const stdType alpha = stdType(1.0));
+
+		/**
+		* out = alpha * this * in (+ beta * out): both vectors have size nRows
+		*/
+		void Dot(stdType* out, const stdType* in, const stdType alpha = stdType(1.0), const stdType beta = stdType(0.0)) const;
+
+		/**
+		* Number of stored elements: this is what the operator costs in memory and per matrix-vector product
+		*/
+		size_t size() const noexcept { return diagonals.size(); }
+
+		/**
+		* Finds the rows over which every diagonal is constant, up to relativeTolerance times the largest weight: Dot applies the ConstantCoefficients kernel there.
+		* This is the case of the interior rows of a constant-coefficient stencil on a uniform grid; Scale and AddIdentity keep the rows, Set and AddEqual drop them
+		*/
+		void DetectConstantCoefficients(const double relativeTolerance = 1e-12);
+
+		/**
+		* Falls back to the FieldCoefficients kernel on every row: required after writing through Diagonal or operator() on a detected matrix
+		*/
+		void DropConstantCoefficients() noexcept { _constantCoefficientsBegin = _constantCoefficientsEnd = 0; }
+
+		/**
+		* Rows [constantCoefficientsBegin, constantCoefficientsEnd) use the ConstantCoefficients kernel: empty unless detected
+		*/
+		unsigned constantCoefficientsBegin() const noexcept { return _constantCoefficientsBegin; }
+		unsigned constantCoefficientsEnd() const noexcept { return _constantCoefficientsEnd; }
+
+	private:
+		int DiagonalIndex(const unsigned i, const unsigned j) const noexcept;
+
+		/**
+		* out[i] += alpha * (this * in)[i], for rowBegin <= i < rowEnd
+		*/
+		void DotRows(stdType* out, const stdType* in, const stdType alpha, const int rowBegin, const int rowEnd, FieldCoefficients) const;
+		void DotRows(stdType* out, const stdType* in, const stdType alpha, const int rowBegin, const int rowEnd, ConstantCoefficients) const;
+
+		unsigned _nRows;
+		unsigned _lowerBandwidth;
+		unsigned _upperBandwidth;
+		bool _periodic;
+
+		std::vector<stdType> diagonals;
+
+		/**
+		* One weight per diagonal, valid over the constant rows only
+		*/
+		std::vector<stdType> constantWeights;
+		unsigned _constantCoefficientsBegin = 0;
+		unsigned _constantCoefficientsEnd = 0;
+	};
+
+	/**
+	* Banded matrix-matrix product: the result bandwidths are the sum of the operands bandwidths, and both operands must have the same periodicity
+	*/
+	template<typename stdType>
+	BandedMatrix<stdType> Multiply(const BandedMatrix<stdType>& lhs, const BandedMatrix<stdType>& rhs, const stdType alpha = stdType(1.0));
+}
+
+#include <BandedMatrix.tpp>
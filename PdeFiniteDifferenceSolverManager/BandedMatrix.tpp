@@ -0,0 +1,244 @@
+#pragma once
+
+#include <BandedMatrix.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace pde
+{
+	template<typename stdType>
+	BandedMatrix<stdType>::BandedMatrix(const unsigned nRows, const unsigned lowerBandwidth, const unsigned upperBandwidth, const stdType value, const bool periodic)
+		: _nRows(nRows),
+		_lowerBandwidth(lowerBandwidth),
+		_upperBandwidth(upperBandwidth),
+		_periodic(periodic),
+		diagonals(static_cast<size_t>(lowerBandwidth + upperBandwidth + 1) * nRows, value)
+	{
+	}
+
+	template<typename stdType>
+	BandedMatrix<stdType> BandedMatrix<stdType>::Identity(const unsigned nRows)
+	{
+		return BandedMatrix<stdType>(nRows, 0, 0, stdType(1.0));
+	}
+
+	template<typename stdType>
+	int BandedMatrix<stdType>::DiagonalIndex(const unsigned i, const unsigned j) const noexcept
+	{
+		int k = static_cast<int>(j) - static_cast<int>(i);
+		if (_periodic)
+		{
+			// corner entries belong to the wrapped part of the nearest diagonal
+			if (k > static_cast<int>(_upperBandwidth))
+				k -= static_cast<int>(_nRows);
+			else if (k < -static_cast<int>(_lowerBandwidth))
+				k += static_cast<int>(_nRows);
+		}
+
+		return k;
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::Set(const stdType value)
+	{
+		std::fill(diagonals.begin(), diagonals.end(), value);
+		DropConstantCoefficients();
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::Scale(const stdType alpha)
+	{
+		for (auto& x : diagonals)
+			x *= alpha;
+		for (auto& w : constantWeights)
+			w *= alpha;
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::AddIdentity(const stdType alpha)
+	{
+		// the diagonals are written directly, so that the constant rows survive
+		stdType* mainDiagonal = diagonals.data() + _lowerBandwidth * _nRows;
+		for (unsigned i = 0; i < _nRows; ++i)
+			mainDiagonal[i] += alpha;
+		if (_constantCoefficientsEnd > _constantCoefficientsBegin)
+			constantWeights[_lowerBandwidth] += alpha;
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::AddEqual(const BandedMatrix& rhs, const stdType alpha)
+	{
+		assert(rhs._nRows == _nRows);
+		assert(rhs._periodic == _periodic || (rhs._lowerBandwidth == 0 && rhs._upperBandwidth == 0));
+		assert(rhs._lowerBandwidth <= _lowerBandwidth && rhs._upperBandwidth <= _upperBandwidth);
+
+		DropConstantCoefficients();
+		for (int k = -static_cast<int>(rhs._lowerBandwidth); k <= static_cast<int>(rhs._upperBandwidth); ++k)
+		{
+			stdType* lhsDiagonal = Diagonal(k);
+			const stdType* rhsDiagonal = rhs.Diagonal(k);
+			for (unsigned i = 0; i < _nRows; ++i)
+				lhsDiagonal[i] += alpha * rhsDiagonal[i];
+		}
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::Dot(stdType* out, const stdType* in, const stdType alpha, const stdType beta) const
+	{
+		if (beta == stdType(0.0))
+			std::fill(out, out + _nRows, stdType(0.0));
+		else if (beta != stdType(1.0))
+		{
+			for (unsigned i = 0; i < _nRows; ++i)
+				out[i] *= beta;
+		}
+
+		const int n = static_cast<int>(_nRows);
+		const int constantBegin = static_cast<int>(_constantCoefficientsBegin);
+		const int constantEnd = static_cast<int>(_constantCoefficientsEnd);
+		if (constantEnd <= constantBegin)
+		{
+			DotRows(out, in, alpha, 0, n, FieldCoefficients());
+			return;
+		}
+
+		DotRows(out, in, alpha, 0, constantBegin, FieldCoefficients());
+		DotRows(out, in, alpha, constantBegin, constantEnd, ConstantCoefficients());
+		DotRows(out, in, alpha, constantEnd, n, FieldCoefficients());
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::DotRows(stdType* out, const stdType* in, const stdType alpha, const int rowBegin, const int rowEnd, FieldCoefficients) const
+	{
+		// diagonal by diagonal, so that the inner loop is a contiguous axpy-like sweep
+		const int n = static_cast<int>(_nRows);
+		for (int k = -static_cast<int>(_lowerBandwidth); k <= static_cast<int>(_upperBandwidth); ++k)
+		{
+			const stdType* diagonal = Diagonal(k);
+			const int begin = std::max(rowBegin, -k);
+			const int end = std::min(rowEnd, n - k);
+			for (int i = begin; i < end; ++i)
+				out[i] += alpha * diagonal[i] * in[i + k];
+
+			if (!_periodic)
+				continue;
+
+			// wrapped part of the diagonal: only |k| entries, so the product stays O(nRows * nDiagonals)
+			for (int i = rowBegin; i < std::min(rowEnd, -k); ++i)
+				out[i] += alpha * diagonal[i] * in[((i + k) % n + n) % n];
+			for (int i = std::max(rowBegin, n - k); i < rowEnd; ++i)
+				out[i] += alpha * diagonal[i] * in[(i + k) % n];
+		}
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::DotRows(stdType* out, const stdType* in, const stdType alpha, const int rowBegin, const int rowEnd, ConstantCoefficients) const
+	{
+		// diagonal by diagonal with the weight hoisted out of the row loop: the constant rows never wrap, so each diagonal is a plain axpy
+		const int lowerBandwidth = static_cast<int>(_lowerBandwidth);
+		const int nDiagonals = static_cast<int>(this->nDiagonals());
+		for (int d = 0; d < nDiagonals; ++d)
+		{
+			const stdType weight = alpha * constantWeights[d];
+			const stdType* x = in + (d - lowerBandwidth);
+			for (int i = rowBegin; i < rowEnd; ++i)
+				out[i] += weight * x[i];
+		}
+	}
+
+	template<typename stdType>
+	void BandedMatrix<stdType>::DetectConstantCoefficients(const double relativeTolerance)
+	{
+		DropConstantCoefficients();
+
+		// only the rows whose stencil doesn't reach the boundaries are candidates
+		const unsigned firstRow = _lowerBandwidth;
+		const unsigned lastRow = _nRows > _upperBandwidth ? _nRows - _upperBandwidth : 0;
+		constexpr unsigned minConstantRows = { 8 };
+		if (lastRow < firstRow + minConstantRows)
+			return;
+
+		// the weights of the middle row are the reference, and the range grows from there
+		const unsigned referenceRow = (firstRow + lastRow) / 2;
+		const unsigned nDiagonals = this->nDiagonals();
+		std::vector<stdType> weights(nDiagonals);
+		double scale = 0.0;
+		for (unsigned d = 0; d < nDiagonals; ++d)
+		{
+			weights[d] = diagonals[d * _nRows + referenceRow];
+			scale = std::max(scale, std::fabs(static_cast<double>(weights[d])));
+		}
+		const double tolerance = relativeTolerance * scale;
+
+		const auto isConstantRow = [&](const unsigned i)
+		{
+			for (unsigned d = 0; d < nDiagonals; ++d)
+				if (std::fabs(static_cast<double>(diagonals[d * _nRows + i] - weights[d])) > tolerance)
+					return false;
+			return true;
+		};
+
+		unsigned begin = referenceRow;
+		while (begin > firstRow && isConstantRow(begin - 1))
+			--begin;
+		unsigned end = referenceRow + 1;
+		while (end < lastRow && isConstantRow(end))
+			++end;
+		if (end - begin < minConstantRows)
+			return;
+
+		constantWeights = std::move(weights);
+		_constantCoefficientsBegin = begin;
+		_constantCoefficientsEnd = end;
+	}
+
+	template<typename stdType>
+	BandedMatrix<stdType> Multiply(const BandedMatrix<stdType>& lhs, const BandedMatrix<stdType>& rhs, const stdType alpha)
+	{
+		assert(lhs.nRows() == rhs.nRows());
+		assert(lhs.periodic() == rhs.periodic());
+
+		const int n = static_cast<int>(lhs.nRows());
+		const bool periodic = lhs.periodic();
+
+		unsigned lowerBandwidth = lhs.lowerBandwidth() + rhs.lowerBandwidth();
+		unsigned upperBandwidth = lhs.upperBandwidth() + rhs.upperBandwidth();
+
+		// a periodic product keeps all its diagonals: on small grids some of them alias the same column, and Dot sums them
+		if (!periodic)
+		{
+			lowerBandwidth = std::min(lowerBandwidth, static_cast<unsigned>(std::max(n - 1, 0)));
+			upperBandwidth = std::min(upperBandwidth, static_cast<unsigned>(std::max(n - 1, 0)));
+		}
+		BandedMatrix<stdType> ret(lhs.nRows(), lowerBandwidth, upperBandwidth, stdType(0.0), periodic);
+
+		// (lhs * rhs)(i, i + a + b) += lhs(i, i + a) * rhs(i + a, i + a + b)
+		for (int a = -static_cast<int>(lhs.lowerBandwidth()); a <= static_cast<int>(lhs.upperBandwidth()); ++a)
+		{
+			const stdType* lhsDiagonal = lhs.Diagonal(a);
+			for (int b = -static_cast<int>(rhs.lowerBandwidth()); b <= static_cast<int>(rhs.upperBandwidth()); ++b)
+			{
+				const int k = a + b;
+				if (k < -static_cast<int>(lowerBandwidth) || k > static_cast<int>(upperBandwidth))
+					continue;
+
+				const stdType* rhsDiagonal = rhs.Diagonal(b);
+				stdType* retDiagonal = ret.Diagonal(k);
+				if (periodic)
+				{
+					for (int i = 0; i < n; ++i)
+						retDiagonal[i] += alpha * lhsDiagonal[i] * rhsDiagonal[((i + a) % n + n) % n];
+					continue;
+				}
+
+				const int begin = std::max(std::max(0, -a), -k);
+				const int end = std::min(std::min(n, n - a), n - k);
+				for (int i = begin; i < end; ++i)
+					retDiagonal[i] += alpha * lhsDiagonal[i] * rhsDiagonal[i + a];
+			}
+		}
+
+		return ret;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <ExtendedSolverType.h>
+
+namespace pde
+{
+	/**
+	*	Error control of the adaptive schemes: a step is accepted if the difference between the two embedded solutions is within
+	*	absoluteTolerance + relativeTolerance * |u|, in the root mean square over the grid points
+	*/
+	struct AdaptiveStepSettings
+	{
+		double absoluteTolerance = 1e-8;
+		double relativeTolerance = 1e-6;
+	};
+
+	/**
+	*	Explicit Runge-Kutta pair with an embedded lower order solution, for du/dt = L * u: the step size follows the local error estimate,
+	*	so that smooth phases take large steps and the steps only shrink where the solution (or the stability of the scheme) requires it.
+	*	Both Bogacki-Shampine 3(2) and Dormand-Prince 5(4) have the first same as last property: the last stage of a step is the first one of the next,
+	*	as the boundary conditions are set on the argument of every stage. The step size is carried over to the next call.
+	*	matrixType is BandedMatrix for 1D operators and SparseDiagonalMatrix for 2D ones.
+	*/
+	template<typename stdType, template<typename> class matrixType>
+	class EmbeddedRungeKutta
+	{
+	public:
+		/**
+		* solverType is either BogackiShampine32 or DormandPrince54, and dt is the first step tried: Advance(n) of the solvers covers n * dt
+		*/
+		EmbeddedRungeKutta(const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const AdaptiveStepSettings& settings, const double dt);
+
+		virtual ~EmbeddedRungeKutta() noexcept = default;
+		EmbeddedRungeKutta(const EmbeddedRungeKutta& rhs) = default;
+		EmbeddedRungeKutta(EmbeddedRungeKutta&& rhs) noexcept = default;
+		EmbeddedRungeKutta& operator=(const EmbeddedRungeKutta& rhs) = default;
+		EmbeddedRungeKutta& operator=(EmbeddedRungeKutta&& rhs) noexcept = default;
+
+		double nominalStep() const noexcept { return dt; }
+
+		/**
+		* Steps accepted and rejected by the last Advance: each step costs one product with L per stage but the last
+		*/
+		unsigned lastAcceptedSteps() const noexcept { return _lastAcceptedSteps; }
+		unsigned lastRejectedSteps() const noexcept { return _lastRejectedSteps; }
+
+		/**
+		* Advances u by duration, landing on it exactly. L acts on u + offset, where u has offset ghost points on each end,
+		* and setBoundaryConditions(stdType*) is called on u after each step
+		*/
+		template<class boundaryConditionSetter>
+		void Advance(stdType* u, const size_t offset, const double duration, const boundaryConditionSetter& setBoundaryConditions) const;
+
+	private:
+		matrixType<stdType> spaceDiscretizer;
+		AdaptiveStepSettings settings;
+		double dt;
+
+		/**
+		* Butcher tableau: a is lower triangular and row-major, b gives the higher order solution, and error = b - b* the difference with the embedded one
+		*/
+		unsigned nStages = 0;
+		std::vector<double> a;
+		std::vector<double> b;
+		std::vector<double> error;
+
+		/**
+		* Order of the embedded solution, which drives the step size control
+		*/
+		unsigned embeddedOrder = 0;
+
+		mutable double step;
+		mutable unsigned _lastAcceptedSteps = 0;
+		mutable unsigned _lastRejectedSteps = 0;
+
+		/**
+		* Workspace: one vector per stage, and the candidate solution with its ghost points
+		*/
+		mutable std::vector<std::vector<stdType>> stages;
+		mutable std::vector<stdType> candidate;
+	};
+}
+
+#include <EmbeddedRungeKutta.tpp>
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <EmbeddedRungeKutta.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace pde
+{
+	template<typename stdType, template<typename> class matrixType>
+	EmbeddedRungeKutta<stdType, matrixType>::EmbeddedRungeKutta(const matrixType<stdType>& spaceDiscretizer, const ExtendedSolverType solverType, const AdaptiveStepSettings& settings, const double dt)
+		: spaceDiscretizer(spaceDiscretizer), settings(settings), dt(dt), step(dt)
+	{
+		switch (solverType)
+		{
+			case ExtendedSolverType::BogackiShampine32:
+				nStages = 4;
+				embeddedOrder = 2;
+				a = { 0.0, 0.0, 0.0, 0.0,
+					  1.0 / 2.0, 0.0, 0.0, 0.0,
+					  0.0, 3.0 / 4.0, 0.0, 0.0,
+					  2.0 / 9.0, 1.0 / 3.0, 4.0 / 9.0, 0.0 };
+				b = { 2.0 / 9.0, 1.0 / 3.0, 4.0 / 9.0, 0.0 };
+				error = { -5.0 / 72.0, 1.0 / 12.0, 1.0 / 9.0, -1.0 / 8.0 };
+				break;
+			case ExtendedSolverType::DormandPrince54:
+				nStages = 7;
+				embeddedOrder = 4;
+				a = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+					  1.0 / 5.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+					  3.0 / 40.0, 9.0 / 40.0, 0.0, 0.0, 0.0, 0.0, 0.0,
+					  44.0 / 45.0, -56.0 / 15.0, 32.0 / 9.0, 0.0, 0.0, 0.0, 0.0,
+					  19372.0 / 6561.0, -25360.0 / 2187.0, 64448.0 / 6561.0, -212.0 / 729.0, 0.0, 0.0, 0.0,
+					  9017.0 / 3168.0, -355.0 / 33.0, 46732.0 / 5247.0, 49.0 / 176.0, -5103.0 / 18656.0, 0.0, 0.0,
+					  35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0, 0.0 };
+				b = { 35.0 / 384.0, 0.0, 500.0 / 1113.0, 125.0 / 192.0, -2187.0 / 6784.0, 11.0 / 84.0, 0.0 };
+				error = { 71.0 / 57600.0, 0.0, -71.0 / 16695.0, 71.0 / 1920.0, -17253.0 / 339200.0, 22.0 / 525.0, -1.0 / 40.0 };
+				break;
+			default:
+				assert(false);
+				break;
+		}
+
+		stages.resize(nStages, std::vector<stdType>(spaceDiscretizer.nRows()));
+	}
+
+	template<typename stdType, template<typename> class matrixType>
+	template<class boundaryConditionSetter>
+	void EmbeddedRungeKutta<stdType, matrixType>::Advance(stdType* u, const size_t offset, const double duration, const boundaryConditionSetter& setBoundaryConditions) const
+	{
+		const size_t n = spaceDiscretizer.nRows();
+		candidate.resize(n + 2 * offset);
+		_lastAcceptedSteps = 0;
+		_lastRejectedSteps = 0;
+
+		// u may have changed since the last call, so that the first stage can't be carried over
+		spaceDiscretizer.Dot(stages[0].data(), u + offset);
+
+		const double exponent = -1.0 / (embeddedOrder + 1.0);
+		double t = 0.0;
+		while (t < duration)
+		{
+			assert(step > std::numeric_limits<double>::epsilon() * duration);
+
+			// stretch the last step rather than leaving a tiny one
+			const bool isLastStep = step >= (duration - t) * (1.0 - 1e-12);
+			const double h = isLastStep ? duration - t : step;
+
+			for (unsigned i = 1; i < nStages; ++i)
+			{
+				std::copy(u, u + candidate.size(), candidate.begin());
+				for (unsigned j = 0; j < i; ++j)
+				{
+					const stdType weight = static_cast<stdType>(h * a[j + i * nStages]);
+					if (weight == stdType(0.0))
+						continue;
+
+					const stdType* k = stages[j].data();
+					for (size_t l = 0; l < n; ++l)
+						candidate[offset + l] += weight * k[l];
+				}
+
+				// the boundary points follow the interior ones at every stage, as they would in continuous time:
+				// the last stage is then evaluated at the new solution
+				setBoundaryConditions(candidate.data());
+				spaceDiscretizer.Dot(stages[i].data(), candidate.data() + offset);
+			}
+
+			// root mean square of h * sum_j (b_j - b*_j) * k_j, relative to the tolerance of each point
+			double errorNorm = 0.0;
+			for (size_t l = 0; l < n; ++l)
+			{
+				double localError = 0.0;
+				for (unsigned j = 0; j < nStages; ++j)
+					localError += error[j] * stages[j][l];
+				localError *= h;
+
+				const double scale = settings.absoluteTolerance + settings.relativeTolerance * std::max(std::abs(static_cast<double>(u[offset + l])), std::abs(static_cast<double>(candidate[offset + l])));
+				errorNorm += (localError / scale) * (localError / scale);
+			}
+			errorNorm = std::sqrt(errorNorm / n);
+
+			if (errorNorm > 1.0)
+			{
+				++_lastRejectedSteps;
+				step = h * std::max(.2, .9 * std::pow(errorNorm, exponent));
+				continue;
+			}
+
+			std::copy(candidate.begin(), candidate.end(), u);
+			std::swap(stages[0], stages[nStages - 1]);
+			t = isLastStep ? duration : t + h;
+			++_lastAcceptedSteps;
+
+			// as in KrylovExponential, the last step may have been clipped and then it can't shrink the step size
+			const double growth = errorNorm > 0.0 ? std::min(5.0, std::max(.2, .9 * std::pow(errorNorm, exponent))) : 5.0;
+			step = isLastStep ? std::max(step, h * growth) : h * growth;
+		}
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <Exception.h>
+
+namespace pde
+{
+	/**
+	*	Schemes implemented in this library on top of the kernels SolverType.
+	*	When not Null and supported by the solver, it takes precedence over PdeInputData::solverType, which is otherwise used as a fallback.
+	*	A supported scheme that can't be built for the given boundary conditions or coefficients throws UnsupportedSolverTypeException rather than falling back.
+	*/
+	enum class ExtendedSolverType
+	{
+		Null,
+
+		__BEGIN__,
+
+		/**
+		* Alternating direction implicit (2D only): an implicit half step in x and an explicit one in y, then the other way round
+		*/
+		PeacemanRachford = __BEGIN__,
+
+		/**
+		* Alternating direction implicit (2D only): a Crank-Nicolson predictor implicit in x, corrected implicitly in y
+		*/
+		Douglas,
+
+		/**
+		* exp(dt * L) * u_n by Arnoldi iterations on the sparse (or banded) space discretizer: exact up to the Krylov tolerance, and unconditionally stable
+		*/
+		KrylovExponential,
+
+		/**
+		* Adaptive steps, controlled by the embedded second order solution of a third order Runge-Kutta (Bogacki-Shampine 3(2))
+		*/
+		BogackiShampine32,
+
+		/**
+		* Adaptive steps, controlled by the embedded fourth order solution of a fifth order Runge-Kutta (Dormand-Prince 5(4))
+		*/
+		DormandPrince54,
+
+		/**
+		* Implicit-explicit splitting L = D + A: implicit Euler on the diffusion part D, explicit Euler on the advection part A
+		*/
+		ImexEuler,
+
+		/**
+		* Implicit-explicit splitting: Crank-Nicolson on the diffusion part, second order Adams-Bashforth on the advection part
+		*/
+		ImexCrankNicolsonAdamsBashforth2,
+
+		/**
+		* Implicit-explicit splitting: second order additive Runge-Kutta ARS(2, 2, 2), L-stable on the diffusion part
+		*/
+		ImexAdditiveRungeKutta2,
+
+		/**
+		* Strang splitting (2D only): a half step along x, a full step along y and another half step along x, each one made of independent 1D problems advanced with solverType
+		*/
+		StrangSplitting,
+
+		/**
+		* Wave equation only: drift-kick-drift leapfrog (Stormer-Verlet), symplectic and second order, with a single application of the space discretizer per step.
+		* It doesn't damp the solution as implicit Euler does, and it's stable as long as dt^2 times the spectral radius of the space discretizer is at most 4
+		*/
+		StormerVerlet,
+
+		/**
+		* Third and fourth order Adams-Bashforth: one application of the space discretizer per step, whatever the order
+		*/
+		AdamsBashforth3,
+		AdamsBashforth4,
+
+		/**
+		* Second to fourth order backward differentiation formulas: one implicit solve per step, and stiffly stable
+		*/
+		BackwardDifferentiation2,
+		BackwardDifferentiation3,
+		BackwardDifferentiation4,
+
+		__END__
+	};
+
+	class UnsupportedSolverTypeException : public Exception
+	{
+	public:
+		UnsupportedSolverTypeException(const std::string& message = "")
+			: Exception("UnsupportedSolverTypeException: " + message)
+		{
+		}
+	};
+}
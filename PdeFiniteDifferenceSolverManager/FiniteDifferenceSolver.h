@@ -1,11 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include <Vector.h>
 #include <IBuffer.h>
 #include <Types.h>
 
 #include <FiniteDifferenceManager.h>
+#include <PropagatorPowerCache.h>
+#include <MemoryPlanner.h>
+#include <ExtendedSolverType.h>
+#include <SpectralPropagator.h>
 #include <CudaException.h>
 
 #define MAKE_DEFAULT_CONSTRUCTORS(CLASS)\
@@ -18,6 +23,34 @@
 
 namespace pde
 {
+	class DimensionMismatchException : public Exception
+	{
+	public:
+		DimensionMismatchException(const std::string& message = "")
+			: Exception("DimensionMismatchException: " + message)
+		{
+		}
+	};
+
+	namespace detail
+	{
+		/**
+		* FNV-1a hash of the bytes of values: equal values give equal fingerprints, and any write changes it but for a negligible chance
+		*/
+		template<typename stdType>
+		size_t Fingerprint(const std::vector<stdType>& values) noexcept
+		{
+			const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values.data());
+			unsigned long long hash = 14695981039346656037ull;
+			for (size_t i = 0; i < values.size() * sizeof(stdType); ++i)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+			return static_cast<size_t>(hash);
+		}
+	}
+
 	/**
 	*	CRTP implementation
 	*	Instead of using type traits, I decided to pass another template parameter - pdeInputType - for a less verbose code
@@ -32,14 +65,97 @@ namespace pde
 
 		void Advance(const unsigned nSteps = 1);
 
+		/**
+		* Advances the solution up to time t: adaptive schemes land on it exactly, fixed step schemes take the closest whole number of steps
+		*/
+		void AdvanceTo(const double t);
+
+		/**
+		* Ensemble mode: advances each column of solutions, an independent initial condition on the same grid, by nSteps with the operators of this solver, leaving solution untouched.
+		* The dense propagator advances all of them with one matrix-matrix product per step; the compact ones read them to the host at once, and step them there member by member.
+		* Throws UnsupportedSolverTypeException for multi-step solver types, and for host schemes with state of their own, as the members share the time discretizers
+		*/
+		void AdvanceEnsemble(cl::ColumnWiseMatrix<memorySpace, mathDomain>& solutions, const unsigned nSteps = 1);
+
+		/**
+		* Exact solution at each of times, measured from the current solution, into the columns of snapshots, without any time stepping.
+		* The dense operator is built and diagonalized on the first call only, after which only the eigenvectors are kept.
+		* Returns false if it isn't diagonalizable, in which case snapshots is left untouched. First order in time equations only
+		*/
+		bool EvaluateSpectral(cl::ColumnWiseMatrix<memorySpace, mathDomain>& snapshots, const std::vector<double>& times);
+
+		/**
+		* Time covered since the initial condition
+		*/
+		double GetTime() const noexcept { return currentTime; }
+
 		const cl::Tensor<memorySpace, mathDomain>* const GetTimeDiscretizer() const noexcept;
 
+		/**
+		* Whether Advance(n) goes through the cached propagator power for the last n, see PropagatorPowerPolicy
+		*/
+		bool HasPropagatorPower() const noexcept { return propagatorPowerCache.HasPower(); }
+
+		/**
+		* Column 0 is the most recent step: it can be written into between two calls to Advance, which restarts the history of the multi-step host schemes.
+		* Advance may replace it with another matrix (the dense wave equation propagators swap it with their buffer), so that it's read from the solver after each call rather than kept aside
+		*/
 		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> solution;
 		const pdeInputType& inputData;
 	protected:
 		std::shared_ptr<cl::Tensor<memorySpace, mathDomain>> timeDiscretizers;
 		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> spaceDiscretizer;
 		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> solutionDerivative;
+
+		/**
+		* Dense one-step schemes only
+		*/
+		PropagatorPowerCache<memorySpace, mathDomain> propagatorPowerCache;
+
+		std::shared_ptr<SpectralPropagator<typename cl::Traits<mathDomain>::stdType>> spectralPropagator;
+
+		double currentTime = 0.0;
+
+		/**
+		* Host propagators only: the matrix the last host step wrote, and a fingerprint of what it wrote. The step history of the multi-step schemes
+		* only holds for that matrix with those values: a fingerprint is kept rather than a copy, so that any other write restarts the history
+		*/
+		const void* lastHostStepMatrix = nullptr;
+		size_t lastHostStepFingerprint = 0;
+
+		/**
+		* Whether hostMatrix, just read from matrix, is where the last host step left it
+		*/
+		bool IsLastHostStep(const cl::ColumnWiseMatrix<memorySpace, mathDomain>& matrix, const std::vector<typename cl::Traits<mathDomain>::stdType>& hostMatrix) const noexcept;
+		void SetLastHostStep(const cl::ColumnWiseMatrix<memorySpace, mathDomain>& matrix, const std::vector<typename cl::Traits<mathDomain>::stdType>& hostMatrix) noexcept;
+
+		/**
+		* Power iterations on the linear part S(v) - S(0) of a single step S, applied to the whole solution history: the solver state is left untouched.
+		* NaN for the schemes whose state isn't the solution history alone, as the iterations can't go through their steps
+		*/
+		double EstimateSpectralRadius(const unsigned nIterations = 200);
+		double EstimateSpectralRadiusImpl(const unsigned nIterations);
+
+		/**
+		* Called before allocating the dense operators of a nRows x nCols grid: drops the propagator power cache if that's enough to fit in inputData.settings.memoryBudget, and throws otherwise
+		*/
+		void CheckMemoryBudget(const unsigned nRows, const unsigned nCols);
+
+		/**
+		* Called before a temporary allocation of nBytes on top of the buffers the solver holds, and before the propagator power is built (nBytes = 0): same policy as above
+		*/
+		void CheckMemoryBudget(const size_t nBytes);
+
+		/**
+		* Drops the propagator power cache if required + optional bytes don't fit in budget but required do, and throws if not even those do. No limit if budget is 0
+		*/
+		void EnforceMemoryBudget(const size_t required, const size_t optional, const size_t budget, const std::string& what);
+
+		/**
+		* The dense operator L: spaceDiscretizer if the dense time discretizers are there, and otherwise a temporary built with the implementation's MakeSpaceDiscretizer,
+		* after checking that it fits in the budget along with extraBytes the caller is about to allocate
+		*/
+		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> MakeDenseSpaceDiscretizer(const size_t extraBytes = 0);
 	};
 }
 
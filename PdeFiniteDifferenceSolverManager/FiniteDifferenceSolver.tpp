@@ -1,21 +1,271 @@
 #pragma once
 
 #include <FiniteDifferenceSolver.h>
+#include <cassert>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <string>
+#include <utility>
 
 namespace pde
 {
 	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
 	FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::FiniteDifferenceSolver(const pdeInputType& inputData)
-		: inputData(inputData)
+		: inputData(inputData), propagatorPowerCache(inputData.settings.propagatorPowerPolicy)
 	{
 		static_cast<pdeImpl*>(this)->Setup(getNumberOfSteps(inputData.solverType));
-		static_cast<pdeImpl*>(this)->MakeTimeDiscretizer(this->timeDiscretizers, inputData.solverType);
+
+		// Setup doesn't allocate the dense time discretizers when the implementation has opted for a compact representation
+		if (timeDiscretizers)
+			static_cast<pdeImpl*>(this)->MakeTimeDiscretizer(this->timeDiscretizers, inputData.solverType);
 	}
 
 	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
 	void FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::Advance(const unsigned nSteps)
 	{
 		static_cast<pdeImpl*>(this)->AdvanceImpl(*solution, timeDiscretizers, inputData.solverType, nSteps);
+		currentTime += nSteps * inputData.dt;
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::AdvanceTo(const double t)
+	{
+		const double duration = t - currentTime;
+		if (duration <= 0.0)
+			return;
+
+		if (!timeDiscretizers && static_cast<pdeImpl*>(this)->AdvanceAdaptive(*solution, duration))
+		{
+			currentTime = t;
+			return;
+		}
+
+		const unsigned nSteps = static_cast<unsigned>(std::lround(duration / inputData.dt));
+		if (nSteps > 0)
+			Advance(nSteps);
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::AdvanceEnsemble(cl::ColumnWiseMatrix<ms, md>& solutions, const unsigned nSteps)
+	{
+		static_assert(!pdeImpl::hasSolutionDerivative, "the members would need a solution derivative each");
+		if (solutions.nRows() != solution->nRows())
+			throw DimensionMismatchException("solutions has " + std::to_string(solutions.nRows()) + " rows, expected " + std::to_string(solution->nRows()));
+		if (getNumberOfSteps(inputData.solverType) > 1)
+			throw UnsupportedSolverTypeException("solver type " + std::to_string(static_cast<int>(inputData.solverType)) + " is multi-step: the members would need a history each");
+		if (!static_cast<pdeImpl*>(this)->HasStatelessSteps())
+			throw UnsupportedSolverTypeException("the ensemble members would share the multi-step history or the previous advection term of the host steps");
+
+		if (!timeDiscretizers)
+		{
+			static_cast<pdeImpl*>(this)->AdvanceEnsembleImpl(solutions, nSteps);
+			return;
+		}
+
+		// A then the boundary conditions, for all the members at once: A is read once per step rather than once per member
+		cl::ColumnWiseMatrix<ms, md> buffer(solutions.nRows(), solutions.nCols(), 0.0);
+		cl::ColumnWiseMatrix<ms, md>* current = &solutions;
+		cl::ColumnWiseMatrix<ms, md>* next = &buffer;
+		for (unsigned n = 0; n < nSteps; ++n)
+		{
+			cl::Multiply(*next, *timeDiscretizers->matrices[0], *current);
+			for (auto& column : next->columns)
+				static_cast<pdeImpl*>(this)->SetBoundaryConditions(*column);
+			std::swap(current, next);
+		}
+
+		if (current != &solutions)
+			solutions.ReadFrom(*current);
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::EvaluateSpectral(cl::ColumnWiseMatrix<ms, md>& snapshots, const std::vector<double>& times)
+	{
+		static_assert(!pdeImpl::hasSolutionDerivative, "the exact evolution of second order equations isn't e^{L * t}");
+		typedef typename cl::Traits<md>::stdType stdType;
+
+		const unsigned dimension = solution->nRows();
+		if (snapshots.nRows() != dimension || snapshots.nCols() != times.size())
+			throw DimensionMismatchException("snapshots is " + std::to_string(snapshots.nRows()) + " x " + std::to_string(snapshots.nCols()) + ", expected " + std::to_string(dimension) + " x " + std::to_string(times.size()));
+
+		if (!spectralPropagator)
+		{
+			// the host copies of L and B, the boundary propagator, and the complex Schur form with its eigenvectors, which the propagator only keeps the last of
+			const size_t operatorSize = static_cast<size_t>(dimension) * dimension;
+			const size_t diagonalizationBytes = 4 * operatorSize * GetElementSize(md) + 6 * operatorSize * sizeof(std::complex<double>);
+
+			std::vector<stdType> _spaceDiscretizer, _boundaryPropagator, _boundaryOffset;
+			{
+				_spaceDiscretizer = MakeDenseSpaceDiscretizer(diagonalizationBytes)->Get();
+
+				// B(I) - B(0) and B(0), read off the same kernel that sets the boundary conditions after each time step
+				std::vector<stdType> identity(operatorSize, stdType(0.0));
+				for (unsigned i = 0; i < dimension; ++i)
+					identity[i + i * dimension] = stdType(1.0);
+				cl::ColumnWiseMatrix<ms, md> boundaryPropagator(identity, dimension, dimension);
+				cl::ColumnWiseMatrix<ms, md> boundaryOffset(dimension, 1, 0.0);
+				for (auto& column : boundaryPropagator.columns)
+					static_cast<pdeImpl*>(this)->SetBoundaryConditions(*column);
+				static_cast<pdeImpl*>(this)->SetBoundaryConditions(*boundaryOffset.columns[0]);
+
+				_boundaryPropagator = boundaryPropagator.Get();
+				_boundaryOffset = boundaryOffset.Get();
+			}
+			for (unsigned j = 0; j < dimension; ++j)
+				for (unsigned i = 0; i < dimension; ++i)
+					_boundaryPropagator[i + j * dimension] -= _boundaryOffset[i];
+
+			spectralPropagator = std::make_shared<SpectralPropagator<stdType>>(_spaceDiscretizer, _boundaryPropagator, _boundaryOffset);
+		}
+
+		if (!spectralPropagator->IsValid())
+			return false;
+
+		const auto currentSolution = solution->columns[0]->Get();
+		std::vector<stdType> snapshot(dimension);
+		for (size_t k = 0; k < times.size(); ++k)
+		{
+			spectralPropagator->Evaluate(snapshot.data(), currentSolution.data(), times[k]);
+			snapshots.columns[k]->ReadFrom(snapshot);
+		}
+
+		return true;
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	double FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::EstimateSpectralRadius(const unsigned nIterations)
+	{
+		static_assert(!pdeImpl::hasSolutionDerivative, "the steps would advance solutionDerivative along with the iterates");
+		typedef typename cl::Traits<md>::stdType stdType;
+		if (!static_cast<pdeImpl*>(this)->HasStatelessSteps())
+			return std::numeric_limits<double>::quiet_NaN();
+
+		// the adaptive step size, the exponential sub-steps and the propagator power are put back once the iterations are over, for the trajectory not to depend on them
+		const auto stepState = static_cast<pdeImpl*>(this)->SaveStepState();
+		const auto _propagatorPowerCache = propagatorPowerCache;
+		const double spectralRadius = EstimateSpectralRadiusImpl(nIterations);
+		static_cast<pdeImpl*>(this)->RestoreStepState(stepState);
+		propagatorPowerCache = _propagatorPowerCache;
+
+		return spectralRadius;
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	double FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::EstimateSpectralRadiusImpl(const unsigned nIterations)
+	{
+		typedef typename cl::Traits<md>::stdType stdType;
+		const unsigned nRows = solution->nRows();
+		const unsigned nCols = solution->nCols();
+
+		// the step is affine because of the boundary conditions
+		cl::ColumnWiseMatrix<ms, md> offset(nRows, nCols, 0.0);
+		static_cast<pdeImpl*>(this)->AdvanceImpl(offset, timeDiscretizers, inputData.solverType, 1);
+		const auto _offset = offset.Get();
+
+		// a rough starting vector has components along all the eigenvectors
+		std::vector<stdType> _iterate(nRows * nCols);
+		double norm = 0.0;
+		for (size_t i = 0; i < _iterate.size(); ++i)
+		{
+			_iterate[i] = static_cast<stdType>(std::sin(12.9898 * (i + 1)));
+			norm += static_cast<double>(_iterate[i]) * _iterate[i];
+		}
+		for (auto& x : _iterate)
+			x = static_cast<stdType>(x / std::sqrt(norm));
+		cl::ColumnWiseMatrix<ms, md> iterate(_iterate, nRows, nCols);
+
+		// geometric mean of the growth over the second half of the iterations, which averages out the oscillations of complex dominant eigenvalues
+		double logGrowth = 0.0;
+		unsigned nGrowths = 0;
+		for (unsigned k = 0; k < nIterations; ++k)
+		{
+			static_cast<pdeImpl*>(this)->AdvanceImpl(iterate, timeDiscretizers, inputData.solverType, 1);
+			_iterate = iterate.Get();
+
+			norm = 0.0;
+			for (size_t i = 0; i < _iterate.size(); ++i)
+			{
+				_iterate[i] -= _offset[i];
+				norm += static_cast<double>(_iterate[i]) * _iterate[i];
+			}
+			norm = std::sqrt(norm);
+			if (norm == 0.0)
+				return 0.0;
+
+			if (2 * k >= nIterations)
+			{
+				logGrowth += std::log(norm);
+				++nGrowths;
+			}
+
+			for (auto& x : _iterate)
+				x = static_cast<stdType>(x / norm);
+			iterate.ReadFrom(_iterate);
+		}
+
+		return std::exp(logGrowth / nGrowths);
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::CheckMemoryBudget(const unsigned nRows, const unsigned nCols)
+	{
+		const MemoryPlan plan = PlanMemory(nRows, nCols, inputData.solverType, md, pdeImpl::hasSolutionDerivative, true);
+		EnforceMemoryBudget(plan.Total() - plan.propagatorPower, plan.propagatorPower, inputData.settings.memoryBudget, "the dense operators");
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::CheckMemoryBudget(const size_t nBytes)
+	{
+		const MemoryPlan plan = PlanMemory(solution->nRows(), 1, inputData.solverType, md, pdeImpl::hasSolutionDerivative, timeDiscretizers != nullptr);
+		EnforceMemoryBudget(plan.Total() - plan.propagatorPower + nBytes, plan.propagatorPower, inputData.settings.memoryBudget, "a temporary of " + std::to_string(nBytes) + " bytes on top of the buffers of the solver");
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::EnforceMemoryBudget(const size_t required, const size_t optional, const size_t budget, const std::string& what)
+	{
+		if (budget == 0 || required + optional <= budget)
+			return;
+
+		// the cached power is only a shortcut for Advance(n), so it's the first thing to go
+		if (required <= budget)
+		{
+			propagatorPowerCache = PropagatorPowerCache<ms, md>(PropagatorPowerPolicy::Null);
+			return;
+		}
+
+		throw MemoryBudgetExceededException(what + ": " + std::to_string(required) + " bytes needed, the budget is " + std::to_string(budget));
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	std::shared_ptr<cl::ColumnWiseMatrix<ms, md>> FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::MakeDenseSpaceDiscretizer(const size_t extraBytes)
+	{
+		if (spaceDiscretizer)
+		{
+			CheckMemoryBudget(extraBytes);
+			return spaceDiscretizer;
+		}
+
+		const size_t dimension = solution->nRows();
+		CheckMemoryBudget(dimension * dimension * GetElementSize(md) + extraBytes);
+
+		auto denseSpaceDiscretizer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(solution->nRows(), solution->nRows(), 0.0);
+		static_cast<pdeImpl*>(this)->MakeSpaceDiscretizer(*denseSpaceDiscretizer, inputData.solverType);
+
+		return denseSpaceDiscretizer;
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::IsLastHostStep(const cl::ColumnWiseMatrix<ms, md>& matrix, const std::vector<typename cl::Traits<md>::stdType>& hostMatrix) const noexcept
+	{
+		return &matrix == lastHostStepMatrix && detail::Fingerprint(hostMatrix) == lastHostStepFingerprint;
+	}
+
+	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver<pdeImpl, pdeInputType, ms, md>::SetLastHostStep(const cl::ColumnWiseMatrix<ms, md>& matrix, const std::vector<typename cl::Traits<md>::stdType>& hostMatrix) noexcept
+	{
+		lastHostStepMatrix = &matrix;
+		lastHostStepFingerprint = detail::Fingerprint(hostMatrix);
 	}
 
 	template<class pdeImpl, class pdeInputType, MemorySpace ms, MathDomain md>
@@ -7,6 +7,7 @@
 
 #include <PdeInputData1D.h>
 #include <FiniteDifferenceManager.h>
+#include <BandedFiniteDifferenceManager.h>
 #include <FiniteDifferenceSolver.h>
 #include <CudaException.h>
 
@@ -19,16 +20,35 @@
 
 namespace pde
 {
+	namespace detail
+	{
+		/**
+		* Banded 1D operators: this is a base class rather than a member, as it has to be constructed before FiniteDifferenceSolver calls Setup
+		*/
+		template<typename stdType>
+		struct BandedDiscretizers1D
+		{
+			HostFiniteDifferenceInput1D<stdType> hostInput;
+
+			std::shared_ptr<BandedMatrix<stdType>> bandedSpaceDiscretizer;
+			BandedTimeDiscretizer<stdType> bandedTimeDiscretizers;
+		};
+	}
+
 	/**
 	* CRTP implementation
+	* When the solver type admits it, the operators are kept in banded form and the dense timeDiscretizers tensor is never allocated
 	*/
 	template<class solverImpl, MemorySpace memorySpace = MemorySpace::Device, MathDomain mathDomain = MathDomain::Float>
-	class FiniteDifferenceSolver1D : public FiniteDifferenceSolver<solverImpl, PdeInputData1D<memorySpace, mathDomain>, memorySpace, mathDomain>
+	class FiniteDifferenceSolver1D : protected detail::BandedDiscretizers1D<typename cl::Traits<mathDomain>::stdType>,
+									 public FiniteDifferenceSolver<solverImpl, PdeInputData1D<memorySpace, mathDomain>, memorySpace, mathDomain>
 	{
 	public:
 		friend class FiniteDifferenceSolver<solverImpl, PdeInputData1D<memorySpace, mathDomain>, memorySpace, mathDomain>;
 		using FiniteDifferenceSolver::FiniteDifferenceSolver;
 
+		typedef typename cl::Traits<mathDomain>::stdType stdType;
+
 		MAKE_DEFAULT_CONSTRUCTORS(FiniteDifferenceSolver1D);
 
 	protected:
@@ -37,7 +57,45 @@ namespace pde
 						 const SolverType solverType,
 						 const unsigned nSteps = 1);
 
+		/**
+		* Banded propagators only: advances each column of solutions by nSteps, with one host transfer each way for all of them
+		*/
+		void AdvanceEnsembleImpl(cl::ColumnWiseMatrix<memorySpace, mathDomain>& solutions, const unsigned nSteps);
+
+		/**
+		* Adaptive schemes only: returns false if the solution can't be advanced by an arbitrary duration
+		*/
+		bool AdvanceAdaptive(cl::ColumnWiseMatrix<memorySpace, mathDomain>& solution, const double duration);
+
+		/**
+		* Applies the boundary conditions to a single grid function, with the same kernel as the dense steps
+		*/
+		void SetBoundaryConditions(cl::Vector<memorySpace, mathDomain>& column) const;
+
+		/**
+		* The host schemes that carry a history or the previous advection term of their only solution can't step anything else,
+		* as the ensemble members and the power iterations of EstimateSpectralRadius are
+		*/
+		bool HasStatelessSteps() const noexcept;
+
+		/**
+		* Whatever else carries from one host step to the next, for EstimateSpectralRadius to put it back after stepping its own vectors
+		*/
+		BandedTimeDiscretizer<stdType> SaveStepState() const;
+		void RestoreStepState(const BandedTimeDiscretizer<stdType>& state);
+
 		void Setup(const unsigned solverSteps);
+
+		/**
+		* Two-step schemes only: advances the initial condition in the last column into the first one, without touching the operators of the solver.
+		* The dense starter is built into the storage of the solver propagators, before the constructor builds those
+		*/
+		void Bootstrap(const unsigned solverSteps);
+
+		/**
+		* Periodic operators wrap around the interior points, which needs both ends to be periodic
+		*/
+		bool HasOneSidedPeriodicBoundaryConditions() const noexcept;
 	};
 }
 
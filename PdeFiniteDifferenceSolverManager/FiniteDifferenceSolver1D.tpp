@@ -1,6 +1,8 @@
 #pragma once
 
 #include <FiniteDifferenceSolver1D.h>
+#include <algorithm>
+#include <cassert>
 
 namespace pde
 {
@@ -10,6 +12,21 @@ namespace pde
 											   const SolverType solverType,
 											   const unsigned nSteps)
 	{
+		if (!timeDiscretizers)
+		{
+			// banded propagators: the whole history is stepped on the host, and only copied back at the end
+			// the multi-step history only holds if solution is where their last step left it, which a write in between would change
+			std::vector<stdType> _solution = solution.Get();
+			if (!HasStatelessSteps() && !this->IsLastHostStep(solution, _solution))
+				pde::detail::ResetStepHistory(this->bandedTimeDiscretizers);
+
+			pde::detail::Iterate1D(_solution, this->bandedTimeDiscretizers, this->hostInput, nSteps);
+			solution.ReadFrom(_solution);
+			if (!HasStatelessSteps())
+				this->SetLastHostStep(solution, _solution);
+			return;
+		}
+
 		FiniteDifferenceInput1D _input(inputData.dt,
 									   inputData.spaceGrid.GetBuffer(),
 									   inputData.velocity.GetBuffer(),
@@ -17,40 +34,163 @@ namespace pde
 									   solverType,
 									   inputData.spaceDiscretizerType,
 									   inputData.boundaryConditions);
+
+		// the step applies A, then the boundary conditions, set by the same kernel as Iterate1D
+		auto setBoundaryConditions = [&_input](cl::Vector<ms, md>& column)
+		{
+			pde::detail::SetBoundaryConditions1D(column.GetBuffer(), _input);
+		};
+
+		// the power is the one dense allocation after Setup, which is checked against the budget before it's built
+		if (this->propagatorPowerCache.IsEnabled() && !this->propagatorPowerCache.HasPower(nSteps))
+			this->CheckMemoryBudget(static_cast<size_t>(0));
+		if (this->propagatorPowerCache.Advance(solution, *timeDiscretizers->matrices[0], nSteps, setBoundaryConditions))
+			return;
+
 		pde::detail::Iterate1D(solution.GetTile(), timeDiscretizers->GetCube(), _input, nSteps);
 	}
 
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver1D<solverImpl, ms, md>::AdvanceEnsembleImpl(cl::ColumnWiseMatrix<ms, md>& solutions, const unsigned nSteps)
+	{
+		// the members are stepped on the host one after the other, sharing the operators and the step scratch
+		std::vector<stdType> _solutions = solutions.Get();
+		const size_t nRows = solutions.nRows();
+		std::vector<stdType> member(nRows);
+		std::vector<stdType> stepBuffer;
+		for (size_t k = 0; k < solutions.nCols(); ++k)
+		{
+			const auto memberBegin = _solutions.begin() + k * nRows;
+			std::copy(memberBegin, memberBegin + nRows, member.begin());
+			pde::detail::Iterate1D(member, this->bandedTimeDiscretizers, this->hostInput, nSteps, stepBuffer);
+			std::copy(member.begin(), member.end(), memberBegin);
+		}
+		solutions.ReadFrom(_solutions);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver1D<solverImpl, ms, md>::AdvanceAdaptive(cl::ColumnWiseMatrix<ms, md>& solution, const double duration)
+	{
+		if (!this->bandedTimeDiscretizers.embeddedRungeKutta)
+			return false;
+
+		std::vector<stdType> _solution = solution.Get();
+		pde::detail::AdvanceAdaptive1D(_solution, this->bandedTimeDiscretizers, this->hostInput, duration);
+		solution.ReadFrom(_solution);
+		return true;
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver1D<solverImpl, ms, md>::SetBoundaryConditions(cl::Vector<ms, md>& column) const
+	{
+		FiniteDifferenceInput1D _input(inputData.dt,
+									   inputData.spaceGrid.GetBuffer(),
+									   inputData.velocity.GetBuffer(),
+									   inputData.diffusion.GetBuffer(),
+									   inputData.solverType,
+									   inputData.spaceDiscretizerType,
+									   inputData.boundaryConditions);
+		pde::detail::SetBoundaryConditions1D(column.GetBuffer(), _input);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver1D<solverImpl, ms, md>::HasStatelessSteps() const noexcept
+	{
+		return !this->bandedTimeDiscretizers.imexSplitting && !this->bandedTimeDiscretizers.linearMultiStep;
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	BandedTimeDiscretizer<typename cl::Traits<md>::stdType> FiniteDifferenceSolver1D<solverImpl, ms, md>::SaveStepState() const
+	{
+		return pde::detail::SaveStepState(this->bandedTimeDiscretizers);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver1D<solverImpl, ms, md>::RestoreStepState(const BandedTimeDiscretizer<stdType>& state)
+	{
+		pde::detail::RestoreStepState(this->bandedTimeDiscretizers, state);
+	}
+
 	template<class solverImpl, MemorySpace ms, MathDomain md>
 	void FiniteDifferenceSolver1D<solverImpl, ms, md>::Setup(const unsigned solverSteps)
 	{
 		solution = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(inputData.initialCondition.nRows(), solverSteps);
 		solution->Set(*inputData.initialCondition.matrices[0]->columns[0], solverSteps - 1);
-		timeDiscretizers = std::make_shared<cl::Tensor<ms, md>>(inputData.initialCondition.nRows(), inputData.initialCondition.nRows(), solverSteps);
+
+		this->hostInput.dt = inputData.dt;
+		this->hostInput.spaceGrid = inputData.spaceGrid.Get();
+		this->hostInput.velocity = inputData.velocity.Get();
+		this->hostInput.diffusion = inputData.diffusion.Get();
+		this->hostInput.spaceDiscretizerType = inputData.spaceDiscretizerType;
+		this->hostInput.boundaryConditions = inputData.boundaryConditions;
+
+		// timeDiscretizers stays empty if the banded propagators are available
+		if (!static_cast<solverImpl*>(this)->MakeTimeDiscretizer(this->bandedTimeDiscretizers, inputData.solverType))
+		{
+			this->CheckMemoryBudget(inputData.initialCondition.nRows(), 1);
+			timeDiscretizers = std::make_shared<cl::Tensor<ms, md>>(inputData.initialCondition.nRows(), inputData.initialCondition.nRows(), solverSteps);
+		}
 
 		// need to calculate solution for all the steps > 1
-		for (int step = solverSteps - 2; step >= 0; --step)
+		Bootstrap(solverSteps);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver1D<solverImpl, ms, md>::Bootstrap(const unsigned solverSteps)
+	{
+		if (solverSteps < 2)
+			return;
+
+		// AdamsBashforth2 and AdamsMouldon2 are the only multi-step solver types: the level after the initial condition is the only one to fill
+		assert(solverSteps == 2);
+
+		// one CrankNicolson step is second order, whereas RungeKutta4 sub-steps keep the order of any of the multi-step schemes
+		const unsigned nSubSteps = std::max(1u, inputData.settings.bootstrapSubSteps);
+		const SolverType starterScheme = inputData.settings.bootstrapSubSteps > 0 ? SolverType::RungeKutta4 : SolverType::CrankNicolson;
+
+		if (!HasOneSidedPeriodicBoundaryConditions())
 		{
-			// make a volatile CrankNicolson scheme for filling the required steps in the solution
-			// WARNING: if the multi-step method is higher than second order, this might reduce the overall accuracy
-			constexpr SolverType multiStepEvolutionScheme = { SolverType::CrankNicolson };
-
-			auto tmp = std::make_shared<cl::Tensor<ms, md>>(inputData.initialCondition.nRows(), inputData.initialCondition.nRows(), 1);
-			static_cast<solverImpl*>(this)->MakeTimeDiscretizer(tmp, multiStepEvolutionScheme);
-
-			// copy the previous step solution
-			solution->Set(*solution->columns[step + 1], step);
-
-			// advance with CrankNicolson scheme
-			const auto& _solution = solution->columns[step];
-			FiniteDifferenceInput1D _input(inputData.dt,
-										   inputData.spaceGrid.GetBuffer(),
-										   inputData.velocity.GetBuffer(),
-										   inputData.diffusion.GetBuffer(),
-										   multiStepEvolutionScheme,
-										   inputData.spaceDiscretizerType,
-										   inputData.boundaryConditions);
-			MemoryTile tmpBuffer(_solution->GetBuffer().pointer, _solution->size(), 1, ms, md);
-			pde::detail::Iterate1D(tmpBuffer, tmp->GetCube(), _input, 1);
+			// the starter has its own operator and host input at the sub-step dt, so that those of the solver are left as they are
+			HostFiniteDifferenceInput1D<stdType> starterInput(this->hostInput);
+			starterInput.dt = inputData.dt / nSubSteps;
+
+			BandedMatrix<stdType> spaceDiscretizer;
+			pde::detail::MakeSpaceDiscretizer1D(spaceDiscretizer, starterInput);
+			BandedTimeDiscretizer<stdType> starter;
+			pde::detail::MakeTimeDiscretizerAdvectionDiffusion(starter, spaceDiscretizer, starterScheme, starterInput.dt);
+
+			auto level = solution->columns[1]->Get();
+			pde::detail::Iterate1D(level, starter, starterInput, nSubSteps);
+			solution->columns[0]->ReadFrom(level);
+			return;
 		}
+
+		// the dense propagators are built at the solver dt, which only CrankNicolson can take.
+		// The constructor only builds the solver propagators after Setup, so that the starter borrows the storage of the first one rather than allocating its own
+		constexpr SolverType denseStarterScheme = { SolverType::CrankNicolson };
+		const unsigned dimension = solution->nRows();
+		auto starter = std::make_shared<cl::Tensor<ms, md>>(MemoryCube(timeDiscretizers->matrices[0]->GetTile().pointer, dimension, dimension, 1, ms, md));
+		static_cast<solverImpl*>(this)->MakeTimeDiscretizer(starter, denseStarterScheme);
+
+		FiniteDifferenceInput1D _input(inputData.dt,
+									   inputData.spaceGrid.GetBuffer(),
+									   inputData.velocity.GetBuffer(),
+									   inputData.diffusion.GetBuffer(),
+									   denseStarterScheme,
+									   inputData.spaceDiscretizerType,
+									   inputData.boundaryConditions);
+
+		// copy the initial condition, and advance it in place
+		solution->Set(*solution->columns[1], 0);
+		const auto& _solution = solution->columns[0];
+		MemoryTile tmpBuffer(_solution->GetBuffer().pointer, _solution->size(), 1, ms, md);
+		pde::detail::Iterate1D(tmpBuffer, starter->GetCube(), _input, 1);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver1D<solverImpl, ms, md>::HasOneSidedPeriodicBoundaryConditions() const noexcept
+	{
+		return (this->hostInput.boundaryConditions.left.type == BoundaryConditionType::Periodic) !=
+			   (this->hostInput.boundaryConditions.right.type == BoundaryConditionType::Periodic);
 	}
 }
@@ -7,6 +7,7 @@
 
 #include <PdeInputData2D.h>
 #include <FiniteDifferenceManager.h>
+#include <BandedFiniteDifferenceManager.h>
 #include <FiniteDifferenceSolver.h>
 #include <CudaException.h>
 
@@ -19,13 +20,50 @@
 
 namespace pde
 {
+	namespace detail
+	{
+		/**
+		* Sparse 2D operators: as for BandedDiscretizers1D, this is a base class so that it's constructed before FiniteDifferenceSolver calls Setup
+		*/
+		template<typename stdType>
+		struct SparseDiscretizers2D
+		{
+			HostFiniteDifferenceInput2D<stdType> hostInput;
+
+			std::shared_ptr<SparseDiagonalMatrix<stdType>> sparseSpaceDiscretizer;
+			BandedTimeDiscretizer<stdType, SparseDiagonalMatrix> sparseTimeDiscretizers;
+
+			/**
+			* Used instead of sparseTimeDiscretizers when the input asks for an ADI scheme
+			*/
+			AdiTimeDiscretizer<stdType> adiTimeDiscretizer;
+
+			/**
+			* Used instead of sparseTimeDiscretizers when the input asks for Strang splitting
+			*/
+			StrangSplitting2D<stdType> strangSplitting;
+
+			/**
+			* Only set for separable coefficients, as the 1D factors of sparseSpaceDiscretizer
+			*/
+			std::shared_ptr<KroneckerOperator2D<stdType>> kroneckerSpaceDiscretizer;
+		};
+	}
+
+	/**
+	* CRTP implementation
+	* When the solver type admits it, the operators are kept in sparse (DIA) form and the dense dimension x dimension timeDiscretizers tensor is never allocated
+	*/
 	template<class solverImpl, MemorySpace memorySpace = MemorySpace::Device, MathDomain mathDomain = MathDomain::Float>
-	class FiniteDifferenceSolver2D : public FiniteDifferenceSolver<solverImpl, PdeInputData2D<memorySpace, mathDomain>, memorySpace, mathDomain>
+	class FiniteDifferenceSolver2D : protected detail::SparseDiscretizers2D<typename cl::Traits<mathDomain>::stdType>,
+									 public FiniteDifferenceSolver<solverImpl, PdeInputData2D<memorySpace, mathDomain>, memorySpace, mathDomain>
 	{
 	public:
 		friend class FiniteDifferenceSolver<solverImpl, PdeInputData2D<memorySpace, mathDomain>, memorySpace, mathDomain>;
 		using FiniteDifferenceSolver::FiniteDifferenceSolver;
 
+		typedef typename cl::Traits<mathDomain>::stdType stdType;
+
 		MAKE_DEFAULT_CONSTRUCTORS(FiniteDifferenceSolver2D);
 
 	protected:
@@ -34,7 +72,56 @@ namespace pde
 						 const SolverType solverType,
 						 const unsigned nSteps = 1);
 
+		/**
+		* Sparse propagators only: advances each column of solutions by nSteps, with one host transfer each way for all of them
+		*/
+		void AdvanceEnsembleImpl(cl::ColumnWiseMatrix<memorySpace, mathDomain>& solutions, const unsigned nSteps);
+
+		/**
+		* Adaptive schemes only: returns false if the solution can't be advanced by an arbitrary duration
+		*/
+		bool AdvanceAdaptive(cl::ColumnWiseMatrix<memorySpace, mathDomain>& solution, const double duration);
+
+		/**
+		* Applies the boundary conditions to a single grid function, with the same kernel as the dense steps
+		*/
+		void SetBoundaryConditions(cl::Vector<memorySpace, mathDomain>& column) const;
+
+		/**
+		* The host schemes that carry a history or the previous advection term of their only solution can't step anything else,
+		* as the ensemble members and the power iterations of EstimateSpectralRadius are
+		*/
+		bool HasStatelessSteps() const noexcept;
+
+		/**
+		* Whatever else carries from one host step to the next, for EstimateSpectralRadius to put it back after stepping its own vectors
+		*/
+		BandedTimeDiscretizer<stdType, SparseDiagonalMatrix> SaveStepState() const;
+		void RestoreStepState(const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& state);
+
 		void Setup(const unsigned solverSteps);
+
+		/**
+		* Two-step schemes only: advances the initial condition in the last column into the first one, without touching the operators of the solver.
+		* The dense starter is built into the storage of the solver propagators, before the constructor builds those
+		*/
+		void Bootstrap(const unsigned solverSteps);
+
+		/**
+		* The sparse stencils don't wrap around, and the velocities have to be given either per axis or per grid point.
+		* With periodic boundaries, only the fast diagonalization, the separable ADI schemes and the Strang splitting stay on the host: anything else is dense
+		*/
+		bool SupportsSparseOperators() const noexcept;
+
+		/**
+		* The host step of AdvanceImpl, on solution already read to the host: ADI, Strang splitting or the sparse propagators
+		*/
+		void IterateHost(std::vector<stdType>& solution, const unsigned nSteps);
+
+		/**
+		* Velocities given either per axis or per grid point, and diffusion per grid point: this is what the host-side operators read
+		*/
+		bool HasHostCoefficients() const noexcept;
 	};
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <FiniteDifferenceSolver2D.h>
+#include <algorithm>
+#include <cassert>
 
 namespace pde
 {
@@ -10,6 +12,21 @@ namespace pde
 																   const SolverType solverType,
 																   const unsigned nSteps = 1)
 	{
+		if (!timeDiscretizers)
+		{
+			// sparse propagators: the whole history is stepped on the host, and only copied back at the end
+			// the multi-step history only holds if solution is where their last step left it, which a write in between would change
+			std::vector<stdType> _solution = solution.Get();
+			if (!HasStatelessSteps() && !this->IsLastHostStep(solution, _solution))
+				pde::detail::ResetStepHistory(this->sparseTimeDiscretizers);
+
+			IterateHost(_solution, nSteps);
+			solution.ReadFrom(_solution);
+			if (!HasStatelessSteps())
+				this->SetLastHostStep(solution, _solution);
+			return;
+		}
+
 		FiniteDifferenceInput2D _input(inputData.dt,
 									   inputData.xSpaceGrid.GetBuffer(),
 									   inputData.ySpaceGrid.GetBuffer(),
@@ -19,9 +36,95 @@ namespace pde
 									   solverType,
 									   inputData.spaceDiscretizerType,
 									   inputData.boundaryConditions);
+
+		// the step applies A, then the boundary conditions, set by the same kernel as Iterate2D
+		auto setBoundaryConditions = [&_input](cl::Vector<ms, md>& column)
+		{
+			pde::detail::SetBoundaryConditions2D(column.GetBuffer(), _input);
+		};
+
+		// the power is the one dense allocation after Setup, which is checked against the budget before it's built
+		if (this->propagatorPowerCache.IsEnabled() && !this->propagatorPowerCache.HasPower(nSteps))
+			this->CheckMemoryBudget(static_cast<size_t>(0));
+		if (this->propagatorPowerCache.Advance(solution, *timeDiscretizers->matrices[0], nSteps, setBoundaryConditions))
+			return;
+
 		pde::detail::Iterate2D(solution.GetTile(), timeDiscretizers->GetCube(), _input, nSteps);
 	}
 
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver2D<solverImpl, ms, md>::AdvanceEnsembleImpl(cl::ColumnWiseMatrix<ms, md>& solutions, const unsigned nSteps)
+	{
+		// the members are stepped on the host one after the other, sharing the operators
+		std::vector<stdType> _solutions = solutions.Get();
+		const size_t nRows = solutions.nRows();
+		std::vector<stdType> member(nRows);
+		for (size_t k = 0; k < solutions.nCols(); ++k)
+		{
+			const auto memberBegin = _solutions.begin() + k * nRows;
+			std::copy(memberBegin, memberBegin + nRows, member.begin());
+			IterateHost(member, nSteps);
+			std::copy(member.begin(), member.end(), memberBegin);
+		}
+		solutions.ReadFrom(_solutions);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver2D<solverImpl, ms, md>::IterateHost(std::vector<stdType>& solution, const unsigned nSteps)
+	{
+		if (this->adiTimeDiscretizer.solverType != ExtendedSolverType::Null)
+			pde::detail::IterateAdi2D(solution, this->adiTimeDiscretizer, this->hostInput, nSteps);
+		else if (this->strangSplitting.solverType != ExtendedSolverType::Null)
+			pde::detail::IterateStrangSplitting2D(solution, this->strangSplitting, this->hostInput, nSteps);
+		else
+			pde::detail::Iterate2D(solution, this->sparseTimeDiscretizers, this->hostInput, nSteps, this->kroneckerSpaceDiscretizer.get());
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver2D<solverImpl, ms, md>::AdvanceAdaptive(cl::ColumnWiseMatrix<ms, md>& solution, const double duration)
+	{
+		if (!this->sparseTimeDiscretizers.embeddedRungeKutta)
+			return false;
+
+		std::vector<stdType> _solution = solution.Get();
+		pde::detail::AdvanceAdaptive2D(_solution, this->sparseTimeDiscretizers, this->hostInput, duration);
+		solution.ReadFrom(_solution);
+		return true;
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver2D<solverImpl, ms, md>::SetBoundaryConditions(cl::Vector<ms, md>& column) const
+	{
+		FiniteDifferenceInput2D _input(inputData.dt,
+									   inputData.xSpaceGrid.GetBuffer(),
+									   inputData.ySpaceGrid.GetBuffer(),
+									   inputData.xVelocity.GetBuffer(),
+									   inputData.yVelocity.GetBuffer(),
+									   inputData.diffusion.GetBuffer(),
+									   inputData.solverType,
+									   inputData.spaceDiscretizerType,
+									   inputData.boundaryConditions);
+		pde::detail::SetBoundaryConditions2D(column.GetBuffer(), _input);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver2D<solverImpl, ms, md>::HasStatelessSteps() const noexcept
+	{
+		return !this->sparseTimeDiscretizers.imexSplitting && !this->sparseTimeDiscretizers.linearMultiStep;
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	BandedTimeDiscretizer<typename cl::Traits<md>::stdType, SparseDiagonalMatrix> FiniteDifferenceSolver2D<solverImpl, ms, md>::SaveStepState() const
+	{
+		return pde::detail::SaveStepState(this->sparseTimeDiscretizers);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver2D<solverImpl, ms, md>::RestoreStepState(const BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& state)
+	{
+		pde::detail::RestoreStepState(this->sparseTimeDiscretizers, state);
+	}
+
 	template<class solverImpl, MemorySpace ms, MathDomain md>
 	void FiniteDifferenceSolver2D<solverImpl, ms, md>::Setup(const unsigned solverSteps)
 	{
@@ -29,37 +132,105 @@ namespace pde
 
 		solution = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(dimension, solverSteps, 0.0);
 
-		// has to linearise the initial condition first
-		auto flattenInitialCondition = inputData.initialCondition.matrices[0]->Flatten();
+		// the column-major initial condition is already linearised: a flat view of it avoids the Flatten() copy
+		const cl::Vector<ms, md> flattenInitialCondition(pde::detail::MakeFlatView(inputData.initialCondition.matrices[0]->GetTile()));
 		solution->Set(flattenInitialCondition, solverSteps - 1);
-		timeDiscretizers = std::make_shared<cl::Tensor<ms, md>>(dimension, dimension, solverSteps);
+
+		this->hostInput.dt = inputData.dt;
+		this->hostInput.xSpaceGrid = inputData.xSpaceGrid.Get();
+		this->hostInput.ySpaceGrid = inputData.ySpaceGrid.Get();
+		this->hostInput.xVelocity = inputData.xVelocity.Get();
+		this->hostInput.yVelocity = inputData.yVelocity.Get();
+		this->hostInput.diffusion = inputData.diffusion.Get();
+		this->hostInput.spaceDiscretizerType = inputData.spaceDiscretizerType;
+		this->hostInput.boundaryConditions = inputData.boundaryConditions;
+
+		// timeDiscretizers stays empty if the ADI, the Strang splitting or the sparse propagators are available:
+		// the splittings only apply to first order in time problems, which don't carry a solutionDerivative
+		bool useSplitting = false;
+		if constexpr (!solverImpl::hasSolutionDerivative)
+			useSplitting = static_cast<solverImpl*>(this)->MakeTimeDiscretizer(this->adiTimeDiscretizer, inputData.settings.extendedSolverType) ||
+						   static_cast<solverImpl*>(this)->MakeTimeDiscretizer(this->strangSplitting, inputData.settings.extendedSolverType);
+		if (!useSplitting && !static_cast<solverImpl*>(this)->MakeTimeDiscretizer(this->sparseTimeDiscretizers, inputData.solverType))
+		{
+			this->CheckMemoryBudget(this->inputData.initialCondition.nRows(), this->inputData.initialCondition.nCols());
+			timeDiscretizers = std::make_shared<cl::Tensor<ms, md>>(dimension, dimension, solverSteps);
+		}
 
 		// need to calculate solution for all the steps > 1
-		for (int step = solverSteps - 2; step >= 0; --step)
+		Bootstrap(solverSteps);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	void FiniteDifferenceSolver2D<solverImpl, ms, md>::Bootstrap(const unsigned solverSteps)
+	{
+		if (solverSteps < 2)
+			return;
+
+		// as in 1D: a single level to fill, with one CrankNicolson step, or RungeKutta4 sub-steps that keep the order of the multi-step scheme
+		assert(solverSteps == 2);
+		const unsigned nSubSteps = std::max(1u, inputData.settings.bootstrapSubSteps);
+		const SolverType starterScheme = inputData.settings.bootstrapSubSteps > 0 ? SolverType::RungeKutta4 : SolverType::CrankNicolson;
+
+		if (SupportsSparseOperators())
 		{
-			// make a volatile CrankNicolson scheme for filling the required steps in the solution
-			// WARNING: if the multi-step method is higher than second order, this might reduce the overall accuracy
-			constexpr SolverType multiStepEvolutionScheme = { SolverType::CrankNicolson };
-
-			auto tmp = std::make_shared<cl::Tensor<ms, md>>(dimension, dimension, 1);
-			static_cast<solverImpl*>(this)->MakeTimeDiscretizer(tmp, multiStepEvolutionScheme);
-
-			// copy the previous step solution
-			solution->Set(*solution->columns[step + 1], step);
-
-			// advance with CrankNicolson scheme
-			const auto& _solution = solution->columns[step];
-			FiniteDifferenceInput2D _input(inputData.dt,
-										   inputData.xSpaceGrid.GetBuffer(),
-										   inputData.ySpaceGrid.GetBuffer(),
-										   inputData.xVelocity.GetBuffer(),
-										   inputData.yVelocity.GetBuffer(),
-										   inputData.diffusion.GetBuffer(),
-										   multiStepEvolutionScheme,
-										   inputData.spaceDiscretizerType,
-										   inputData.boundaryConditions);
-			MemoryTile tmpBuffer(_solution->GetBuffer().pointer, _solution->size(), 1, ms, md);
-			pde::detail::Iterate2D(tmpBuffer, tmp->GetCube(), _input, 1);
+			// the starter has its own operator and host input at the sub-step dt, so that those of the solver are left as they are
+			HostFiniteDifferenceInput2D<stdType> starterInput(this->hostInput);
+			starterInput.dt = inputData.dt / nSubSteps;
+
+			SparseDiagonalMatrix<stdType> spaceDiscretizer;
+			pde::detail::MakeSpaceDiscretizer2D(spaceDiscretizer, starterInput);
+			BandedTimeDiscretizer<stdType, SparseDiagonalMatrix> starter;
+			pde::detail::MakeTimeDiscretizerAdvectionDiffusion(starter, spaceDiscretizer, starterScheme, starterInput.dt, inputData.settings.linearSolverSettings, &starterInput);
+
+			auto level = solution->columns[1]->Get();
+			pde::detail::Iterate2D(level, starter, starterInput, nSubSteps);
+			solution->columns[0]->ReadFrom(level);
+			return;
 		}
+
+		// the dense propagators are built at the solver dt, which only CrankNicolson can take.
+		// The constructor only builds the solver propagators after Setup, so that the starter borrows the storage of the first one rather than allocating its own
+		constexpr SolverType denseStarterScheme = { SolverType::CrankNicolson };
+		const unsigned dimension = solution->nRows();
+		auto starter = std::make_shared<cl::Tensor<ms, md>>(MemoryCube(timeDiscretizers->matrices[0]->GetTile().pointer, dimension, dimension, 1, ms, md));
+		static_cast<solverImpl*>(this)->MakeTimeDiscretizer(starter, denseStarterScheme);
+
+		FiniteDifferenceInput2D _input(inputData.dt,
+									   inputData.xSpaceGrid.GetBuffer(),
+									   inputData.ySpaceGrid.GetBuffer(),
+									   inputData.xVelocity.GetBuffer(),
+									   inputData.yVelocity.GetBuffer(),
+									   inputData.diffusion.GetBuffer(),
+									   denseStarterScheme,
+									   inputData.spaceDiscretizerType,
+									   inputData.boundaryConditions);
+
+		// copy the initial condition, and advance it in place
+		solution->Set(*solution->columns[1], 0);
+		const auto& _solution = solution->columns[0];
+		MemoryTile tmpBuffer(_solution->GetBuffer().pointer, _solution->size(), 1, ms, md);
+		pde::detail::Iterate2D(tmpBuffer, starter->GetCube(), _input, 1);
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver2D<solverImpl, ms, md>::SupportsSparseOperators() const noexcept
+	{
+		const auto& bc = this->hostInput.boundaryConditions;
+		for (const auto& boundaryCondition : { bc.left, bc.right, bc.down, bc.up })
+			if (boundaryCondition.type == BoundaryConditionType::Periodic)
+				return false;
+
+		return HasHostCoefficients();
+	}
+
+	template<class solverImpl, MemorySpace ms, MathDomain md>
+	bool FiniteDifferenceSolver2D<solverImpl, ms, md>::HasHostCoefficients() const noexcept
+	{
+		const size_t nRows = this->hostInput.xSpaceGrid.size();
+		const size_t nCols = this->hostInput.ySpaceGrid.size();
+		const auto hasValidSize = [nRows, nCols](const size_t size, const size_t axisSize) { return size == axisSize || size == nRows * nCols; };
+
+		return hasValidSize(this->hostInput.xVelocity.size(), nRows) && hasValidSize(this->hostInput.yVelocity.size(), nCols) && this->hostInput.diffusion.size() == nRows * nCols;
 	}
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <Types.h>
+#include <Exception.h>
+
+namespace pde
+{
+	class InputViewMismatchException : public Exception
+	{
+	public:
+		InputViewMismatchException(const std::string& message = "")
+			: Exception("InputViewMismatchException: " + message)
+		{
+		}
+	};
+
+	/**
+	*	Non-owning views of the input fields: the cl containers built from a MemoryBuffer, MemoryTile or MemoryCube wrap that memory rather than copying it.
+	*	A view is a pointer, a shape and a leading dimension (the stride between two columns), which the kernels require to be nRows: column-major and contiguous.
+	*	The memory (a host buffer, a memory-mapped file, a device allocation...) must outlive the PdeInputData built from it, and the solver reading it.
+	*/
+	namespace detail
+	{
+		/**
+		* The cl containers reinterpret the view memory as theirs: a view in another memory space or math domain would be read as garbage
+		*/
+		template<MemorySpace memorySpace, MathDomain mathDomain, typename viewType>
+		const viewType& CheckView(const viewType& view, const char* name)
+		{
+			if (view.memorySpace != memorySpace)
+				throw InputViewMismatchException(std::string(name) + " lives in another memory space than the input data");
+			if (view.mathDomain != mathDomain)
+				throw InputViewMismatchException(std::string(name) + " has another math domain than the input data");
+			return view;
+		}
+
+		/**
+		* A column-major tile is already its flattened vector: no Flatten() copy is needed
+		*/
+		inline MemoryBuffer MakeFlatView(const MemoryTile& tile) noexcept
+		{
+			return MemoryBuffer(tile.pointer, tile.nRows * tile.nCols, tile.memorySpace, tile.mathDomain);
+		}
+
+		/**
+		* Single matrix cube, as PdeInputData::initialCondition holds: a vector is a one-column matrix
+		*/
+		inline MemoryCube MakeCubeView(const MemoryTile& tile) noexcept
+		{
+			return MemoryCube(tile.pointer, tile.nRows, tile.nCols, 1, tile.memorySpace, tile.mathDomain);
+		}
+
+		inline MemoryCube MakeCubeView(const MemoryBuffer& buffer) noexcept
+		{
+			return MemoryCube(buffer.pointer, buffer.size, 1, 1, buffer.memorySpace, buffer.mathDomain);
+		}
+	}
+
+	/**
+	* Host memory (e.g. std::vector::data() or a mapped file) seen as an nRows x nCols column-major field of stdType, with stdType matching mathDomain
+	*/
+	template<MathDomain mathDomain, typename stdType>
+	MemoryTile MakeHostView(const stdType* data, const unsigned nRows, const unsigned nCols = 1) noexcept
+	{
+		static_assert(sizeof(stdType) == (mathDomain == MathDomain::Double ? sizeof(double) : sizeof(float)), "stdType doesn't match mathDomain");
+		return MemoryTile(reinterpret_cast<ptr_t>(data), nRows, nCols, MemorySpace::Host, mathDomain);
+	}
+}
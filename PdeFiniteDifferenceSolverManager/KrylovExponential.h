@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+namespace pde
+{
+	/**
+	*	Exponential integrator: u_{n + 1} = exp(dt * L) * u_n, approximated as beta * V * exp(tau * H) * e_1 on the Krylov subspace of u_n, built by Arnoldi iterations.
+	*	Only products with L are needed, so that neither the propagator nor an inverse is ever formed, and the step is exact up to the Krylov approximation:
+	*	dt is then limited by accuracy rather than stability. If the a posteriori error estimate is too large, dt is split into substeps,
+	*	and the substep size is carried over to the next call. matrixType is BandedMatrix for 1D operators and SparseDiagonalMatrix for 2D ones.
+	*/
+	template<typename stdType, template<typename> class matrixType>
+	class KrylovExponential
+	{
+	public:
+		KrylovExponential(const matrixType<stdType>& spaceDiscretizer, const double dt);
+
+		virtual ~KrylovExponential() noexcept = default;
+		KrylovExponential(const KrylovExponential& rhs) = default;
+		KrylovExponential(KrylovExponential&& rhs) noexcept = default;
+		KrylovExponential& operator=(const KrylovExponential& rhs) = default;
+		KrylovExponential& operator=(KrylovExponential&& rhs) noexcept = default;
+
+		unsigned nRows() const noexcept { return spaceDiscretizer.nRows(); }
+
+		/**
+		* Substeps taken by the last Apply
+		*/
+		unsigned lastSubsteps() const noexcept { return _lastSubsteps; }
+
+		/**
+		* x = exp(dt * L) * x
+		*/
+		void Apply(stdType* x) const;
+
+	private:
+		/**
+		* Dimension of the Krylov subspace, unless the Arnoldi iterations break down earlier, in which case the subspace is invariant and the step is exact
+		*/
+		static constexpr unsigned krylovDimension = 30;
+
+		/**
+		* out = exp(matrix) for a k x k column-major matrix, by scaling and squaring of the diagonal (6, 6) Pade approximant
+		*/
+		static void MakeExponential(std::vector<double>& out, std::vector<double> matrix, const size_t k);
+
+		matrixType<stdType> spaceDiscretizer;
+		double dt;
+
+		/**
+		* Error allowed per step, relative to the norm of the solution
+		*/
+		double tolerance;
+
+		mutable double substep;
+		mutable unsigned _lastSubsteps = 0;
+
+		/**
+		* Workspace: the Arnoldi basis (krylovDimension + 1 vectors), and the (krylovDimension + 1) x krylovDimension Hessenberg matrix
+		*/
+		mutable std::vector<stdType> basis;
+		mutable std::vector<double> hessenberg;
+		mutable std::vector<double> exponential;
+	};
+}
+
+#include <KrylovExponential.tpp>
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <KrylovExponential.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace pde
+{
+	template<typename stdType, template<typename> class matrixType>
+	KrylovExponential<stdType, matrixType>::KrylovExponential(const matrixType<stdType>& spaceDiscretizer, const double dt)
+		: spaceDiscretizer(spaceDiscretizer), dt(dt), substep(dt)
+	{
+		tolerance = std::max(1e-12, 10.0 * static_cast<double>(std::numeric_limits<stdType>::epsilon()));
+
+		const size_t n = spaceDiscretizer.nRows();
+		const size_t m = std::min<size_t>(krylovDimension, n);
+		basis.resize((m + 1) * n);
+		hessenberg.resize((m + 1) * m);
+	}
+
+	template<typename stdType, template<typename> class matrixType>
+	void KrylovExponential<stdType, matrixType>::Apply(stdType* x) const
+	{
+		const size_t n = spaceDiscretizer.nRows();
+		const size_t m = std::min<size_t>(krylovDimension, n);
+		const auto getNorm = [n](const stdType* v)
+		{
+			double norm = 0.0;
+			for (size_t i = 0; i < n; ++i)
+				norm += static_cast<double>(v[i]) * v[i];
+			return std::sqrt(norm);
+		};
+
+		_lastSubsteps = 0;
+		double t = 0.0;
+		while (t < dt)
+		{
+			const double beta = getNorm(x);
+			if (beta == 0.0)
+				return;
+
+			// Arnoldi with modified Gram-Schmidt: L * V_k = V_{k + 1} * H
+			std::fill(hessenberg.begin(), hessenberg.end(), 0.0);
+			for (size_t i = 0; i < n; ++i)
+				basis[i] = static_cast<stdType>(x[i] / beta);
+
+			size_t k = m;
+			bool isInvariant = false;
+			for (size_t j = 0; j < m; ++j)
+			{
+				stdType* v = basis.data() + (j + 1) * n;
+				spaceDiscretizer.Dot(v, basis.data() + j * n);
+				const double productNorm = getNorm(v);
+
+				for (size_t i = 0; i <= j; ++i)
+				{
+					const stdType* q = basis.data() + i * n;
+					double h = 0.0;
+					for (size_t l = 0; l < n; ++l)
+						h += static_cast<double>(q[l]) * v[l];
+					hessenberg[i + j * (m + 1)] = h;
+					for (size_t l = 0; l < n; ++l)
+						v[l] -= static_cast<stdType>(h) * q[l];
+				}
+
+				// happy breakdown: L * v_j lies in the subspace, which is then invariant
+				const double h = getNorm(v);
+				hessenberg[j + 1 + j * (m + 1)] = h;
+				if (h <= 100.0 * std::numeric_limits<stdType>::epsilon() * productNorm)
+				{
+					k = j + 1;
+					isInvariant = true;
+					break;
+				}
+				for (size_t l = 0; l < n; ++l)
+					v[l] = static_cast<stdType>(v[l] / h);
+			}
+
+			// the subspace doesn't depend on the substep: if the error is too large, only the small exponential is recomputed
+			std::vector<double> reducedMatrix(k * k);
+			for (;;)
+			{
+				const double tau = std::min(substep, dt - t);
+				for (size_t j = 0; j < k; ++j)
+					for (size_t i = 0; i < k; ++i)
+						reducedMatrix[i + j * k] = tau * hessenberg[i + j * (m + 1)];
+				MakeExponential(exponential, reducedMatrix, k);
+
+				// the residual of the Krylov approximation is beta * h_{k + 1, k} * |e_k^T * exp(tau * H) * e_1| (Saad)
+				const double error = isInvariant ? 0.0 : beta * hessenberg[k + (k - 1) * (m + 1)] * std::abs(exponential[k - 1]);
+				const double allowedError = tolerance * beta * tau / dt;
+				const bool isLastSubstep = tau == dt - t;
+				if (error > allowedError && tau > std::numeric_limits<double>::epsilon() * dt)
+				{
+					substep = tau * std::max(.2, .9 * std::pow(allowedError / error, 1.0 / k));
+					continue;
+				}
+
+				// x = beta * V_k * exp(tau * H) * e_1
+				std::fill(x, x + n, stdType(0.0));
+				for (size_t j = 0; j < k; ++j)
+				{
+					const stdType weight = static_cast<stdType>(beta * exponential[j]);
+					const stdType* q = basis.data() + j * n;
+					for (size_t i = 0; i < n; ++i)
+						x[i] += weight * q[i];
+				}
+
+				t = isLastSubstep ? dt : t + tau;
+				++_lastSubsteps;
+
+				// grow the substep back if the error allows it, but don't let the last substep, which may have been clipped, shrink it
+				const double growth = error > 0.0 ? std::min(2.0, .9 * std::pow(allowedError / error, 1.0 / k)) : 2.0;
+				substep = isLastSubstep ? std::max(substep, std::min(dt, tau * growth)) : std::min(dt, tau * growth);
+				break;
+			}
+		}
+	}
+
+	template<typename stdType, template<typename> class matrixType>
+	void KrylovExponential<stdType, matrixType>::MakeExponential(std::vector<double>& out, std::vector<double> matrix, const size_t k)
+	{
+		// scale the infinity norm below 1/2
+		double norm = 0.0;
+		for (size_t i = 0; i < k; ++i)
+		{
+			double rowNorm = 0.0;
+			for (size_t j = 0; j < k; ++j)
+				rowNorm += std::abs(matrix[i + j * k]);
+			norm = std::max(norm, rowNorm);
+		}
+		int exponent = 0;
+		std::frexp(norm, &exponent);
+		const int nSquarings = std::max(0, exponent + 1);
+		const double scale = std::ldexp(1.0, -nSquarings);
+		for (auto& x : matrix)
+			x *= scale;
+
+		const auto multiply = [k](std::vector<double>& product, const std::vector<double>& lhs, const std::vector<double>& rhs)
+		{
+			std::fill(product.begin(), product.end(), 0.0);
+			for (size_t j = 0; j < k; ++j)
+				for (size_t l = 0; l < k; ++l)
+				{
+					const double r = rhs[l + j * k];
+					for (size_t i = 0; i < k; ++i)
+						product[i + j * k] += lhs[i + l * k] * r;
+				}
+		};
+
+		// N = sum_j c_j * A^j, D = sum_j (-1)^j * c_j * A^j
+		std::vector<double> numerator(k * k, 0.0), denominator(k * k, 0.0), power(matrix), buffer(k * k);
+		for (size_t i = 0; i < k; ++i)
+			numerator[i + i * k] = denominator[i + i * k] = 1.0;
+		constexpr unsigned order = 6;
+		double coefficient = 1.0;
+		for (unsigned j = 1; j <= order; ++j)
+		{
+			coefficient *= static_cast<double>(order + 1 - j) / static_cast<double>(j * (2 * order + 1 - j));
+			if (j > 1)
+			{
+				multiply(buffer, matrix, power);
+				power.swap(buffer);
+			}
+
+			const double sign = j % 2 == 0 ? 1.0 : -1.0;
+			for (size_t l = 0; l < k * k; ++l)
+			{
+				numerator[l] += coefficient * power[l];
+				denominator[l] += sign * coefficient * power[l];
+			}
+		}
+
+		// exp(A) ~= D^{-1} * N, by Gaussian elimination with partial pivoting on all the columns of N at once
+		for (size_t c = 0; c < k; ++c)
+		{
+			size_t pivot = c;
+			for (size_t i = c + 1; i < k; ++i)
+				if (std::abs(denominator[i + c * k]) > std::abs(denominator[pivot + c * k]))
+					pivot = i;
+			assert(denominator[pivot + c * k] != 0.0);
+			if (pivot != c)
+			{
+				for (size_t j = 0; j < k; ++j)
+				{
+					std::swap(denominator[c + j * k], denominator[pivot + j * k]);
+					std::swap(numerator[c + j * k], numerator[pivot + j * k]);
+				}
+			}
+
+			for (size_t i = c + 1; i < k; ++i)
+			{
+				const double factor = denominator[i + c * k] / denominator[c + c * k];
+				if (factor == 0.0)
+					continue;
+				for (size_t j = c; j < k; ++j)
+					denominator[i + j * k] -= factor * denominator[c + j * k];
+				for (size_t j = 0; j < k; ++j)
+					numerator[i + j * k] -= factor * numerator[c + j * k];
+			}
+		}
+		for (size_t j = 0; j < k; ++j)
+		{
+			for (size_t c = k; c-- > 0;)
+			{
+				double sum = numerator[c + j * k];
+				for (size_t l = c + 1; l < k; ++l)
+					sum -= denominator[c + l * k] * numerator[l + j * k];
+				numerator[c + j * k] = sum / denominator[c + c * k];
+			}
+		}
+
+		out.swap(numerator);
+		for (int s = 0; s < nSquarings; ++s)
+		{
+			multiply(buffer, out, out);
+			out.swap(buffer);
+		}
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <SparseDiagonalMatrix.h>
+#include <LinearSolverSettings.h>
+#include <MultigridSolver.h>
+
+namespace pde
+{
+	/**
+	*	Iterative solver for the sparse implicit systems of the 2D schemes, whose banded factorization would cost O(nRows) memory per grid point:
+	*	here memory is a few vectors of the grid size. Conjugate gradient is used if the matrix is symmetric (pure diffusion) and the preconditioner isn't multigrid, BiCGSTAB otherwise.
+	*	Rows with no off-diagonal entries (the boundary rows of I - c * dt * L) are solved upfront, so that they don't break the symmetry of the interior block.
+	*/
+	template<typename stdType>
+	class KrylovSolver
+	{
+	public:
+		/**
+		* multigrid is only used if settings asks for a multigrid preconditioner
+		*/
+		KrylovSolver(const SparseDiagonalMatrix<stdType>& matrix, const LinearSolverSettings& settings, std::shared_ptr<const MultigridSolver<stdType>> multigrid = nullptr);
+
+		virtual ~KrylovSolver() noexcept = default;
+		KrylovSolver(const KrylovSolver& rhs) = default;
+		KrylovSolver(KrylovSolver&& rhs) noexcept = default;
+		KrylovSolver& operator=(const KrylovSolver& rhs) = default;
+		KrylovSolver& operator=(KrylovSolver&& rhs) noexcept = default;
+
+		unsigned nRows() const noexcept { return matrix.nRows(); }
+		bool symmetric() const noexcept { return _symmetric; }
+
+		/**
+		* Iterations taken by the last Solve
+		*/
+		unsigned lastIterations() const noexcept { return _lastIterations; }
+
+		/**
+		* x = A^{-1} * x, iterating from initialGuess (e.g. the previous time step) if given, or from x otherwise.
+		* Returns false if the tolerance wasn't reached within the maximum number of iterations
+		*/
+		bool Solve(stdType* x, const stdType* initialGuess = nullptr) const;
+
+	private:
+		bool SolveConjugateGradient(stdType* x) const;
+		bool SolveBiCgStab(stdType* x) const;
+
+		/**
+		* out = P^{-1} * in
+		*/
+		void Precondition(stdType* out, const stdType* in) const;
+
+		SparseDiagonalMatrix<stdType> matrix;
+		LinearSolverSettings settings;
+		bool _symmetric = false;
+
+		/**
+		* As in settings, unless a multigrid preconditioner was requested without a multigrid hierarchy
+		*/
+		PreconditionerType preconditionerType;
+		std::shared_ptr<const MultigridSolver<stdType>> multigrid;
+
+		/**
+		* Jacobi: reciprocal of the main diagonal. ILU(0): unit lower factor below the main diagonal and upper factor on and above it, on the diagonals of the matrix
+		*/
+		std::vector<stdType> inverseDiagonal;
+		SparseDiagonalMatrix<stdType> incompleteFactors;
+
+		mutable unsigned _lastIterations = 0;
+
+		/**
+		* Workspace, allocated once
+		*/
+		mutable std::vector<stdType> rhs;
+		mutable std::vector<stdType> residual;
+		mutable std::vector<stdType> shadowResidual;
+		mutable std::vector<stdType> direction;
+		mutable std::vector<stdType> preconditionedDirection;
+		mutable std::vector<stdType> product;
+		mutable std::vector<stdType> secondProduct;
+		mutable std::vector<stdType> preconditionedResidual;
+	};
+}
+
+#include <KrylovSolver.tpp>
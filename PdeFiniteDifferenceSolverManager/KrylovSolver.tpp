@@ -0,0 +1,301 @@
+#pragma once
+
+#include <KrylovSolver.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace pde
+{
+	namespace detail
+	{
+		template<typename stdType>
+		double Dot(const std::vector<stdType>& lhs, const std::vector<stdType>& rhs) noexcept
+		{
+			double ret = 0.0;
+			for (size_t i = 0; i < lhs.size(); ++i)
+				ret += static_cast<double>(lhs[i]) * rhs[i];
+
+			return ret;
+		}
+
+		template<typename stdType>
+		double Norm(const std::vector<stdType>& x) noexcept
+		{
+			return std::sqrt(Dot(x, x));
+		}
+	}
+
+	template<typename stdType>
+	KrylovSolver<stdType>::KrylovSolver(const SparseDiagonalMatrix<stdType>& matrix, const LinearSolverSettings& settings, std::shared_ptr<const MultigridSolver<stdType>> multigrid)
+		: matrix(matrix), settings(settings), preconditionerType(settings.preconditionerType), multigrid(std::move(multigrid))
+	{
+		const int n = static_cast<int>(matrix.nRows());
+		const stdType* mainDiagonal = matrix.Diagonal(0);
+		assert(mainDiagonal);
+
+		// a row is decoupled if it has no off-diagonal entries, i.e. it's a boundary row
+		std::vector<bool> decoupled(n, true);
+		for (const int k : matrix.Offsets())
+		{
+			if (k == 0)
+				continue;
+
+			const stdType* diagonal = matrix.Diagonal(k);
+			for (int i = std::max(0, -k); i < std::min(n, n - k); ++i)
+				if (diagonal[i] != stdType(0.0))
+					decoupled[i] = false;
+		}
+
+		// symmetry is only needed on the block of the coupled rows: the decoupled ones are solved before iterating
+		_symmetric = true;
+		const stdType tolerance = std::sqrt(std::numeric_limits<stdType>::epsilon());
+		for (const int k : matrix.Offsets())
+		{
+			const stdType* diagonal = matrix.Diagonal(k);
+			const stdType* transposedDiagonal = matrix.Diagonal(-k);
+			for (int i = std::max(0, -k); i < std::min(n, n - k) && _symmetric; ++i)
+			{
+				if (decoupled[i] || decoupled[i + k])
+					continue;
+
+				// A(i, i + k) against A(i + k, i)
+				const stdType transposed = transposedDiagonal ? transposedDiagonal[i + k] : stdType(0.0);
+				_symmetric = std::abs(diagonal[i] - transposed) <= tolerance * (std::abs(diagonal[i]) + std::abs(transposed));
+			}
+		}
+
+		if (preconditionerType == PreconditionerType::Multigrid && !this->multigrid)
+			preconditionerType = PreconditionerType::IncompleteLu;
+
+		switch (preconditionerType)
+		{
+			case PreconditionerType::Jacobi:
+				inverseDiagonal.resize(n);
+				for (int i = 0; i < n; ++i)
+					inverseDiagonal[i] = stdType(1.0) / mainDiagonal[i];
+				break;
+			case PreconditionerType::IncompleteLu:
+			{
+				// IKJ elimination, where only the updates that land on a stored diagonal are kept
+				incompleteFactors = matrix;
+				const auto& offsets = incompleteFactors.Offsets();
+				std::vector<stdType*> factors;
+				for (const int k : offsets)
+					factors.push_back(incompleteFactors.AddDiagonal(k));
+				const size_t main = std::find(offsets.begin(), offsets.end(), 0) - offsets.begin();
+
+				for (int i = 0; i < n; ++i)
+				{
+					for (size_t a = 0; a < main; ++a)
+					{
+						// L(i, j) = A(i, j) / U(j, j), then A(i, j + b) -= L(i, j) * U(j, j + b)
+						const int j = i + offsets[a];
+						if (j < 0)
+							continue;
+
+						const stdType lower = factors[a][i] /= factors[main][j];
+						if (lower == stdType(0.0))
+							continue;
+
+						for (size_t b = main + 1; b < offsets.size(); ++b)
+						{
+							if (j + offsets[b] >= n)
+								continue;
+
+							const auto target = std::find(offsets.begin(), offsets.end(), offsets[a] + offsets[b]);
+							if (target != offsets.end())
+								factors[target - offsets.begin()][i] -= lower * factors[b][j];
+						}
+					}
+
+					assert(factors[main][i] != stdType(0.0));
+				}
+
+				inverseDiagonal.resize(n);
+				for (int i = 0; i < n; ++i)
+					inverseDiagonal[i] = stdType(1.0) / factors[main][i];
+				break;
+			}
+			default:
+				break;
+		}
+
+		for (auto* buffer : { &rhs, &residual, &shadowResidual, &direction, &preconditionedDirection, &product, &secondProduct, &preconditionedResidual })
+			buffer->resize(n);
+	}
+
+	template<typename stdType>
+	bool KrylovSolver<stdType>::Solve(stdType* x, const stdType* initialGuess) const
+	{
+		const size_t n = nRows();
+		std::copy(x, x + n, rhs.begin());
+		if (initialGuess && initialGuess != x)
+			std::copy(initialGuess, initialGuess + n, x);
+
+		// decoupled rows are exact from the start, so that the residual and all the search directions vanish on them
+		const stdType* mainDiagonal = matrix.Diagonal(0);
+		matrix.Dot(product.data(), x);
+		for (size_t i = 0; i < n; ++i)
+		{
+			const stdType offDiagonalProduct = product[i] - mainDiagonal[i] * x[i];
+			if (offDiagonalProduct == stdType(0.0))
+				x[i] = rhs[i] / mainDiagonal[i];
+		}
+
+		// the multigrid restriction isn't a multiple of the transposed prolongation, so that the V-cycle isn't symmetric even if the matrix is
+		return _symmetric && preconditionerType != PreconditionerType::Multigrid ? SolveConjugateGradient(x) : SolveBiCgStab(x);
+	}
+
+	template<typename stdType>
+	bool KrylovSolver<stdType>::SolveConjugateGradient(stdType* x) const
+	{
+		const size_t n = nRows();
+		const double threshold = settings.Tolerance<stdType>() * detail::Norm(rhs);
+
+		// r = b - A * x
+		matrix.Dot(residual.data(), x);
+		for (size_t i = 0; i < n; ++i)
+			residual[i] = rhs[i] - residual[i];
+
+		_lastIterations = 0;
+		if (detail::Norm(residual) <= threshold)
+			return true;
+
+		Precondition(preconditionedResidual.data(), residual.data());
+		std::copy(preconditionedResidual.begin(), preconditionedResidual.end(), direction.begin());
+		double residualDot = detail::Dot(residual, preconditionedResidual);
+
+		for (unsigned iteration = 1; iteration <= settings.maxIterations; ++iteration)
+		{
+			_lastIterations = iteration;
+
+			// q = A * p, alpha = (r, z) / (p, q)
+			matrix.Dot(product.data(), direction.data());
+			const stdType alpha = static_cast<stdType>(residualDot / detail::Dot(direction, product));
+			for (size_t i = 0; i < n; ++i)
+			{
+				x[i] += alpha * direction[i];
+				residual[i] -= alpha * product[i];
+			}
+
+			if (detail::Norm(residual) <= threshold)
+				return true;
+
+			// z = P^{-1} * r, p = z + beta * p
+			Precondition(preconditionedResidual.data(), residual.data());
+			const double newResidualDot = detail::Dot(residual, preconditionedResidual);
+			const stdType beta = static_cast<stdType>(newResidualDot / residualDot);
+			residualDot = newResidualDot;
+			for (size_t i = 0; i < n; ++i)
+				direction[i] = preconditionedResidual[i] + beta * direction[i];
+		}
+
+		return false;
+	}
+
+	template<typename stdType>
+	bool KrylovSolver<stdType>::SolveBiCgStab(stdType* x) const
+	{
+		const size_t n = nRows();
+		const double threshold = settings.Tolerance<stdType>() * detail::Norm(rhs);
+
+		// r = b - A * x, and the shadow residual is r itself
+		matrix.Dot(residual.data(), x);
+		for (size_t i = 0; i < n; ++i)
+			residual[i] = rhs[i] - residual[i];
+		std::copy(residual.begin(), residual.end(), shadowResidual.begin());
+
+		_lastIterations = 0;
+		if (detail::Norm(residual) <= threshold)
+			return true;
+
+		std::fill(direction.begin(), direction.end(), stdType(0.0));
+		std::fill(product.begin(), product.end(), stdType(0.0));
+		double rho = 1.0, alpha = 1.0, omega = 1.0;
+		for (unsigned iteration = 1; iteration <= settings.maxIterations; ++iteration)
+		{
+			_lastIterations = iteration;
+
+			const double newRho = detail::Dot(shadowResidual, residual);
+			if (newRho == 0.0 || omega == 0.0)
+				return false;
+
+			// p = r + beta * (p - omega * v)
+			const double beta = (newRho / rho) * (alpha / omega);
+			rho = newRho;
+			for (size_t i = 0; i < n; ++i)
+				direction[i] = residual[i] + static_cast<stdType>(beta) * (direction[i] - static_cast<stdType>(omega) * product[i]);
+
+			// v = A * P^{-1} * p, s = r - alpha * v (stored in r)
+			Precondition(preconditionedDirection.data(), direction.data());
+			matrix.Dot(product.data(), preconditionedDirection.data());
+			alpha = rho / detail::Dot(shadowResidual, product);
+			for (size_t i = 0; i < n; ++i)
+			{
+				x[i] += static_cast<stdType>(alpha) * preconditionedDirection[i];
+				residual[i] -= static_cast<stdType>(alpha) * product[i];
+			}
+
+			if (detail::Norm(residual) <= threshold)
+				return true;
+
+			// t = A * P^{-1} * s, omega = (t, s) / (t, t)
+			Precondition(preconditionedResidual.data(), residual.data());
+			matrix.Dot(secondProduct.data(), preconditionedResidual.data());
+			omega = detail::Dot(secondProduct, residual) / detail::Dot(secondProduct, secondProduct);
+			for (size_t i = 0; i < n; ++i)
+			{
+				x[i] += static_cast<stdType>(omega) * preconditionedResidual[i];
+				residual[i] -= static_cast<stdType>(omega) * secondProduct[i];
+			}
+
+			if (detail::Norm(residual) <= threshold)
+				return true;
+		}
+
+		return false;
+	}
+
+	template<typename stdType>
+	void KrylovSolver<stdType>::Precondition(stdType* out, const stdType* in) const
+	{
+		const int n = static_cast<int>(nRows());
+		switch (preconditionerType)
+		{
+			case PreconditionerType::Jacobi:
+				for (int i = 0; i < n; ++i)
+					out[i] = inverseDiagonal[i] * in[i];
+				break;
+			case PreconditionerType::IncompleteLu:
+			{
+				// L * y = in, then U * out = y
+				const auto& offsets = incompleteFactors.Offsets();
+				for (int i = 0; i < n; ++i)
+				{
+					stdType y = in[i];
+					for (const int k : offsets)
+						if (k < 0 && i + k >= 0)
+							y -= incompleteFactors.Diagonal(k)[i] * out[i + k];
+					out[i] = y;
+				}
+				for (int i = n - 1; i >= 0; --i)
+				{
+					stdType y = out[i];
+					for (const int k : offsets)
+						if (k > 0 && i + k < n)
+							y -= incompleteFactors.Diagonal(k)[i] * out[i + k];
+					out[i] = y * inverseDiagonal[i];
+				}
+				break;
+			}
+			case PreconditionerType::Multigrid:
+				multigrid->Precondition(out, in);
+				break;
+			default:
+				std::copy(in, in + n, out);
+				break;
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <Exception.h>
+
+namespace pde
+{
+	/**
+	*	How the implicit systems of the host-side 2D schemes are solved
+	*/
+	enum class LinearSolverType
+	{
+		Null,
+
+		__BEGIN__,
+
+		/**
+		* Banded LU factorization, computed once: memory grows with the bandwidth, which is nRows in 2D
+		*/
+		BandedLu = __BEGIN__,
+
+		/**
+		* Conjugate gradient if the system is symmetric (pure diffusion) and the preconditioner isn't multigrid, BiCGSTAB otherwise: memory is linear in the number of grid points
+		*/
+		Krylov,
+
+		/**
+		* Geometric multigrid V-cycles, rediscretizing the operator on coarser grids: the number of cycles doesn't grow with the grid size
+		*/
+		Multigrid,
+
+		__END__
+	};
+
+	enum class PreconditionerType
+	{
+		Null,
+
+		__BEGIN__,
+
+		/**
+		* Reciprocal of the main diagonal
+		*/
+		Jacobi = __BEGIN__,
+
+		/**
+		* ILU(0): LU factorization restricted to the diagonals of the matrix, so that there's no fill-in
+		*/
+		IncompleteLu,
+
+		/**
+		* One multigrid V-cycle, which isn't symmetric, so that the iterations are BiCGSTAB: falls back to IncompleteLu if the implicit matrix isn't I - c * dt * L (e.g. RungeKuttaGaussLegendre4)
+		*/
+		Multigrid,
+
+		__END__
+	};
+
+	struct LinearSolverSettings
+	{
+		LinearSolverType solverType = LinearSolverType::BandedLu;
+
+		/**
+		* Krylov only: Null means no preconditioning
+		*/
+		PreconditionerType preconditionerType = PreconditionerType::IncompleteLu;
+
+		/**
+		* Krylov and Multigrid only: iterations stop when the residual norm is below tolerance times the right hand side norm.
+		* 0 for the default of the working precision, see Tolerance
+		*/
+		double tolerance = 0.0;
+		unsigned maxIterations = 1000;
+
+		/**
+		* tolerance, or a few hundred ulps if it's 0 (1e-12 in double precision): a fixed 1e-12 is out of reach in single precision
+		*/
+		template<typename stdType>
+		double Tolerance() const noexcept
+		{
+			return tolerance > 0.0 ? tolerance : std::max(1e-12, 100.0 * static_cast<double>(std::numeric_limits<stdType>::epsilon()));
+		}
+	};
+
+	/**
+	* Thrown by the implicit steps when the Krylov or multigrid iterations don't reach the tolerance within maxIterations
+	*/
+	class LinearSolverNotConvergedException : public Exception
+	{
+	public:
+		LinearSolverNotConvergedException(const std::string& message = "")
+			: Exception("LinearSolverNotConvergedException: " + message)
+		{
+		}
+	};
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <Types.h>
+#include <FiniteDifferenceTypes.h>
+#include <Exception.h>
+
+namespace pde
+{
+	/**
+	*	Bytes a solver allocates before its first step, buffer by buffer
+	*/
+	struct MemoryPlan
+	{
+		/**
+		* One column per step of the scheme
+		*/
+		size_t solution = 0;
+
+		/**
+		* Wave equation only
+		*/
+		size_t solutionDerivative = 0;
+
+		/**
+		* Dense representation only: the operator L, dimension^2
+		*/
+		size_t spaceDiscretizer = 0;
+
+		/**
+		* Dense representation only: dimension^2 per step of the scheme, plus the starter propagator that fills the history of multi-step schemes
+		*/
+		size_t timeDiscretizers = 0;
+
+		/**
+		* Dense representation of the wave equation only: the buffers AdvanceImpl ping-pongs between
+		*/
+		size_t workspace = 0;
+
+		/**
+		* Dense one-step schemes only: the propagator power and the two matrices it's squared with, built by the first Advance(n) when the policy allows it
+		*/
+		size_t propagatorPower = 0;
+
+		size_t Total() const noexcept { return solution + solutionDerivative + spaceDiscretizer + timeDiscretizers + workspace + propagatorPower; }
+	};
+
+	class MemoryBudgetExceededException : public Exception
+	{
+	public:
+		MemoryBudgetExceededException(const std::string& message = "")
+			: Exception("MemoryBudgetExceededException: " + message)
+		{
+		}
+	};
+
+	/**
+	* Static estimate, for a grid of nRows x nCols points (nCols = 1 in 1D).
+	* The compact representations (banded, sparse, matrix-free, ...) store a few diagonals of the operators, which are neglected here
+	*/
+	inline MemoryPlan PlanMemory(const unsigned nRows, const unsigned nCols, const SolverType solverType, const MathDomain mathDomain, const bool hasSolutionDerivative, const bool isDense);
+
+	inline size_t GetElementSize(const MathDomain mathDomain) noexcept;
+}
+
+#include <MemoryPlanner.tpp>
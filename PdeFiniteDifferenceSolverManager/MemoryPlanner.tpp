@@ -0,0 +1,50 @@
+#pragma once
+
+#include <MemoryPlanner.h>
+
+namespace pde
+{
+	inline size_t GetElementSize(const MathDomain mathDomain) noexcept
+	{
+		switch (mathDomain)
+		{
+			case MathDomain::Double:
+				return sizeof(double);
+			case MathDomain::Float:
+				return sizeof(float);
+			case MathDomain::Int:
+				return sizeof(int);
+			default:
+				return 0;
+		}
+	}
+
+	inline MemoryPlan PlanMemory(const unsigned nRows, const unsigned nCols, const SolverType solverType, const MathDomain mathDomain, const bool hasSolutionDerivative, const bool isDense)
+	{
+		// size_t from the start: dimension^2 overflows 32 bits on a 256 x 256 grid
+		const size_t elementSize = GetElementSize(mathDomain);
+		const size_t dimension = static_cast<size_t>(nRows) * nCols;
+		const size_t nSteps = getNumberOfSteps(solverType);
+
+		MemoryPlan plan;
+		plan.solution = dimension * nSteps * elementSize;
+		if (hasSolutionDerivative)
+			plan.solutionDerivative = plan.solution;
+
+		if (!isDense)
+			return plan;
+
+		const size_t operatorSize = dimension * dimension * elementSize;
+		plan.spaceDiscretizer = operatorSize;
+		plan.timeDiscretizers = nSteps * operatorSize;
+		if (nSteps > 1)
+			plan.timeDiscretizers += operatorSize;
+		else if (!hasSolutionDerivative)
+			plan.propagatorPower = 3 * operatorSize;
+
+		if (hasSolutionDerivative)
+			plan.workspace = 3 * plan.solution;
+
+		return plan;
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <SparseDiagonalMatrix.h>
+#include <BandedLuFactorization.h>
+#include <LinearSolverSettings.h>
+
+namespace pde
+{
+	/**
+	*	I - c * dt * L discretized on one grid of the multigrid hierarchy, flattened column-major as the finest one
+	*/
+	template<typename stdType>
+	struct MultigridLevel
+	{
+		SparseDiagonalMatrix<stdType> matrix;
+
+		unsigned nRows = 0;
+		unsigned nCols = 0;
+
+		/**
+		* Coarse levels only: index, on the next finer grid, of each of the rows (columns) of this grid. Both ends are always kept
+		*/
+		std::vector<unsigned> fineRows;
+		std::vector<unsigned> fineCols;
+	};
+
+	/**
+	*	Geometric multigrid V-cycle for the implicit systems of the 2D schemes, with red-black Gauss-Seidel smoothing,
+	*	bilinear prolongation, full weighting restriction and a banded LU on the coarsest grid.
+	*	The operator is rediscretized on every grid rather than built by Galerkin products, so that each level keeps the five-point stencil of the finest one.
+	*	Boundary rows have no off-diagonal entries, and they're solved exactly by the smoother.
+	*/
+	template<typename stdType>
+	class MultigridSolver
+	{
+	public:
+		MultigridSolver(std::vector<MultigridLevel<stdType>> levels, const LinearSolverSettings& settings);
+
+		virtual ~MultigridSolver() noexcept = default;
+		MultigridSolver(const MultigridSolver& rhs) = default;
+		MultigridSolver(MultigridSolver&& rhs) noexcept = default;
+		MultigridSolver& operator=(const MultigridSolver& rhs) = default;
+		MultigridSolver& operator=(MultigridSolver&& rhs) noexcept = default;
+
+		unsigned nRows() const noexcept { return levels.front().matrix.nRows(); }
+		unsigned nLevels() const noexcept { return static_cast<unsigned>(levels.size()); }
+
+		/**
+		* V-cycles taken by the last Solve
+		*/
+		unsigned lastIterations() const noexcept { return _lastIterations; }
+
+		/**
+		* x = A^{-1} * x, cycling from initialGuess if given, or from x otherwise.
+		* Returns false if the tolerance wasn't reached within the maximum number of cycles
+		*/
+		bool Solve(stdType* x, const stdType* initialGuess = nullptr) const;
+
+		/**
+		* out ~= A^{-1} * in with a single V-cycle from 0. The pre- and post-smoothing sweep the colours in opposite order, but the normalized restriction
+		* isn't a multiple of the transposed prolongation, so that this isn't a symmetric preconditioner even for symmetric A: KrylovSolver pairs it with BiCGSTAB
+		*/
+		void Precondition(stdType* out, const stdType* in) const;
+
+	private:
+		/**
+		* Gauss-Seidel sweeps before and after each coarse grid correction
+		*/
+		static constexpr unsigned smoothingSteps = 2;
+
+		void Cycle(const size_t level, stdType* x, const stdType* rhs) const;
+
+		/**
+		* One red-black Gauss-Seidel sweep, starting from the points with even (odd) i + j if firstColour is 0 (1)
+		*/
+		void Smooth(const size_t level, stdType* x, const stdType* rhs, const unsigned firstColour) const;
+
+		/**
+		* residual of level into the right hand side of level + 1, and correction of level + 1 added onto x of level
+		*/
+		void Restrict(const size_t level, stdType* coarseRhs, const stdType* residual) const;
+		void Prolongate(const size_t level, stdType* x, const stdType* coarseCorrection) const;
+
+		std::vector<MultigridLevel<stdType>> levels;
+		LinearSolverSettings settings;
+		std::shared_ptr<BandedLuFactorization<stdType>> coarseFactorization;
+
+		/**
+		* Restriction only: 1 / sum of the prolongation weights of each coarse row (column), so that the restriction of a constant is the same constant
+		*/
+		std::vector<std::vector<stdType>> rowNormalization;
+		std::vector<std::vector<stdType>> colNormalization;
+
+		mutable unsigned _lastIterations = 0;
+
+		/**
+		* Smoothing only: offsets of the off-diagonals of each level matrix, and room for their pointers
+		*/
+		std::vector<std::vector<int>> offDiagonalOffsets;
+		mutable std::vector<std::vector<const stdType*>> offDiagonals;
+
+		/**
+		* Workspace, allocated once per level
+		*/
+		mutable std::vector<std::vector<stdType>> solutions;
+		mutable std::vector<std::vector<stdType>> rightHandSides;
+		mutable std::vector<std::vector<stdType>> residuals;
+		mutable std::vector<stdType> transferBuffer;
+	};
+}
+
+#include <MultigridSolver.tpp>
@@ -0,0 +1,306 @@
+#pragma once
+
+#include <MultigridSolver.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace pde
+{
+	template<typename stdType>
+	MultigridSolver<stdType>::MultigridSolver(std::vector<MultigridLevel<stdType>> levels, const LinearSolverSettings& settings)
+		: levels(std::move(levels)), settings(settings)
+	{
+		assert(!this->levels.empty());
+
+		const size_t nLevels = this->levels.size();
+		coarseFactorization = std::make_shared<BandedLuFactorization<stdType>>(this->levels.back().matrix.ToBanded());
+
+		// sum of the bilinear weights of each coarse line: 1 for itself, plus the linear ones of the fine lines in between its neighbours
+		auto makeNormalization = [](const std::vector<unsigned>& fineLines)
+		{
+			std::vector<stdType> normalization(fineLines.size(), stdType(1.0));
+			for (size_t c = 0; c + 1 < fineLines.size(); ++c)
+			{
+				const unsigned f0 = fineLines[c];
+				const unsigned f1 = fineLines[c + 1];
+				for (unsigned f = f0 + 1; f < f1; ++f)
+				{
+					const stdType w = static_cast<stdType>(f - f0) / static_cast<stdType>(f1 - f0);
+					normalization[c] += stdType(1.0) - w;
+					normalization[c + 1] += w;
+				}
+			}
+			for (auto& x : normalization)
+				x = stdType(1.0) / x;
+
+			return normalization;
+		};
+
+		rowNormalization.resize(nLevels);
+		colNormalization.resize(nLevels);
+		offDiagonalOffsets.resize(nLevels);
+		offDiagonals.resize(nLevels);
+		solutions.resize(nLevels);
+		rightHandSides.resize(nLevels);
+		residuals.resize(nLevels);
+		size_t transferSize = 0;
+		for (size_t l = 0; l < nLevels; ++l)
+		{
+			const auto& level = this->levels[l];
+			assert(level.matrix.nRows() == level.nRows * level.nCols);
+
+			for (const int k : level.matrix.Offsets())
+				if (k != 0)
+					offDiagonalOffsets[l].push_back(k);
+			offDiagonals[l].resize(offDiagonalOffsets[l].size());
+
+			rightHandSides[l].resize(level.matrix.nRows());
+			residuals[l].resize(level.matrix.nRows());
+			if (l == 0)
+				continue;
+
+			assert(level.fineRows.size() == level.nRows && level.fineCols.size() == level.nCols);
+			solutions[l].resize(level.matrix.nRows());
+			rowNormalization[l] = makeNormalization(level.fineRows);
+			colNormalization[l] = makeNormalization(level.fineCols);
+
+			// fine rows times coarse columns
+			transferSize = std::max(transferSize, static_cast<size_t>(this->levels[l - 1].nRows) * level.nCols);
+		}
+		transferBuffer.resize(transferSize);
+	}
+
+	template<typename stdType>
+	bool MultigridSolver<stdType>::Solve(stdType* x, const stdType* initialGuess) const
+	{
+		const size_t n = nRows();
+		auto& b = rightHandSides[0];
+		auto& r = residuals[0];
+		std::copy(x, x + n, b.begin());
+		if (initialGuess && initialGuess != x)
+			std::copy(initialGuess, initialGuess + n, x);
+
+		double rhsNorm = 0.0;
+		for (size_t i = 0; i < n; ++i)
+			rhsNorm += static_cast<double>(b[i]) * b[i];
+		const double threshold = settings.Tolerance<stdType>() * std::sqrt(rhsNorm);
+
+		for (unsigned iteration = 0; ; ++iteration)
+		{
+			// r = b - A * x
+			levels[0].matrix.Dot(r.data(), x);
+			double residualNorm = 0.0;
+			for (size_t i = 0; i < n; ++i)
+			{
+				r[i] = b[i] - r[i];
+				residualNorm += static_cast<double>(r[i]) * r[i];
+			}
+
+			_lastIterations = iteration;
+			if (std::sqrt(residualNorm) <= threshold)
+				return true;
+			if (iteration == settings.maxIterations)
+				return false;
+
+			Cycle(0, x, b.data());
+		}
+	}
+
+	template<typename stdType>
+	void MultigridSolver<stdType>::Precondition(stdType* out, const stdType* in) const
+	{
+		std::fill(out, out + nRows(), stdType(0.0));
+		Cycle(0, out, in);
+	}
+
+	template<typename stdType>
+	void MultigridSolver<stdType>::Cycle(const size_t level, stdType* x, const stdType* rhs) const
+	{
+		if (level + 1 == levels.size())
+		{
+			std::copy(rhs, rhs + levels[level].matrix.nRows(), x);
+			coarseFactorization->Solve(x);
+			return;
+		}
+
+		for (unsigned s = 0; s < smoothingSteps; ++s)
+			Smooth(level, x, rhs, 0);
+
+		// coarse grid correction from the restricted residual
+		auto& r = residuals[level];
+		levels[level].matrix.Dot(r.data(), x);
+		for (size_t i = 0; i < r.size(); ++i)
+			r[i] = rhs[i] - r[i];
+
+		auto& coarseSolution = solutions[level + 1];
+		Restrict(level, rightHandSides[level + 1].data(), r.data());
+		std::fill(coarseSolution.begin(), coarseSolution.end(), stdType(0.0));
+		Cycle(level + 1, coarseSolution.data(), rightHandSides[level + 1].data());
+		Prolongate(level, x, coarseSolution.data());
+
+		for (unsigned s = 0; s < smoothingSteps; ++s)
+			Smooth(level, x, rhs, 1);
+	}
+
+	template<typename stdType>
+	void MultigridSolver<stdType>::Smooth(const size_t level, stdType* x, const stdType* rhs, const unsigned firstColour) const
+	{
+		const auto& matrix = levels[level].matrix;
+		const int nRows = static_cast<int>(levels[level].nRows);
+		const int nCols = static_cast<int>(levels[level].nCols);
+		const int n = nRows * nCols;
+
+		// the pointers are looked up on every call rather than stored, so that a copy of the solver doesn't read the diagonals of the original
+		const auto& offsets = offDiagonalOffsets[level];
+		auto& diagonals = offDiagonals[level];
+		for (size_t a = 0; a < offsets.size(); ++a)
+			diagonals[a] = matrix.Diagonal(offsets[a]);
+		const stdType* mainDiagonal = matrix.Diagonal(0);
+
+		// with a five-point stencil the points of one colour only depend on the other colour, so that each half sweep is a Jacobi update
+		for (unsigned colour = 0; colour < 2; ++colour)
+		{
+			for (int j = 0; j < nCols; ++j)
+			{
+				for (int i = (j + firstColour + colour) & 1; i < nRows; i += 2)
+				{
+					const int k = i + j * nRows;
+					stdType sum = rhs[k];
+					for (size_t a = 0; a < offsets.size(); ++a)
+					{
+						const int neighbour = k + offsets[a];
+						if (neighbour >= 0 && neighbour < n)
+							sum -= diagonals[a][k] * x[neighbour];
+					}
+					x[k] = sum / mainDiagonal[k];
+				}
+			}
+		}
+	}
+
+	template<typename stdType>
+	void MultigridSolver<stdType>::Restrict(const size_t level, stdType* coarseRhs, const stdType* residual) const
+	{
+		const auto& coarse = levels[level + 1];
+		const size_t nFineRows = levels[level].nRows;
+		const size_t nRows = coarse.nRows;
+		const size_t nCols = coarse.nCols;
+		const auto& fineRows = coarse.fineRows;
+		const auto& fineCols = coarse.fineCols;
+
+		// transpose of the y interpolation: fine rows, coarse columns
+		auto addColumn = [&](stdType* out, const unsigned fineCol, const stdType w)
+		{
+			const stdType* in = residual + fineCol * nFineRows;
+			for (size_t i = 0; i < nFineRows; ++i)
+				out[i] += w * in[i];
+		};
+		std::fill(transferBuffer.begin(), transferBuffer.begin() + nFineRows * nCols, stdType(0.0));
+		for (size_t J = 0; J < nCols; ++J)
+		{
+			stdType* out = transferBuffer.data() + J * nFineRows;
+			addColumn(out, fineCols[J], stdType(1.0));
+			if (J > 0)
+			{
+				const unsigned f0 = fineCols[J - 1], f1 = fineCols[J];
+				for (unsigned f = f0 + 1; f < f1; ++f)
+					addColumn(out, f, static_cast<stdType>(f - f0) / static_cast<stdType>(f1 - f0));
+			}
+			if (J + 1 < nCols)
+			{
+				const unsigned f0 = fineCols[J], f1 = fineCols[J + 1];
+				for (unsigned f = f0 + 1; f < f1; ++f)
+					addColumn(out, f, static_cast<stdType>(f1 - f) / static_cast<stdType>(f1 - f0));
+			}
+		}
+
+		// transpose of the x interpolation, normalized into a weighted average
+		for (size_t J = 0; J < nCols; ++J)
+		{
+			const stdType* in = transferBuffer.data() + J * nFineRows;
+			stdType* out = coarseRhs + J * nRows;
+			for (size_t I = 0; I < nRows; ++I)
+			{
+				stdType sum = in[fineRows[I]];
+				if (I > 0)
+				{
+					const unsigned f0 = fineRows[I - 1], f1 = fineRows[I];
+					for (unsigned f = f0 + 1; f < f1; ++f)
+						sum += static_cast<stdType>(f - f0) / static_cast<stdType>(f1 - f0) * in[f];
+				}
+				if (I + 1 < nRows)
+				{
+					const unsigned f0 = fineRows[I], f1 = fineRows[I + 1];
+					for (unsigned f = f0 + 1; f < f1; ++f)
+						sum += static_cast<stdType>(f1 - f) / static_cast<stdType>(f1 - f0) * in[f];
+				}
+				out[I] = sum * rowNormalization[level + 1][I] * colNormalization[level + 1][J];
+			}
+		}
+
+		// boundary rows are decoupled: their residual is injected
+		for (size_t J = 0; J < nCols; ++J)
+		{
+			coarseRhs[J * nRows] = residual[fineRows.front() + fineCols[J] * nFineRows];
+			coarseRhs[nRows - 1 + J * nRows] = residual[fineRows.back() + fineCols[J] * nFineRows];
+		}
+		for (size_t I = 0; I < nRows; ++I)
+		{
+			coarseRhs[I] = residual[fineRows[I] + fineCols.front() * nFineRows];
+			coarseRhs[I + (nCols - 1) * nRows] = residual[fineRows[I] + fineCols.back() * nFineRows];
+		}
+	}
+
+	template<typename stdType>
+	void MultigridSolver<stdType>::Prolongate(const size_t level, stdType* x, const stdType* coarseCorrection) const
+	{
+		const auto& coarse = levels[level + 1];
+		const size_t nFineRows = levels[level].nRows;
+		const size_t nRows = coarse.nRows;
+		const size_t nCols = coarse.nCols;
+		const auto& fineRows = coarse.fineRows;
+		const auto& fineCols = coarse.fineCols;
+
+		// x interpolation of each coarse column: fine rows, coarse columns
+		for (size_t J = 0; J < nCols; ++J)
+		{
+			const stdType* in = coarseCorrection + J * nRows;
+			stdType* out = transferBuffer.data() + J * nFineRows;
+			for (size_t I = 0; I < nRows; ++I)
+			{
+				out[fineRows[I]] = in[I];
+				if (I + 1 == nRows)
+					continue;
+
+				const unsigned f0 = fineRows[I], f1 = fineRows[I + 1];
+				for (unsigned f = f0 + 1; f < f1; ++f)
+				{
+					const stdType w = static_cast<stdType>(f - f0) / static_cast<stdType>(f1 - f0);
+					out[f] = (stdType(1.0) - w) * in[I] + w * in[I + 1];
+				}
+			}
+		}
+
+		// y interpolation, added onto x
+		for (size_t J = 0; J < nCols; ++J)
+		{
+			const stdType* left = transferBuffer.data() + J * nFineRows;
+			stdType* out = x + fineCols[J] * nFineRows;
+			for (size_t i = 0; i < nFineRows; ++i)
+				out[i] += left[i];
+			if (J + 1 == nCols)
+				continue;
+
+			const stdType* right = left + nFineRows;
+			const unsigned f0 = fineCols[J], f1 = fineCols[J + 1];
+			for (unsigned f = f0 + 1; f < f1; ++f)
+			{
+				const stdType w = static_cast<stdType>(f - f0) / static_cast<stdType>(f1 - f0);
+				out = x + f * nFineRows;
+				for (size_t i = 0; i < nFineRows; ++i)
+					out[i] += (stdType(1.0) - w) * left[i] + w * right[i];
+			}
+		}
+	}
+}
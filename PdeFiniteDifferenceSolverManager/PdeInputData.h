@@ -4,9 +4,51 @@
 #include <ColumnWiseMatrix.h>
 #include <Tensor.h>
 #include <FiniteDifferenceTypes.h>
+#include <ExtendedSolverType.h>
+#include <LinearSolverSettings.h>
+#include <PropagatorPowerCache.h>
+#include <EmbeddedRungeKutta.h>
+#include <InputViews.h>
 
 namespace pde
 {
+	/**
+	*	Optional knobs of the host-side schemes, shared by the 1D and 2D input data: the defaults leave the device solverType path unchanged
+	*/
+	struct PdeSolverSettings
+	{
+		/**
+		* Host-side scheme, used instead of solverType when the solver supports it
+		*/
+		ExtendedSolverType extendedSolverType = ExtendedSolverType::Null;
+
+		/**
+		* Host-side implicit 2D schemes only: banded factorization, Krylov or multigrid iterations
+		*/
+		LinearSolverSettings linearSolverSettings = LinearSolverSettings();
+
+		/**
+		* Dense one-step schemes only: whether Advance(n) goes through the cached n-th power of the propagator
+		*/
+		PropagatorPowerPolicy propagatorPowerPolicy = PropagatorPowerPolicy::Null;
+
+		/**
+		* Adaptive schemes only (BogackiShampine32, DormandPrince54): error tolerances of the step size control
+		*/
+		AdaptiveStepSettings adaptiveStepSettings = AdaptiveStepSettings();
+
+		/**
+		* Multi-step schemes only: if not 0, the history is filled with this many RungeKutta4 sub-steps per level instead of one CrankNicolson step
+		*/
+		unsigned bootstrapSubSteps = 0;
+
+		/**
+		* Dense representations only: bytes the solver may allocate, see MemoryPlan. Past them the propagator power cache is dropped first, and then the solver throws.
+		* 0 for no limit
+		*/
+		size_t memoryBudget = 0;
+	};
+
 	/**
 	*	Supports up to 3D input data.
 	*/
@@ -31,14 +73,38 @@ namespace pde
 		*/
 		const SpaceDiscretizerType spaceDiscretizerType;
 
+		/**
+		* Host-side scheme, memory budget and the other optional knobs, see PdeSolverSettings
+		*/
+		const PdeSolverSettings settings = PdeSolverSettings();
+
 		PdeInputData(const cl::Tensor<memorySpace, mathDomain>& initialCondition,
 					 const double dt,
 					 const SolverType solverType,
-					 const SpaceDiscretizerType spaceDiscretizerType)
+					 const SpaceDiscretizerType spaceDiscretizerType,
+					 const PdeSolverSettings& settings = PdeSolverSettings())
 			: initialCondition(initialCondition),
 			dt(dt),
 			solverType(solverType),
-			spaceDiscretizerType(spaceDiscretizerType)
+			spaceDiscretizerType(spaceDiscretizerType),
+			settings(settings)
+		{
+		}
+
+		/**
+		* initialCondition wraps the memory of the view instead of copying it, see InputViews.h.
+		* Throws InputViewMismatchException if the view memory space or math domain differs from this
+		*/
+		PdeInputData(const MemoryCube& initialCondition,
+					 const double dt,
+					 const SolverType solverType,
+					 const SpaceDiscretizerType spaceDiscretizerType,
+					 const PdeSolverSettings& settings = PdeSolverSettings())
+			: initialCondition(detail::CheckView<memorySpace, mathDomain>(initialCondition, "initialCondition")),
+			dt(dt),
+			solverType(solverType),
+			spaceDiscretizerType(spaceDiscretizerType),
+			settings(settings)
 		{
 		}
 
@@ -36,11 +36,13 @@ namespace pde
 					   const double dt,
 					   const SolverType solverType,
 					   const SpaceDiscretizerType spaceDiscretizerType,
-					   const BoundaryCondition1D boundaryConditions = BoundaryCondition1D())
+					   const BoundaryCondition1D boundaryConditions = BoundaryCondition1D(),
+					   const PdeSolverSettings& settings = PdeSolverSettings())
 			: PdeInputData(initialCondition,
 						   dt,
 						   solverType,
-						   spaceDiscretizerType),
+						   spaceDiscretizerType,
+						   settings),
 			velocity(velocity),
 			spaceGrid(spaceGrid),
 			diffusion(diffusion),
@@ -55,18 +57,45 @@ namespace pde
 					   const double dt,
 					   const SolverType solverType,
 					   const SpaceDiscretizerType spaceDiscretizerType,
-					   const BoundaryCondition1D boundaryConditions = BoundaryCondition1D())
+					   const BoundaryCondition1D boundaryConditions = BoundaryCondition1D(),
+					   const PdeSolverSettings& settings = PdeSolverSettings())
 			:
 			PdeInputData(initialCondition,
 						 dt,
 						 solverType,
-						 spaceDiscretizerType),
+						 spaceDiscretizerType,
+						 settings),
 			velocity(cl::Vector<memorySpace, mathDomain>(initialCondition.size(), velocity)),
 			spaceGrid(spaceGrid),
 			diffusion(cl::Vector<memorySpace, mathDomain>(initialCondition.size(), diffusion)),
 			boundaryConditions(boundaryConditions)
 		{
 		}
+
+		/**
+		* Zero-copy input: the initial condition, the grid and the coefficients wrap the memory of the views, see InputViews.h.
+		* Throws InputViewMismatchException if a view memory space or math domain differs from this
+		*/
+		PdeInputData1D(const MemoryBuffer& initialCondition,
+					   const MemoryBuffer& spaceGrid,
+					   const MemoryBuffer& velocity,
+					   const MemoryBuffer& diffusion,
+					   const double dt,
+					   const SolverType solverType,
+					   const SpaceDiscretizerType spaceDiscretizerType,
+					   const BoundaryCondition1D boundaryConditions = BoundaryCondition1D(),
+					   const PdeSolverSettings& settings = PdeSolverSettings())
+			: PdeInputData(detail::MakeCubeView(initialCondition),
+						   dt,
+						   solverType,
+						   spaceDiscretizerType,
+						   settings),
+			velocity(detail::CheckView<memorySpace, mathDomain>(velocity, "velocity")),
+			spaceGrid(detail::CheckView<memorySpace, mathDomain>(spaceGrid, "spaceGrid")),
+			diffusion(detail::CheckView<memorySpace, mathDomain>(diffusion, "diffusion")),
+			boundaryConditions(boundaryConditions)
+		{
+		}
 	};
 
 #pragma region Type aliases
@@ -40,11 +40,13 @@ namespace pde
 					   const double dt,
 					   const SolverType solverType,
 					   const SpaceDiscretizerType spaceDiscretizerType,
-					   const BoundaryCondition2D boundaryConditions = BoundaryCondition2D())
+					   const BoundaryCondition2D boundaryConditions = BoundaryCondition2D(),
+					   const PdeSolverSettings& settings = PdeSolverSettings())
 			: PdeInputData(initialCondition,
 						   dt,
 						   solverType,
-						   spaceDiscretizerType),
+						   spaceDiscretizerType,
+						   settings),
 			xSpaceGrid(xSpaceGrid),
 			ySpaceGrid(ySpaceGrid),
 			diffusion(diffusion.Flatten()),
@@ -61,11 +63,13 @@ namespace pde
 					   const double dt,
 					   const SolverType solverType,
 					   const SpaceDiscretizerType spaceDiscretizerType,
-					   const BoundaryCondition2D boundaryConditions = BoundaryCondition2D())
+					   const BoundaryCondition2D boundaryConditions = BoundaryCondition2D(),
+					   const PdeSolverSettings& settings = PdeSolverSettings())
 			: PdeInputData(initialCondition,
 						   dt,
 						   solverType,
-						   spaceDiscretizerType),
+						   spaceDiscretizerType,
+						   settings),
 			xSpaceGrid(xSpaceGrid),
 			ySpaceGrid(ySpaceGrid),
 			xVelocity(cl::Vector<memorySpace, mathDomain>(initialCondition.nRows(), xVelocity)),
@@ -74,6 +78,36 @@ namespace pde
 			boundaryConditions(boundaryConditions)
 		{
 		}
+
+		/**
+		* Zero-copy input: the initial condition, the grids and the coefficients wrap the memory of the views, see InputViews.h.
+		* diffusion is read as its flattened vector directly, without the Flatten() copy.
+		* Throws InputViewMismatchException if a view memory space or math domain differs from this
+		*/
+		PdeInputData2D(const MemoryTile& initialCondition,
+					   const MemoryBuffer& xSpaceGrid,
+					   const MemoryBuffer& ySpaceGrid,
+					   const MemoryBuffer& xVelocity,
+					   const MemoryBuffer& yVelocity,
+					   const MemoryTile& diffusion,
+					   const double dt,
+					   const SolverType solverType,
+					   const SpaceDiscretizerType spaceDiscretizerType,
+					   const BoundaryCondition2D boundaryConditions = BoundaryCondition2D(),
+					   const PdeSolverSettings& settings = PdeSolverSettings())
+			: PdeInputData(detail::MakeCubeView(initialCondition),
+						   dt,
+						   solverType,
+						   spaceDiscretizerType,
+						   settings),
+			xSpaceGrid(detail::CheckView<memorySpace, mathDomain>(xSpaceGrid, "xSpaceGrid")),
+			ySpaceGrid(detail::CheckView<memorySpace, mathDomain>(ySpaceGrid, "ySpaceGrid")),
+			xVelocity(detail::CheckView<memorySpace, mathDomain>(xVelocity, "xVelocity")),
+			yVelocity(detail::CheckView<memorySpace, mathDomain>(yVelocity, "yVelocity")),
+			diffusion(detail::MakeFlatView(detail::CheckView<memorySpace, mathDomain>(diffusion, "diffusion"))),
+			boundaryConditions(boundaryConditions)
+		{
+		}
 	};
 
 #pragma region Type aliases
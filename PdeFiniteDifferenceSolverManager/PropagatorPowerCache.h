@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <Vector.h>
+#include <ColumnWiseMatrix.h>
+#include <Types.h>
+
+namespace pde
+{
+	/**
+	*	Whether the dense one-step solvers replace Advance(n) by a single product with the n-th power of the propagator.
+	*	The power costs three more dimension x dimension matrices, which is why it's opt-in
+	*/
+	enum class PropagatorPowerPolicy
+	{
+		/**
+		* Always iterate step by step: the default
+		*/
+		Null,
+
+		__BEGIN__,
+
+		/**
+		* Build the power once the steps iterated with the same n have cost as much as building it
+		*/
+		CostModel = __BEGIN__,
+
+		/**
+		* Build the power on the first call
+		*/
+		Always,
+
+		__END__
+	};
+
+	/**
+	*	n-th power of the affine step u -> B(A * u) = P * u + c of the dense solvers, where B sets the boundary conditions.
+	*	P and c are read off the step itself, as c = B(0) and P * e_j = B(A * e_j) - c, and then raised to the n-th power by repeated squaring:
+	*	this is O(N^3 * log(n)) once, after which each Advance(n) is a single O(N^2) product instead of n of them.
+	*	The power is cached for the last n only, as the solvers are typically advanced by the same number of steps between two snapshots.
+	*/
+	template<MemorySpace memorySpace = MemorySpace::Device, MathDomain mathDomain = MathDomain::Float>
+	class PropagatorPowerCache
+	{
+	public:
+		explicit PropagatorPowerCache(const PropagatorPowerPolicy policy = PropagatorPowerPolicy::Null);
+
+		virtual ~PropagatorPowerCache() noexcept = default;
+		PropagatorPowerCache(const PropagatorPowerCache& rhs) = default;
+		PropagatorPowerCache(PropagatorPowerCache&& rhs) noexcept = default;
+		PropagatorPowerCache& operator=(const PropagatorPowerCache& rhs) = default;
+		PropagatorPowerCache& operator=(PropagatorPowerCache&& rhs) noexcept = default;
+
+		/**
+		* Advances the single column solution by nSteps with the cached power, building it first if the policy says so.
+		* Returns false, leaving solution untouched, if the caller has to iterate instead.
+		* setBoundaryConditions(cl::Vector&) applies B to a single grid function
+		*/
+		template<class boundaryConditionSetter>
+		bool Advance(cl::ColumnWiseMatrix<memorySpace, mathDomain>& solution, const cl::ColumnWiseMatrix<memorySpace, mathDomain>& propagator, const unsigned nSteps, const boundaryConditionSetter& setBoundaryConditions);
+
+		bool HasPower() const noexcept { return power != nullptr; }
+		bool HasPower(const unsigned nSteps) const noexcept { return power != nullptr && this->nSteps == nSteps; }
+
+		bool IsEnabled() const noexcept { return policy != PropagatorPowerPolicy::Null; }
+
+		/**
+		* Matrix products needed for the nSteps-th power: one per squaring, plus one per further set bit of nSteps
+		*/
+		static unsigned GetMatrixProductCount(const unsigned nSteps) noexcept;
+
+	private:
+		template<class boundaryConditionSetter>
+		void Build(const cl::ColumnWiseMatrix<memorySpace, mathDomain>& propagator, const unsigned nSteps, const boundaryConditionSetter& setBoundaryConditions);
+
+		PropagatorPowerPolicy policy;
+
+		/**
+		* Steps of the cached power, and what iterating them has cost so far, in multiply-adds
+		*/
+		unsigned nSteps = 0;
+		double iterationCost = 0.0;
+
+		/**
+		* P^n and (P^{n - 1} + ... + I) * c
+		*/
+		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> power;
+		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> offset;
+		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> buffer;
+	};
+}
+
+#include <PropagatorPowerCache.tpp>
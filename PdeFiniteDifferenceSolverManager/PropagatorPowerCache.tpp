@@ -0,0 +1,125 @@
+#pragma once
+
+#include <PropagatorPowerCache.h>
+
+namespace pde
+{
+	template<MemorySpace ms, MathDomain md>
+	PropagatorPowerCache<ms, md>::PropagatorPowerCache(const PropagatorPowerPolicy policy)
+		: policy(policy)
+	{
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	template<class boundaryConditionSetter>
+	bool PropagatorPowerCache<ms, md>::Advance(cl::ColumnWiseMatrix<ms, md>& solution, const cl::ColumnWiseMatrix<ms, md>& propagator, const unsigned nSteps, const boundaryConditionSetter& setBoundaryConditions)
+	{
+		// multi-step schemes carry a history that the power of a single propagator doesn't advance
+		if (policy == PropagatorPowerPolicy::Null || solution.nCols() != 1 || nSteps == 0)
+			return false;
+
+		if (nSteps != this->nSteps)
+		{
+			this->nSteps = nSteps;
+			iterationCost = 0.0;
+			power.reset();
+			offset.reset();
+		}
+
+		if (!power)
+		{
+			const double n = propagator.nRows();
+			const double stepsCost = nSteps * n * n;
+			const double buildCost = GetMatrixProductCount(nSteps) * n * n * n;
+
+			// rent or buy: building only once iterating has cost as much means never paying more than twice the best choice in hindsight
+			if (policy == PropagatorPowerPolicy::CostModel && (nSteps == 1 || iterationCost + stepsCost < buildCost))
+			{
+				iterationCost += stepsCost;
+				return false;
+			}
+
+			Build(propagator, nSteps, setBoundaryConditions);
+		}
+
+		// u_{n + nSteps} = P^n * u_n + (P^{n - 1} + ... + I) * c
+		cl::Multiply(*buffer, *power, solution);
+		buffer->AddEqual(*offset);
+		solution.ReadFrom(*buffer);
+
+		return true;
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	unsigned PropagatorPowerCache<ms, md>::GetMatrixProductCount(const unsigned nSteps) noexcept
+	{
+		unsigned nProducts = 0;
+		bool hasPower = false;
+		for (unsigned m = nSteps; m > 0; m >>= 1)
+		{
+			if (m & 1)
+			{
+				nProducts += hasPower ? 1 : 0;
+				hasPower = true;
+			}
+			if (m > 1)
+				++nProducts;
+		}
+
+		return nProducts;
+	}
+
+	template<MemorySpace ms, MathDomain md>
+	template<class boundaryConditionSetter>
+	void PropagatorPowerCache<ms, md>::Build(const cl::ColumnWiseMatrix<ms, md>& propagator, const unsigned nSteps, const boundaryConditionSetter& setBoundaryConditions)
+	{
+		const unsigned n = propagator.nRows();
+		using matrix = cl::ColumnWiseMatrix<ms, md>;
+
+		// c = B(0), and P * e_j = B(A * e_j) - c
+		auto basePower = std::make_shared<matrix>(propagator);
+		auto baseOffset = std::make_shared<matrix>(n, 1, 0.0);
+		setBoundaryConditions(*baseOffset->columns[0]);
+		for (unsigned j = 0; j < n; ++j)
+		{
+			setBoundaryConditions(*basePower->columns[j]);
+			basePower->columns[j]->AddEqual(*baseOffset->columns[0], -1.0);
+		}
+
+		// binary powering: (P1, c1) after (P2, c2) is (P1 * P2, P1 * c2 + c1), and all the powers of the step commute
+		auto powerBuffer = std::make_shared<matrix>(n, n, 0.0);
+		auto offsetBuffer = std::make_shared<matrix>(n, 1, 0.0);
+		auto compose = [&](std::shared_ptr<matrix>& outPower, std::shared_ptr<matrix>& outOffset)
+		{
+			// outPower and outOffset can be the base itself: the products go into the buffers first
+			cl::Multiply(*offsetBuffer, *basePower, *outOffset);
+			offsetBuffer->AddEqual(*baseOffset);
+			cl::Multiply(*powerBuffer, *basePower, *outPower);
+
+			std::swap(outOffset, offsetBuffer);
+			std::swap(outPower, powerBuffer);
+		};
+
+		power.reset();
+		offset.reset();
+		for (unsigned m = nSteps; m > 0; m >>= 1)
+		{
+			if (m & 1)
+			{
+				if (!power)
+				{
+					power = std::make_shared<matrix>(*basePower);
+					offset = std::make_shared<matrix>(*baseOffset);
+				}
+				else
+					compose(power, offset);
+			}
+
+			// squaring: the base composed with itself
+			if (m > 1)
+				compose(basePower, baseOffset);
+		}
+
+		buffer = std::make_shared<matrix>(n, 1, 0.0);
+	}
+}
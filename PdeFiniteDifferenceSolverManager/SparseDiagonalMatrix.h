@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <BandedMatrix.h>
+
+namespace pde
+{
+	/**
+	*	Square matrix stored as a list of diagonals with arbitrary offsets (DIA format): diagonal k holds the elements (i, i + k).
+	*	This is the natural format of the 2D stencils on a column-major flattened grid, whose neighbours live at offsets +-1 and +-nRows:
+	*	unlike BandedMatrix, the (mostly empty) diagonals in between are not stored, so memory scales with the number of grid points.
+	*/
+	template<typename stdType>
+	class SparseDiagonalMatrix
+	{
+	public:
+		explicit SparseDiagonalMatrix(const unsigned nRows = 0);
+
+		virtual ~SparseDiagonalMatrix() noexcept = default;
+		SparseDiagonalMatrix(const SparseDiagonalMatrix& rhs) = default;
+		SparseDiagonalMatrix(SparseDiagonalMatrix&& rhs) noexcept = default;
+		SparseDiagonalMatrix& operator=(const SparseDiagonalMatrix& rhs) = default;
+		SparseDiagonalMatrix& operator=(SparseDiagonalMatrix&& rhs) noexcept = default;
+
+		static SparseDiagonalMatrix Identity(const unsigned nRows);
+
+		unsigned nRows() const noexcept { return _nRows; }
+		unsigned nDiagonals() const noexcept { return static_cast<unsigned>(offsets.size()); }
+		unsigned lowerBandwidth() const noexcept { return offsets.empty() || offsets.front() > 0 ? 0 : static_cast<unsigned>(-offsets.front()); }
+		unsigned upperBandwidth() const noexcept { return offsets.empty() || offsets.back() < 0 ? 0 : static_cast<unsigned>(offsets.back()); }
+		bool periodic() const noexcept { return false; }
+
+		/**
+		* Sorted offsets of the stored diagonals
+		*/
+		const std::vector<int>& Offsets() const noexcept { return offsets; }
+
+		/**
+		* Pointer to the first element of the k-th diagonal, or nullptr if it's not stored
+		*/
+		const stdType* Diagonal(const int k) const noexcept;
+
+		/**
+		* Pointer to the first element of the k-th diagonal, which is added (zero filled) if it's not stored yet
+		*/
+		stdType* AddDiagonal(const int k);
+
+		void Scale(const stdType alpha);
+
+		/**
+		* this += alpha * I
+		*/
+		void AddIdentity(const stdType alpha = stdType(1.0));
+
+		/**
+		* this += alpha * rhs: the diagonals of rhs that are not stored yet are added
+		*/
+		void AddEqual(const SparseDiagonalMatrix& rhs, const stdType alpha = stdType(1.0));
+
+		/**
+		* out = alpha * this * in (+ beta * out): both vectors have size nRows
+		*/
+		void Dot(stdType* out, const stdType* in, const stdType alpha = stdType(1.0), const stdType beta = stdType(0.0)) const;
+
+		/**
+		* Same matrix with all the diagonals between the outermost ones, e.g. for a banded factorization
+		*/
+		BandedMatrix<stdType> ToBanded() const;
+
+		/**
+		* Number of stored elements: this is what the operator costs in memory and per matrix-vector product
+		*/
+		size_t size() const noexcept { return offsets.size() * _nRows; }
+
+	private:
+		unsigned _nRows;
+
+		std::vector<int> offsets;
+		std::vector<std::vector<stdType>> diagonals;
+	};
+
+	/**
+	* Sparse matrix-matrix product: the result offsets are the pairwise sums of the operands offsets
+	*/
+	template<typename stdType>
+	SparseDiagonalMatrix<stdType> Multiply(const SparseDiagonalMatrix<stdType>& lhs, const SparseDiagonalMatrix<stdType>& rhs, const stdType alpha = stdType(1.0));
+}
+
+#include <SparseDiagonalMatrix.tpp>
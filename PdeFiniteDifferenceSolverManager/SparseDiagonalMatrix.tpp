@@ -0,0 +1,142 @@
+#pragma once
+
+#include <SparseDiagonalMatrix.h>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+namespace pde
+{
+	template<typename stdType>
+	SparseDiagonalMatrix<stdType>::SparseDiagonalMatrix(const unsigned nRows)
+		: _nRows(nRows)
+	{
+	}
+
+	template<typename stdType>
+	SparseDiagonalMatrix<stdType> SparseDiagonalMatrix<stdType>::Identity(const unsigned nRows)
+	{
+		SparseDiagonalMatrix<stdType> ret(nRows);
+		ret.AddIdentity();
+		return ret;
+	}
+
+	template<typename stdType>
+	const stdType* SparseDiagonalMatrix<stdType>::Diagonal(const int k) const noexcept
+	{
+		const auto it = std::lower_bound(offsets.begin(), offsets.end(), k);
+		if (it == offsets.end() || *it != k)
+			return nullptr;
+
+		return diagonals[it - offsets.begin()].data();
+	}
+
+	template<typename stdType>
+	stdType* SparseDiagonalMatrix<stdType>::AddDiagonal(const int k)
+	{
+		assert(static_cast<unsigned>(std::abs(k)) < _nRows);
+
+		const auto it = std::lower_bound(offsets.begin(), offsets.end(), k);
+		const size_t position = it - offsets.begin();
+		if (it == offsets.end() || *it != k)
+		{
+			offsets.insert(it, k);
+			diagonals.insert(diagonals.begin() + position, std::vector<stdType>(_nRows, stdType(0.0)));
+		}
+
+		return diagonals[position].data();
+	}
+
+	template<typename stdType>
+	void SparseDiagonalMatrix<stdType>::Scale(const stdType alpha)
+	{
+		for (auto& diagonal : diagonals)
+			for (auto& x : diagonal)
+				x *= alpha;
+	}
+
+	template<typename stdType>
+	void SparseDiagonalMatrix<stdType>::AddIdentity(const stdType alpha)
+	{
+		stdType* mainDiagonal = AddDiagonal(0);
+		for (unsigned i = 0; i < _nRows; ++i)
+			mainDiagonal[i] += alpha;
+	}
+
+	template<typename stdType>
+	void SparseDiagonalMatrix<stdType>::AddEqual(const SparseDiagonalMatrix& rhs, const stdType alpha)
+	{
+		assert(rhs._nRows == _nRows);
+
+		for (size_t d = 0; d < rhs.offsets.size(); ++d)
+		{
+			stdType* lhsDiagonal = AddDiagonal(rhs.offsets[d]);
+			const stdType* rhsDiagonal = rhs.diagonals[d].data();
+			for (unsigned i = 0; i < _nRows; ++i)
+				lhsDiagonal[i] += alpha * rhsDiagonal[i];
+		}
+	}
+
+	template<typename stdType>
+	void SparseDiagonalMatrix<stdType>::Dot(stdType* out, const stdType* in, const stdType alpha, const stdType beta) const
+	{
+		if (beta == stdType(0.0))
+			std::fill(out, out + _nRows, stdType(0.0));
+		else if (beta != stdType(1.0))
+		{
+			for (unsigned i = 0; i < _nRows; ++i)
+				out[i] *= beta;
+		}
+
+		const int n = static_cast<int>(_nRows);
+		for (size_t d = 0; d < offsets.size(); ++d)
+		{
+			const int k = offsets[d];
+			const stdType* diagonal = diagonals[d].data();
+			const int begin = std::max(0, -k);
+			const int end = std::min(n, n - k);
+			for (int i = begin; i < end; ++i)
+				out[i] += alpha * diagonal[i] * in[i + k];
+		}
+	}
+
+	template<typename stdType>
+	BandedMatrix<stdType> SparseDiagonalMatrix<stdType>::ToBanded() const
+	{
+		BandedMatrix<stdType> ret(_nRows, lowerBandwidth(), upperBandwidth());
+		for (size_t d = 0; d < offsets.size(); ++d)
+			std::copy(diagonals[d].begin(), diagonals[d].end(), ret.Diagonal(offsets[d]));
+
+		return ret;
+	}
+
+	template<typename stdType>
+	SparseDiagonalMatrix<stdType> Multiply(const SparseDiagonalMatrix<stdType>& lhs, const SparseDiagonalMatrix<stdType>& rhs, const stdType alpha)
+	{
+		assert(lhs.nRows() == rhs.nRows());
+
+		const int n = static_cast<int>(lhs.nRows());
+		SparseDiagonalMatrix<stdType> ret(lhs.nRows());
+
+		// (lhs * rhs)(i, i + a + b) += lhs(i, i + a) * rhs(i + a, i + a + b)
+		for (const int a : lhs.Offsets())
+		{
+			const stdType* lhsDiagonal = lhs.Diagonal(a);
+			for (const int b : rhs.Offsets())
+			{
+				const int k = a + b;
+				if (k <= -n || k >= n)
+					continue;
+
+				const stdType* rhsDiagonal = rhs.Diagonal(b);
+				stdType* retDiagonal = ret.AddDiagonal(k);
+				const int begin = std::max(std::max(0, -a), -k);
+				const int end = std::min(std::min(n, n - a), n - k);
+				for (int i = begin; i < end; ++i)
+					retDiagonal[i] += alpha * lhsDiagonal[i] * rhsDiagonal[i + a];
+			}
+		}
+
+		return ret;
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+namespace pde
+{
+	/**
+	*	Exact time evolution of du/dt = L * u, for a space discretizer L that doesn't depend on time.
+	*	The boundary points are not evolved by L, but set from the interior ones by the affine map u = E * u_I + c, which is read off the boundary conditions.
+	*	On the interior this leaves du_I/dt = M * u_I + f, with M = L_I * E and f = L_I * c, and M = V * diag(lambda) * V^{-1} is diagonalized once:
+	*	u_I(t) = V * (e^{lambda * t} * V^{-1} * u_I(0) + t * phi(lambda * t) * V^{-1} * f), with phi(z) = (e^z - 1) / z,
+	*	so that any output time costs a single transform pair, and carries no time discretization error.
+	*	The eigendecomposition goes through a complex Schur form, as advection makes M non-symmetric, and is O(N^3).
+	*/
+	template<typename stdType>
+	class SpectralPropagator
+	{
+	public:
+		/**
+		* All matrices are N x N and column-major: spaceDiscretizer is L, boundaryPropagator is B(I) - B(0) and boundaryOffset is B(0),
+		* where B is the affine map that sets the boundary conditions on a grid function.
+		*/
+		SpectralPropagator(const std::vector<stdType>& spaceDiscretizer, const std::vector<stdType>& boundaryPropagator, const std::vector<stdType>& boundaryOffset);
+
+		virtual ~SpectralPropagator() noexcept = default;
+		SpectralPropagator(const SpectralPropagator& rhs) = default;
+		SpectralPropagator(SpectralPropagator&& rhs) noexcept = default;
+		SpectralPropagator& operator=(const SpectralPropagator& rhs) = default;
+		SpectralPropagator& operator=(SpectralPropagator&& rhs) noexcept = default;
+
+		/**
+		* False if M is defective, or too close to it for V^{-1} to be accurate (as with pure upwind transport), in which case the caller has to time step instead
+		*/
+		bool IsValid() const noexcept { return _isValid; }
+
+		/**
+		* Condition number of V in the 1-norm: the relative error of Evaluate is about this times the machine precision
+		*/
+		double GetConditionNumber() const noexcept { return conditionNumber; }
+
+		const std::vector<std::complex<double>>& Eigenvalues() const noexcept { return eigenvalues; }
+
+		/**
+		* out = u(t), starting from u(0) = in: only the interior points of in are read
+		*/
+		void Evaluate(stdType* out, const stdType* in, const double t) const;
+
+	private:
+		/**
+		* M = Z * T * Z^H, with T upper triangular, by Householder reduction to Hessenberg form and single shift QR sweeps
+		*/
+		static bool MakeSchurDecomposition(std::vector<std::complex<double>>& matrix, std::vector<std::complex<double>>& schurVectors, const size_t n);
+
+		/**
+		* inverse = matrix^{-1} by LU with partial pivoting. Returns false if matrix is singular
+		*/
+		static bool Invert(std::vector<std::complex<double>>& inverse, std::vector<std::complex<double>> matrix, const size_t n);
+
+		bool _isValid = false;
+		double conditionNumber = 0.0;
+
+		/**
+		* Grid points that L evolves, and the E and c rows of each of the others, as (interior index, weight) pairs
+		*/
+		std::vector<size_t> interiorPoints;
+		std::vector<size_t> boundaryPoints;
+		std::vector<std::vector<std::pair<size_t, double>>> boundaryWeights;
+		std::vector<double> boundaryValues;
+
+		std::vector<std::complex<double>> eigenvalues;
+		std::vector<std::complex<double>> eigenvectors;
+		std::vector<std::complex<double>> inverseEigenvectors;
+
+		/**
+		* V^{-1} * f
+		*/
+		std::vector<std::complex<double>> modalForcing;
+
+		mutable std::vector<std::complex<double>> modes;
+		mutable std::vector<std::complex<double>> work;
+	};
+}
+
+#include <SpectralPropagator.tpp>
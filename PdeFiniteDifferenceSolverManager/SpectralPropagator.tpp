@@ -0,0 +1,409 @@
+#pragma once
+
+#include <SpectralPropagator.h>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace pde
+{
+	template<typename stdType>
+	SpectralPropagator<stdType>::SpectralPropagator(const std::vector<stdType>& spaceDiscretizer, const std::vector<stdType>& boundaryPropagator, const std::vector<stdType>& boundaryOffset)
+	{
+		const size_t N = boundaryOffset.size();
+		assert(spaceDiscretizer.size() == N * N && boundaryPropagator.size() == N * N);
+
+		// B leaves the interior points untouched, and overwrites the boundary ones from the interior
+		std::vector<size_t> interiorIndex(N, N);
+		for (size_t i = 0; i < N; ++i)
+		{
+			if (boundaryPropagator[i + i * N] == stdType(1.0))
+			{
+				interiorIndex[i] = interiorPoints.size();
+				interiorPoints.push_back(i);
+			}
+			else
+				boundaryPoints.push_back(i);
+		}
+
+		const size_t n = interiorPoints.size();
+		if (n == 0)
+			return;
+
+		boundaryWeights.resize(boundaryPoints.size());
+		boundaryValues.resize(boundaryPoints.size());
+		for (size_t b = 0; b < boundaryPoints.size(); ++b)
+		{
+			for (size_t a = 0; a < n; ++a)
+			{
+				const stdType weight = boundaryPropagator[boundaryPoints[b] + interiorPoints[a] * N];
+				if (weight != stdType(0.0))
+					boundaryWeights[b].emplace_back(a, static_cast<double>(weight));
+			}
+			boundaryValues[b] = static_cast<double>(boundaryOffset[boundaryPoints[b]]);
+		}
+
+		// M = L_I * E and f = L_I * c: the interior columns of L, plus the boundary ones through E
+		std::vector<std::complex<double>> schurForm(n * n);
+		modalForcing.assign(n, 0.0);
+		for (size_t a = 0; a < n; ++a)
+		{
+			for (size_t c = 0; c < n; ++c)
+				schurForm[a + c * n] = static_cast<double>(spaceDiscretizer[interiorPoints[a] + interiorPoints[c] * N]);
+
+			for (size_t b = 0; b < boundaryPoints.size(); ++b)
+			{
+				const double coupling = static_cast<double>(spaceDiscretizer[interiorPoints[a] + boundaryPoints[b] * N]);
+				if (coupling == 0.0)
+					continue;
+
+				for (const auto& weight : boundaryWeights[b])
+					schurForm[a + weight.first * n] += coupling * weight.second;
+				modalForcing[a] += coupling * boundaryValues[b];
+			}
+		}
+
+		std::vector<std::complex<double>> schurVectors;
+		if (!MakeSchurDecomposition(schurForm, schurVectors, n))
+			return;
+
+		// eigenvectors of T by back substitution, where close eigenvalues are perturbed apart
+		double normT = 0.0;
+		for (const auto& x : schurForm)
+			normT = std::max(normT, std::abs(x));
+		const double smallNumber = std::max(normT, 1.0) * std::numeric_limits<double>::epsilon();
+
+		eigenvalues.resize(n);
+		std::vector<std::complex<double>> triangularEigenvectors(n * n, 0.0);
+		for (size_t k = 0; k < n; ++k)
+		{
+			eigenvalues[k] = schurForm[k + k * n];
+
+			std::complex<double>* y = triangularEigenvectors.data() + k * n;
+			y[k] = 1.0;
+			for (size_t i = k; i-- > 0;)
+			{
+				std::complex<double> sum = 0.0;
+				for (size_t j = i + 1; j <= k; ++j)
+					sum += schurForm[i + j * n] * y[j];
+
+				std::complex<double> denominator = schurForm[i + i * n] - eigenvalues[k];
+				if (std::abs(denominator) < smallNumber)
+					denominator = smallNumber;
+				y[i] = -sum / denominator;
+			}
+		}
+
+		// V = Z * Y, with unit columns
+		eigenvectors.assign(n * n, 0.0);
+		for (size_t k = 0; k < n; ++k)
+		{
+			std::complex<double>* v = eigenvectors.data() + k * n;
+			for (size_t j = 0; j <= k; ++j)
+			{
+				const std::complex<double> y = triangularEigenvectors[j + k * n];
+				for (size_t i = 0; i < n; ++i)
+					v[i] += schurVectors[i + j * n] * y;
+			}
+
+			double norm = 0.0;
+			for (size_t i = 0; i < n; ++i)
+				norm += std::norm(v[i]);
+			norm = std::sqrt(norm);
+			for (size_t i = 0; i < n; ++i)
+				v[i] /= norm;
+		}
+
+		if (!Invert(inverseEigenvectors, eigenvectors, n))
+			return;
+
+		const auto getNorm1 = [n](const std::vector<std::complex<double>>& matrix)
+		{
+			double norm = 0.0;
+			for (size_t j = 0; j < n; ++j)
+			{
+				double columnNorm = 0.0;
+				for (size_t i = 0; i < n; ++i)
+					columnNorm += std::abs(matrix[i + j * n]);
+				norm = std::max(norm, columnNorm);
+			}
+
+			return norm;
+		};
+		conditionNumber = getNorm1(eigenvectors) * getNorm1(inverseEigenvectors);
+
+		// past this, the modes lose more than half of the digits
+		_isValid = conditionNumber * std::sqrt(std::numeric_limits<double>::epsilon()) < 1.0;
+
+		work.resize(n);
+		modes.resize(n);
+		for (size_t k = 0; k < n; ++k)
+		{
+			modes[k] = 0.0;
+			for (size_t a = 0; a < n; ++a)
+				modes[k] += inverseEigenvectors[k + a * n] * modalForcing[a];
+		}
+		modalForcing.swap(modes);
+	}
+
+	template<typename stdType>
+	void SpectralPropagator<stdType>::Evaluate(stdType* out, const stdType* in, const double t) const
+	{
+		assert(_isValid);
+		const size_t n = interiorPoints.size();
+
+		// in and out can be the same: the interior is copied first
+		for (size_t a = 0; a < n; ++a)
+			work[a] = static_cast<double>(in[interiorPoints[a]]);
+
+		for (size_t k = 0; k < n; ++k)
+		{
+			std::complex<double> mode = 0.0;
+			for (size_t a = 0; a < n; ++a)
+				mode += inverseEigenvectors[k + a * n] * work[a];
+
+			// e^z * w + t * phi(z) * f, where phi(z) = (e^z - 1) / z is expanded around 0 to avoid cancellation
+			const std::complex<double> z = eigenvalues[k] * t;
+			const std::complex<double> exponential = std::exp(z);
+			const std::complex<double> phi = std::abs(z) < 1e-5 ? 1.0 + z * (.5 + z / 6.0) : (exponential - 1.0) / z;
+			modes[k] = exponential * mode + t * phi * modalForcing[k];
+		}
+
+		for (size_t a = 0; a < n; ++a)
+		{
+			std::complex<double> u = 0.0;
+			for (size_t k = 0; k < n; ++k)
+				u += eigenvectors[a + k * n] * modes[k];
+
+			// M is real, so that the imaginary parts of the complex conjugate modes cancel out
+			out[interiorPoints[a]] = static_cast<stdType>(u.real());
+		}
+
+		for (size_t b = 0; b < boundaryPoints.size(); ++b)
+		{
+			double u = boundaryValues[b];
+			for (const auto& weight : boundaryWeights[b])
+				u += weight.second * static_cast<double>(out[interiorPoints[weight.first]]);
+			out[boundaryPoints[b]] = static_cast<stdType>(u);
+		}
+	}
+
+	template<typename stdType>
+	bool SpectralPropagator<stdType>::MakeSchurDecomposition(std::vector<std::complex<double>>& matrix, std::vector<std::complex<double>>& schurVectors, const size_t n)
+	{
+		typedef std::complex<double> complex;
+		auto H = [&matrix, n](const size_t i, const size_t j) -> complex& { return matrix[i + j * n]; };
+
+		schurVectors.assign(n * n, 0.0);
+		for (size_t i = 0; i < n; ++i)
+			schurVectors[i + i * n] = 1.0;
+
+		// Householder reduction to upper Hessenberg form: P = I - 2 * v * v^H / |v|^2 zeroes the column k below the subdiagonal
+		std::vector<complex> v(n);
+		for (size_t k = 0; k + 2 < n; ++k)
+		{
+			double norm = 0.0;
+			for (size_t i = k + 1; i < n; ++i)
+				norm += std::norm(H(i, k));
+			norm = std::sqrt(norm);
+			if (norm == 0.0)
+				continue;
+
+			const complex x0 = H(k + 1, k);
+			const complex alpha = -(std::abs(x0) > 0.0 ? x0 / std::abs(x0) : complex(1.0)) * norm;
+			double vNorm = 0.0;
+			for (size_t i = k + 1; i < n; ++i)
+			{
+				v[i] = H(i, k) - (i == k + 1 ? alpha : complex(0.0));
+				vNorm += std::norm(v[i]);
+			}
+			if (vNorm == 0.0)
+				continue;
+
+			// H = P * H * P, Z = Z * P
+			for (size_t j = k; j < n; ++j)
+			{
+				complex s = 0.0;
+				for (size_t i = k + 1; i < n; ++i)
+					s += std::conj(v[i]) * H(i, j);
+				s *= 2.0 / vNorm;
+				for (size_t i = k + 1; i < n; ++i)
+					H(i, j) -= s * v[i];
+			}
+			for (auto* target : { &matrix, &schurVectors })
+			{
+				auto& A = *target;
+				for (size_t i = 0; i < n; ++i)
+				{
+					complex s = 0.0;
+					for (size_t j = k + 1; j < n; ++j)
+						s += A[i + j * n] * v[j];
+					s *= 2.0 / vNorm;
+					for (size_t j = k + 1; j < n; ++j)
+						A[i + j * n] -= s * std::conj(v[j]);
+				}
+			}
+		}
+
+		double norm = 0.0;
+		for (const auto& x : matrix)
+			norm = std::max(norm, std::abs(x));
+		const double epsilon = std::numeric_limits<double>::epsilon();
+
+		// single shift QR sweeps on the active block [low, high], deflating from the bottom
+		size_t high = n - 1;
+		unsigned iterations = 0;
+		const unsigned maxIterations = 30 * static_cast<unsigned>(n);
+		unsigned totalIterations = 0;
+		while (high > 0)
+		{
+			size_t low = high;
+			for (; low > 0; --low)
+			{
+				double scale = std::abs(H(low - 1, low - 1)) + std::abs(H(low, low));
+				if (scale == 0.0)
+					scale = norm;
+				if (std::abs(H(low, low - 1)) <= epsilon * scale)
+				{
+					H(low, low - 1) = 0.0;
+					break;
+				}
+			}
+			if (low == high)
+			{
+				--high;
+				iterations = 0;
+				continue;
+			}
+			if (++totalIterations > maxIterations)
+				return false;
+
+			// Wilkinson shift: the eigenvalue of the trailing 2 x 2 block closer to its last entry, and an exceptional one if that stagnates
+			complex shift;
+			if (++iterations % 10 == 0)
+				shift = H(high, high) + std::abs(H(high, high - 1));
+			else
+			{
+				const complex a = H(high - 1, high - 1), b = H(high - 1, high), c = H(high, high - 1), d = H(high, high);
+				const complex halfDifference = .5 * (a - d);
+				const complex root = std::sqrt(halfDifference * halfDifference + b * c);
+				const complex first = d - b * c / (halfDifference + root);
+				const complex second = d - b * c / (halfDifference - root);
+				const bool firstIsFinite = std::abs(halfDifference + root) > 0.0;
+				const bool secondIsFinite = std::abs(halfDifference - root) > 0.0;
+				if (firstIsFinite && (!secondIsFinite || std::abs(first - d) <= std::abs(second - d)))
+					shift = first;
+				else if (secondIsFinite)
+					shift = second;
+				else
+					shift = d;
+			}
+
+			// implicit bulge chase, with Givens rotations G = [c, s; -conj(s), c] applied as H = G * H * G^H
+			complex x = H(low, low) - shift;
+			complex y = H(low + 1, low);
+			for (size_t k = low; k < high; ++k)
+			{
+				if (k > low)
+				{
+					x = H(k, k - 1);
+					y = H(k + 1, k - 1);
+				}
+
+				const double r = std::sqrt(std::norm(x) + std::norm(y));
+				if (r == 0.0)
+					continue;
+				const complex phase = std::abs(x) > 0.0 ? x / std::abs(x) : complex(1.0);
+				const double c = std::abs(x) / r;
+				const complex s = phase * std::conj(y) / r;
+
+				for (size_t j = (k > low ? k - 1 : low); j < n; ++j)
+				{
+					const complex first = H(k, j), second = H(k + 1, j);
+					H(k, j) = c * first + s * second;
+					H(k + 1, j) = -std::conj(s) * first + c * second;
+				}
+				if (k > low)
+					H(k + 1, k - 1) = 0.0;
+
+				const size_t lastRow = std::min(k + 2, high);
+				for (size_t i = 0; i <= lastRow; ++i)
+				{
+					const complex first = H(i, k), second = H(i, k + 1);
+					H(i, k) = first * c + second * std::conj(s);
+					H(i, k + 1) = -first * s + second * c;
+				}
+				for (size_t i = 0; i < n; ++i)
+				{
+					complex& first = schurVectors[i + k * n];
+					complex& second = schurVectors[i + (k + 1) * n];
+					const complex _first = first;
+					first = _first * c + second * std::conj(s);
+					second = -_first * s + second * c;
+				}
+			}
+		}
+
+		// what's left below the diagonal is rounding
+		for (size_t j = 0; j < n; ++j)
+			for (size_t i = j + 1; i < n; ++i)
+				H(i, j) = 0.0;
+
+		return true;
+	}
+
+	template<typename stdType>
+	bool SpectralPropagator<stdType>::Invert(std::vector<std::complex<double>>& inverse, std::vector<std::complex<double>> matrix, const size_t n)
+	{
+		std::vector<size_t> pivots(n);
+		for (size_t k = 0; k < n; ++k)
+		{
+			size_t pivot = k;
+			for (size_t i = k + 1; i < n; ++i)
+				if (std::abs(matrix[i + k * n]) > std::abs(matrix[pivot + k * n]))
+					pivot = i;
+			if (matrix[pivot + k * n] == 0.0)
+				return false;
+
+			pivots[k] = pivot;
+			if (pivot != k)
+				for (size_t j = 0; j < n; ++j)
+					std::swap(matrix[k + j * n], matrix[pivot + j * n]);
+
+			for (size_t i = k + 1; i < n; ++i)
+				matrix[i + k * n] /= matrix[k + k * n];
+			for (size_t j = k + 1; j < n; ++j)
+			{
+				const std::complex<double> u = matrix[k + j * n];
+				if (u == 0.0)
+					continue;
+				for (size_t i = k + 1; i < n; ++i)
+					matrix[i + j * n] -= matrix[i + k * n] * u;
+			}
+		}
+
+		// P * A = L * U, then A^{-1} = U^{-1} * L^{-1} * P one column at a time
+		inverse.assign(n * n, 0.0);
+		for (size_t j = 0; j < n; ++j)
+		{
+			std::complex<double>* x = inverse.data() + j * n;
+			x[j] = 1.0;
+			for (size_t k = 0; k < n; ++k)
+				if (pivots[k] != k)
+					std::swap(x[k], x[pivots[k]]);
+
+			for (size_t k = 0; k < n; ++k)
+				for (size_t i = k + 1; i < n; ++i)
+					x[i] -= matrix[i + k * n] * x[k];
+			for (size_t k = n; k-- > 0;)
+			{
+				x[k] /= matrix[k + k * n];
+				for (size_t i = 0; i < k; ++i)
+					x[i] -= matrix[i + k * n] * x[k];
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <complex>
+
+namespace pde
+{
+	/**
+	*	Orthonormal eigenbasis of the n x n symmetric tridiagonal Toeplitz matrices (sine modes), or of the symmetric tridiagonal circulant ones if periodic (real Fourier modes).
+	*	The transform runs through an FFT of length 2 * (n + 1) for the sine modes and n for the Fourier ones, in O(n * log(n)) for any n:
+	*	radix-2 when the length is a power of 2, and Bluestein's chirp convolution, through a radix-2 FFT of at least twice the length, otherwise.
+	*/
+	template<typename stdType>
+	class SpectralTransform
+	{
+	public:
+		explicit SpectralTransform(const unsigned n = 0, const bool periodic = false);
+
+		virtual ~SpectralTransform() noexcept = default;
+		SpectralTransform(const SpectralTransform& rhs) = default;
+		SpectralTransform(SpectralTransform&& rhs) noexcept = default;
+		SpectralTransform& operator=(const SpectralTransform& rhs) = default;
+		SpectralTransform& operator=(SpectralTransform&& rhs) noexcept = default;
+
+		unsigned size() const noexcept { return static_cast<unsigned>(cosines.size()); }
+		bool periodic() const noexcept { return _periodic; }
+
+		/**
+		* cos(theta_k) for the k-th mode: the matrix with main diagonal a and off-diagonals b has eigenvalue a + 2 * b * cos(theta_k)
+		*/
+		const std::vector<stdType>& Cosines() const noexcept { return cosines; }
+
+		/**
+		* x = Q^T * x and x = Q * x respectively, where Q holds the modes by column
+		*/
+		void Forward(stdType* x) const;
+		void Backward(stdType* x) const;
+
+	private:
+		/**
+		* In place FFT of work, with e^{-2 pi i j k / N} (or e^{+2 pi i j k / N} if inverse) and no normalization
+		*/
+		void Fft(const bool inverse) const;
+
+		/**
+		* In place radix-2 FFT of data, whose size is that of twiddles times 2
+		*/
+		void Radix2Fft(std::vector<std::complex<double>>& data, const bool inverse) const;
+
+		bool _periodic;
+
+		std::vector<stdType> cosines;
+
+		/**
+		* e^{-2 pi i k / M} for k < M / 2, with M the radix-2 length: N itself, or the Bluestein convolution length
+		*/
+		std::vector<std::complex<double>> twiddles;
+
+		/**
+		* Bluestein only: e^{-pi i j^2 / N} for j < N, and the radix-2 FFT of its conjugate wrapped around the convolution length
+		*/
+		std::vector<std::complex<double>> chirp;
+		std::vector<std::complex<double>> chirpSpectrum;
+
+		mutable std::vector<std::complex<double>> work;
+
+		/**
+		* Bluestein only: the convolution buffer
+		*/
+		mutable std::vector<std::complex<double>> convolution;
+	};
+}
+
+#include <SpectralTransform.tpp>
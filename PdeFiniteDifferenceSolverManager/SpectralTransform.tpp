@@ -0,0 +1,194 @@
+#pragma once
+
+#include <SpectralTransform.h>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace pde
+{
+	namespace detail
+	{
+		inline bool IsPowerOfTwo(const size_t n) noexcept
+		{
+			return n > 0 && (n & (n - 1)) == 0;
+		}
+	}
+
+	template<typename stdType>
+	SpectralTransform<stdType>::SpectralTransform(const unsigned n, const bool periodic)
+		: _periodic(periodic), cosines(n)
+	{
+		const double pi = 3.14159265358979323846;
+
+		// Q(j, k): sqrt(2 / (n + 1)) * sin(pi * (j + 1) * (k + 1) / (n + 1)) for the sine modes;
+		// 1 / sqrt(n), then sqrt(2 / n) * cos(2 * pi * q * j / n) and sqrt(2 / n) * sin(2 * pi * q * j / n) for q = 1, 2, ..., then (-1)^j / sqrt(n) if n is even for the Fourier ones
+		const auto angle = [&](const unsigned k)
+		{
+			return periodic ? 2.0 * pi * ((k + 1) / 2) / n : pi * (k + 1) / (n + 1.0);
+		};
+		for (unsigned k = 0; k < n; ++k)
+			cosines[k] = static_cast<stdType>(std::cos(angle(k)));
+
+		const size_t fftSize = periodic ? n : 2 * (n + 1);
+		work.resize(fftSize);
+		if (fftSize == 0)
+			return;
+
+		size_t radix2Size = fftSize;
+		if (!detail::IsPowerOfTwo(fftSize))
+		{
+			// the chirp convolution has 2 * N - 1 non-zero lags, which must not wrap around onto each other
+			radix2Size = 1;
+			while (radix2Size < 2 * fftSize - 1)
+				radix2Size <<= 1;
+		}
+
+		twiddles.resize(radix2Size / 2);
+		for (size_t k = 0; k < twiddles.size(); ++k)
+			twiddles[k] = std::polar(1.0, -2.0 * pi * k / radix2Size);
+		if (radix2Size == fftSize)
+			return;
+
+		// j * k = (j^2 + k^2 - (k - j)^2) / 2: the phase of j^2 is taken modulo 2 * N, so that it stays exact for large j
+		chirp.resize(fftSize);
+		for (size_t j = 0; j < fftSize; ++j)
+			chirp[j] = std::polar(1.0, -pi * static_cast<double>((j * j) % (2 * fftSize)) / fftSize);
+
+		chirpSpectrum.assign(radix2Size, 0.0);
+		chirpSpectrum[0] = std::conj(chirp[0]);
+		for (size_t j = 1; j < fftSize; ++j)
+			chirpSpectrum[j] = chirpSpectrum[radix2Size - j] = std::conj(chirp[j]);
+		Radix2Fft(chirpSpectrum, false);
+
+		convolution.resize(radix2Size);
+	}
+
+	template<typename stdType>
+	void SpectralTransform<stdType>::Forward(stdType* x) const
+	{
+		const size_t n = cosines.size();
+		if (!_periodic)
+		{
+			// odd extension (0, x, 0, -reversed x): its FFT is -2i times the sine transform
+			const size_t m = work.size();
+			work[0] = work[n + 1] = 0.0;
+			for (size_t j = 0; j < n; ++j)
+			{
+				work[j + 1] = x[j];
+				work[m - 1 - j] = -static_cast<double>(x[j]);
+			}
+			Fft(false);
+
+			const double scale = -.5 * std::sqrt(2.0 / (n + 1));
+			for (size_t k = 0; k < n; ++k)
+				x[k] = static_cast<stdType>(scale * work[k + 1].imag());
+			return;
+		}
+
+		for (size_t j = 0; j < n; ++j)
+			work[j] = x[j];
+		Fft(false);
+
+		// sum_j x_j * cos(theta * j) = Re(X_q) and sum_j x_j * sin(theta * j) = -Im(X_q)
+		const double scale = std::sqrt(2.0 / n);
+		x[0] = static_cast<stdType>(work[0].real() / std::sqrt(static_cast<double>(n)));
+		for (size_t q = 1; 2 * q < n; ++q)
+		{
+			x[2 * q - 1] = static_cast<stdType>(scale * work[q].real());
+			x[2 * q] = static_cast<stdType>(-scale * work[q].imag());
+		}
+		if (n % 2 == 0 && n > 1)
+			x[n - 1] = static_cast<stdType>(work[n / 2].real() / std::sqrt(static_cast<double>(n)));
+	}
+
+	template<typename stdType>
+	void SpectralTransform<stdType>::Backward(stdType* x) const
+	{
+		const size_t n = cosines.size();
+
+		// the sine modes matrix is symmetric and orthogonal
+		if (!_periodic)
+		{
+			Forward(x);
+			return;
+		}
+
+		// Hermitian spectrum Z such that x_j = Re(sum_q Z_q * e^{2 pi i q j / n}) / n
+		const double scale = std::sqrt(.5 * n);
+		std::fill(work.begin(), work.end(), 0.0);
+		work[0] = std::sqrt(static_cast<double>(n)) * x[0];
+		for (size_t q = 1; 2 * q < n; ++q)
+		{
+			work[q] = scale * std::complex<double>(x[2 * q - 1], -static_cast<double>(x[2 * q]));
+			work[n - q] = std::conj(work[q]);
+		}
+		if (n % 2 == 0 && n > 1)
+			work[n / 2] = std::sqrt(static_cast<double>(n)) * x[n - 1];
+		Fft(true);
+
+		for (size_t j = 0; j < n; ++j)
+			x[j] = static_cast<stdType>(work[j].real() / n);
+	}
+
+	template<typename stdType>
+	void SpectralTransform<stdType>::Fft(const bool inverse) const
+	{
+		if (chirp.empty())
+		{
+			Radix2Fft(work, inverse);
+			return;
+		}
+
+		// Bluestein: X_k = w_k * sum_j (x_j * w_j) * conj(w_{k - j}), with w_j = e^{-pi i j^2 / N}, and the inverse is conjugated throughout
+		const size_t n = work.size();
+		std::fill(convolution.begin() + n, convolution.end(), 0.0);
+		for (size_t j = 0; j < n; ++j)
+			convolution[j] = (inverse ? std::conj(work[j]) : work[j]) * chirp[j];
+		Radix2Fft(convolution, false);
+		for (size_t k = 0; k < convolution.size(); ++k)
+			convolution[k] *= chirpSpectrum[k];
+		Radix2Fft(convolution, true);
+
+		const double scale = 1.0 / convolution.size();
+		for (size_t k = 0; k < n; ++k)
+		{
+			const std::complex<double> coefficient = scale * convolution[k] * chirp[k];
+			work[k] = inverse ? std::conj(coefficient) : coefficient;
+		}
+	}
+
+	template<typename stdType>
+	void SpectralTransform<stdType>::Radix2Fft(std::vector<std::complex<double>>& data, const bool inverse) const
+	{
+		const size_t n = data.size();
+
+		// bit reversal permutation
+		for (size_t i = 1, j = 0; i < n; ++i)
+		{
+			size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+
+			if (i < j)
+				std::swap(data[i], data[j]);
+		}
+
+		for (size_t length = 2; length <= n; length <<= 1)
+		{
+			const size_t stride = n / length;
+			for (size_t start = 0; start < n; start += length)
+			{
+				for (size_t k = 0; k < length / 2; ++k)
+				{
+					const std::complex<double> twiddle = inverse ? std::conj(twiddles[k * stride]) : twiddles[k * stride];
+					const std::complex<double> even = data[start + k];
+					const std::complex<double> odd = twiddle * data[start + k + length / 2];
+					data[start + k] = even + odd;
+					data[start + k + length / 2] = even - odd;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+#include <BandedFiniteDifferenceManager.h>
+
+namespace pde
+{
+	/**
+	*	Pre-flight check of a solver, before any time stepping
+	*/
+	struct StabilityReport
+	{
+		/**
+		* Spectral radius of the propagator that Advance applies, boundary conditions and multi-step history included, estimated by power iterations.
+		* NaN for the schemes with a state of their own (IMEX splittings, higher order multi-step schemes), which are then reported as unstable
+		*/
+		double spectralRadius = 0.0;
+
+		/**
+		* Whether spectralRadius is at most 1, up to the accuracy of the estimate
+		*/
+		bool isStable = true;
+
+		/**
+		* Largest dt for which the amplification factor of the solver type is at most 1 on the Gershgorin discs of the space discretizer:
+		* infinity if the scheme is unconditionally stable there, 0 if no dt is, and NaN if the scheme has no known amplification factor (e.g. IMEX splittings).
+		* As the discs contain the whole spectrum, this is a conservative bound
+		*/
+		double largestStableDt = 0.0;
+	};
+
+	namespace detail
+	{
+		/**
+		* Disc of the complex plane centered on the real axis, which contains some eigenvalues of a real matrix
+		*/
+		struct GershgorinDisc
+		{
+			double center;
+			double radius;
+		};
+
+		/**
+		* One disc per distinct row: on a uniform grid with constant coefficients only a handful are left
+		*/
+		template<typename stdType>
+		std::vector<GershgorinDisc> MakeGershgorinDiscs(const BandedMatrix<stdType>& matrix);
+
+		template<typename stdType>
+		std::vector<GershgorinDisc> MakeGershgorinDiscs(const SparseDiagonalMatrix<stdType>& matrix);
+
+		/**
+		* matrix is dense, column-major and nRows x nRows
+		*/
+		template<typename stdType>
+		std::vector<GershgorinDisc> MakeGershgorinDiscs(const std::vector<stdType>& matrix, const unsigned nRows);
+
+		/**
+		* Largest modulus of the roots xi of the characteristic polynomial of solverType on y' = lambda * y, with z = lambda * dt:
+		* for one-step schemes this is |R(z)|. Negative if solverType has no known amplification factor
+		*/
+		inline double GetAmplificationFactor(const SolverType solverType, const std::complex<double> z);
+
+		/**
+		* Bisection on dt, starting from dt: see StabilityReport::largestStableDt
+		*/
+		inline double FindLargestStableDt(const std::vector<GershgorinDisc>& discs, const SolverType solverType, const double dt);
+	}
+}
+
+#include <StabilityAnalysis.tpp>
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <StabilityAnalysis.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace pde
+{
+	namespace detail
+	{
+		/**
+		* Sorts discs and drops the duplicates, up to rounding
+		*/
+		inline void MakeUniqueGershgorinDiscs(std::vector<GershgorinDisc>& discs)
+		{
+			const auto isLess = [](const GershgorinDisc& lhs, const GershgorinDisc& rhs)
+			{
+				return lhs.center < rhs.center || (lhs.center == rhs.center && lhs.radius < rhs.radius);
+			};
+			const auto isEqual = [](const GershgorinDisc& lhs, const GershgorinDisc& rhs)
+			{
+				const double tolerance = 1e-12 * (std::abs(lhs.center) + lhs.radius + std::abs(rhs.center) + rhs.radius);
+				return std::abs(lhs.center - rhs.center) <= tolerance && std::abs(lhs.radius - rhs.radius) <= tolerance;
+			};
+
+			std::sort(discs.begin(), discs.end(), isLess);
+			discs.erase(std::unique(discs.begin(), discs.end(), isEqual), discs.end());
+		}
+
+		template<typename stdType>
+		std::vector<GershgorinDisc> MakeGershgorinDiscs(const BandedMatrix<stdType>& matrix)
+		{
+			const int n = static_cast<int>(matrix.nRows());
+
+			std::vector<GershgorinDisc> discs(n, GershgorinDisc{ 0.0, 0.0 });
+			for (int k = -static_cast<int>(matrix.lowerBandwidth()); k <= static_cast<int>(matrix.upperBandwidth()); ++k)
+			{
+				const stdType* diagonal = matrix.Diagonal(k);
+				for (int i = 0; i < n; ++i)
+				{
+					// periodic diagonals wrap around, otherwise the entries outside the matrix are never read
+					if (!matrix.periodic() && (i + k < 0 || i + k >= n))
+						continue;
+
+					if (k == 0)
+						discs[i].center += diagonal[i];
+					else
+						discs[i].radius += std::abs(static_cast<double>(diagonal[i]));
+				}
+			}
+
+			MakeUniqueGershgorinDiscs(discs);
+			return discs;
+		}
+
+		template<typename stdType>
+		std::vector<GershgorinDisc> MakeGershgorinDiscs(const SparseDiagonalMatrix<stdType>& matrix)
+		{
+			const int n = static_cast<int>(matrix.nRows());
+
+			std::vector<GershgorinDisc> discs(n, GershgorinDisc{ 0.0, 0.0 });
+			for (const int k : matrix.Offsets())
+			{
+				const stdType* diagonal = matrix.Diagonal(k);
+				for (int i = std::max(0, -k); i < std::min(n, n - k); ++i)
+				{
+					if (k == 0)
+						discs[i].center += diagonal[i];
+					else
+						discs[i].radius += std::abs(static_cast<double>(diagonal[i]));
+				}
+			}
+
+			MakeUniqueGershgorinDiscs(discs);
+			return discs;
+		}
+
+		template<typename stdType>
+		std::vector<GershgorinDisc> MakeGershgorinDiscs(const std::vector<stdType>& matrix, const unsigned nRows)
+		{
+			std::vector<GershgorinDisc> discs(nRows, GershgorinDisc{ 0.0, 0.0 });
+			for (unsigned j = 0; j < nRows; ++j)
+			{
+				for (unsigned i = 0; i < nRows; ++i)
+				{
+					if (i == j)
+						discs[i].center = matrix[i + j * nRows];
+					else
+						discs[i].radius += std::abs(static_cast<double>(matrix[i + j * nRows]));
+				}
+			}
+
+			MakeUniqueGershgorinDiscs(discs);
+			return discs;
+		}
+
+		inline double GetAmplificationFactor(const SolverType solverType, const std::complex<double> z)
+		{
+			// largest root of a * xi^2 + b * xi + c
+			const auto getLargestRoot = [](const std::complex<double> a, const std::complex<double> b, const std::complex<double> c)
+			{
+				if (a == 0.0)
+					return std::numeric_limits<double>::infinity();
+
+				const std::complex<double> delta = std::sqrt(b * b - 4.0 * a * c);
+				return std::max(std::abs((-b + delta) / (2.0 * a)), std::abs((-b - delta) / (2.0 * a)));
+			};
+
+			switch (solverType)
+			{
+				case SolverType::ExplicitEuler:
+				case SolverType::RungeKuttaRalston:
+				case SolverType::RungeKutta3:
+				case SolverType::RungeKutta4:
+				case SolverType::RungeKuttaThreeEight:
+				{
+					// truncated Taylor expansion of exp(z)
+					std::complex<double> amplification = 1.0;
+					std::complex<double> term = 1.0;
+					for (unsigned j = 1; j <= GetTaylorOrder(solverType); ++j)
+					{
+						term *= z / static_cast<double>(j);
+						amplification += term;
+					}
+					return std::abs(amplification);
+				}
+				case SolverType::ImplicitEuler:
+					return 1.0 / std::abs(1.0 - z);
+				case SolverType::CrankNicolson:
+					return std::abs((1.0 + .5 * z) / (1.0 - .5 * z));
+				case SolverType::RungeKuttaGaussLegendre4:
+					return std::abs((1.0 + .5 * z + z * z / 12.0) / (1.0 - .5 * z + z * z / 12.0));
+				case SolverType::AdamsBashforth2:
+					// xi^2 = (1 + 3 / 2 * z) * xi - 1 / 2 * z
+					return getLargestRoot(1.0, -(1.0 + 1.5 * z), .5 * z);
+				case SolverType::AdamsMouldon2:
+					// (1 - 5 / 12 * z) * xi^2 = (1 + 8 / 12 * z) * xi - 1 / 12 * z
+					return getLargestRoot(1.0 - 5.0 / 12.0 * z, -(1.0 + 8.0 / 12.0 * z), z / 12.0);
+				default:
+					return -1.0;
+			}
+		}
+
+		inline double FindLargestStableDt(const std::vector<GershgorinDisc>& discs, const SolverType solverType, const double dt)
+		{
+			if (GetAmplificationFactor(solverType, 0.0) < 0.0)
+				return std::numeric_limits<double>::quiet_NaN();
+
+			// the amplification factor is analytic away from its poles, so that it's largest on the boundary of the discs
+			constexpr unsigned nSamples = 64;
+			const double pi = std::acos(-1.0);
+			const auto isStable = [&](const double candidate)
+			{
+				for (const auto& disc : discs)
+				{
+					for (unsigned s = 0; s <= nSamples; ++s)
+					{
+						const std::complex<double> lambda = s == nSamples ? disc.center : disc.center + std::polar(disc.radius, 2.0 * pi * s / nSamples);
+						if (GetAmplificationFactor(solverType, candidate * lambda) > 1.0 + 1e-10)
+							return false;
+					}
+				}
+				return true;
+			};
+
+			// bracket the largest stable dt by doubling or halving, then bisect
+			constexpr int maxDoublings = 60;
+			double lower = dt;
+			double upper = dt;
+			if (isStable(dt))
+			{
+				int n = 0;
+				for (upper = 2.0 * dt; isStable(upper); upper *= 2.0)
+				{
+					lower = upper;
+					if (++n == maxDoublings)
+						return std::numeric_limits<double>::infinity();
+				}
+			}
+			else
+			{
+				int n = 0;
+				for (lower = .5 * dt; !isStable(lower); lower *= .5)
+				{
+					upper = lower;
+					if (++n == maxDoublings)
+						return 0.0;
+				}
+			}
+
+			while (upper - lower > 1e-6 * lower)
+			{
+				const double middle = .5 * (lower + upper);
+				if (isStable(middle))
+					lower = middle;
+				else
+					upper = middle;
+			}
+
+			return lower;
+		}
+	}
+}
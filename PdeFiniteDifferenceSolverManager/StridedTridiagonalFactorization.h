@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <SparseDiagonalMatrix.h>
+
+namespace pde
+{
+	/**
+	*	Thomas algorithm for a matrix whose only diagonals are at offsets 0 and +-stride.
+	*	On a column-major flattened grid with stride = nRows this is nRows independent tridiagonal systems, one per grid row (and with stride = 1, one per grid column):
+	*	all the lines are eliminated together, so that the inner loop runs across lines on contiguous memory.
+	*/
+	template<typename stdType>
+	class StridedTridiagonalFactorization
+	{
+	public:
+		StridedTridiagonalFactorization(const SparseDiagonalMatrix<stdType>& matrix, const unsigned stride);
+
+		virtual ~StridedTridiagonalFactorization() noexcept = default;
+		StridedTridiagonalFactorization(const StridedTridiagonalFactorization& rhs) = default;
+		StridedTridiagonalFactorization(StridedTridiagonalFactorization&& rhs) noexcept = default;
+		StridedTridiagonalFactorization& operator=(const StridedTridiagonalFactorization& rhs) = default;
+		StridedTridiagonalFactorization& operator=(StridedTridiagonalFactorization&& rhs) noexcept = default;
+
+		unsigned nRows() const noexcept { return static_cast<unsigned>(inverseDiagonal.size()); }
+		unsigned stride() const noexcept { return _stride; }
+
+		/**
+		* x = A^{-1} * x
+		*/
+		void Solve(stdType* x) const;
+
+	private:
+		unsigned _stride;
+
+		/**
+		* Elimination multipliers, reciprocal of the eliminated diagonal, and the untouched upper diagonal
+		*/
+		std::vector<stdType> lower;
+		std::vector<stdType> inverseDiagonal;
+		std::vector<stdType> upper;
+	};
+}
+
+#include <StridedTridiagonalFactorization.tpp>
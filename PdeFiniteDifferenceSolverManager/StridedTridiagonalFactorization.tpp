@@ -0,0 +1,57 @@
+#pragma once
+
+#include <StridedTridiagonalFactorization.h>
+#include <algorithm>
+#include <cassert>
+
+namespace pde
+{
+	template<typename stdType>
+	StridedTridiagonalFactorization<stdType>::StridedTridiagonalFactorization(const SparseDiagonalMatrix<stdType>& matrix, const unsigned stride)
+		: _stride(stride),
+		lower(matrix.nRows(), stdType(0.0)),
+		inverseDiagonal(matrix.nRows(), stdType(0.0)),
+		upper(matrix.nRows(), stdType(0.0))
+	{
+		const unsigned n = matrix.nRows();
+		for (const int k : matrix.Offsets())
+			assert(k == 0 || k == static_cast<int>(stride) || k == -static_cast<int>(stride));
+
+		const stdType* mainDiagonal = matrix.Diagonal(0);
+		const stdType* lowerDiagonal = matrix.Diagonal(-static_cast<int>(stride));
+		const stdType* upperDiagonal = matrix.Diagonal(static_cast<int>(stride));
+		assert(mainDiagonal);
+
+		if (upperDiagonal)
+			std::copy(upperDiagonal, upperDiagonal + n, upper.begin());
+
+		for (unsigned k = 0; k < n; ++k)
+		{
+			stdType pivot = mainDiagonal[k];
+			if (k >= stride && lowerDiagonal)
+			{
+				lower[k] = lowerDiagonal[k] * inverseDiagonal[k - stride];
+				pivot -= lower[k] * upper[k - stride];
+			}
+
+			assert(pivot != stdType(0.0));
+			inverseDiagonal[k] = stdType(1.0) / pivot;
+		}
+	}
+
+	template<typename stdType>
+	void StridedTridiagonalFactorization<stdType>::Solve(stdType* x) const
+	{
+		const unsigned n = nRows();
+
+		// forward substitution: with stride > 1 consecutive k belong to different lines, so these loops vectorize
+		for (unsigned k = _stride; k < n; ++k)
+			x[k] -= lower[k] * x[k - _stride];
+
+		// back substitution
+		for (unsigned k = n; k-- > n - _stride;)
+			x[k] *= inverseDiagonal[k];
+		for (unsigned k = n - _stride; k-- > 0;)
+			x[k] = (x[k] - upper[k] * x[k + _stride]) * inverseDiagonal[k];
+	}
+}
@@ -12,6 +12,16 @@ namespace pde
 	{
 		// NB: I am not writing support for multi-step algorithm here, so I will write the Iterate code here in place
 
+		if (!timeDiscretizers)
+		{
+			auto _solution = solution.Get();
+			auto _solutionDerivative = solutionDerivative->Get();
+			pde::detail::IterateWaveEquation1D(_solution, _solutionDerivative, this->bandedTimeDiscretizers, *this->bandedSpaceDiscretizer, this->hostInput, nSteps);
+			solution.ReadFrom(_solution);
+			solutionDerivative->ReadFrom(_solutionDerivative);
+			return;
+		}
+
 		FiniteDifferenceInput1D _input(inputData.dt,
 										inputData.spaceGrid.GetBuffer(),
 										inputData.velocity.GetBuffer(),
@@ -20,13 +30,11 @@ namespace pde
 										inputData.spaceDiscretizerType,
 										inputData.boundaryConditions);
 
-		cl::ColumnWiseMatrix<ms, md> solutionBuffer(solution), solutionDerivativeBuffer(*solutionDerivative);
-		cl::ColumnWiseMatrix<ms, md> workBuffer(solution);
-
-		// for performance reasons, I'm creating two working buffers here, which I will re-use during the main loop
-		cl::ColumnWiseMatrix<ms, md> *inSol = &solution, *outSol = &solutionBuffer;
-		cl::ColumnWiseMatrix<ms, md> *inDer = solutionDerivative.get(), *outDer = &solutionDerivativeBuffer;
-		bool needToCopyBack = false;
+		// the working buffers are allocated once in Setup, and the steps ping-pong between them and the solution
+		cl::ColumnWiseMatrix<ms, md> *inSol = &solution, *outSol = solutionBuffer.get();
+		cl::ColumnWiseMatrix<ms, md> *inDer = solutionDerivative.get(), *outDer = solutionDerivativeBuffer.get();
+		cl::ColumnWiseMatrix<ms, md>& workBuffer = *this->workBuffer;
+		bool isInBuffer = false;
 
 		// u'' = L * u  
 		//		==>
@@ -49,14 +57,23 @@ namespace pde
 
 			std::swap(inSol, outSol);
 			std::swap(inDer, outDer);
-			needToCopyBack = !needToCopyBack;
+			isInBuffer = !isInBuffer;
 		}
 
-		if (needToCopyBack)
+		if (!isInBuffer)
+			return;
+
+		// the buffers become the solution, rather than being copied back: callers read solution from the solver again after Advance, see FiniteDifferenceSolver::solution
+		if (&solution == this->solution.get())
 		{
-			solution.ReadFrom(*inSol);
-			solutionDerivative->ReadFrom(*inDer);
+			std::swap(this->solution, solutionBuffer);
+			std::swap(solutionDerivative, solutionDerivativeBuffer);
+			return;
 		}
+
+		// solution is some other matrix, which has to keep its buffer
+		solution.ReadFrom(*inSol);
+		solutionDerivative->ReadFrom(*inDer);
 	}
 
 	template<MemorySpace ms, MathDomain md>
@@ -84,6 +101,35 @@ namespace pde
 		pde::detail::MakeTimeDiscretizerWaveEquation(timeDiscretizers->GetCube(), spaceDiscretizer->GetTile(), solverType, inputData.dt);
 	}
 
+	template<MemorySpace ms, MathDomain md>
+	bool WaveEquationSolver1D<ms, md>::MakeTimeDiscretizer(BandedTimeDiscretizer<stdType>& timeDiscretizers, const SolverType solverType)
+	{
+		if (this->HasOneSidedPeriodicBoundaryConditions())
+		{
+			// the dense propagators only implement solverType
+			if (this->inputData.settings.extendedSolverType == ExtendedSolverType::StormerVerlet)
+				throw UnsupportedSolverTypeException("StormerVerlet needs the banded operator, which one-sided periodic boundaries rule out");
+			return false;
+		}
+
+		// as in the dense version: no u_x component, and velocity^2 as 'diffusion'
+		HostFiniteDifferenceInput1D<stdType> _input(this->hostInput);
+		for (size_t i = 0; i < _input.velocity.size(); ++i)
+		{
+			_input.diffusion[i] = _input.velocity[i] * _input.velocity[i];
+			_input.velocity[i] = stdType(0.0);
+		}
+
+		this->bandedSpaceDiscretizer = std::make_shared<BandedMatrix<stdType>>();
+		pde::detail::MakeSpaceDiscretizer1D(*this->bandedSpaceDiscretizer, _input);
+
+		// leapfrog steps only need the space discretizer, and take precedence over solverType
+		if (pde::detail::MakeStormerVerletTimeDiscretizer(timeDiscretizers, this->inputData.settings.extendedSolverType))
+			return true;
+
+		return pde::detail::MakeTimeDiscretizerWaveEquation(timeDiscretizers, *this->bandedSpaceDiscretizer, solverType, this->inputData.dt);
+	}
+
 	template<MemorySpace ms, MathDomain md>
 	void WaveEquationSolver1D<ms, md>::Setup(const unsigned solverSteps)
 	{
@@ -93,5 +139,13 @@ namespace pde
 
 		// TODO: read from input instead of setting it to 0
 		solutionDerivative = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(this->inputData.initialCondition.nRows(), solverSteps, static_cast<cl::ColumnWiseMatrix<ms, md>::stdType>(0.0));
+
+		// dense propagators only: the working buffers of AdvanceImpl live as long as the solver
+		if (this->timeDiscretizers)
+		{
+			solutionBuffer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(this->inputData.initialCondition.nRows(), solverSteps);
+			solutionDerivativeBuffer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(this->inputData.initialCondition.nRows(), solverSteps);
+			workBuffer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(this->inputData.initialCondition.nRows(), solverSteps);
+		}
 	}
 }
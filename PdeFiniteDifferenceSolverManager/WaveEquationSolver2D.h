@@ -22,6 +22,13 @@ namespace pde
 
 		using FiniteDifferenceSolver2D::FiniteDifferenceSolver2D;
 
+		typedef typename cl::Traits<mathDomain>::stdType stdType;
+
+		/**
+		* Whether the state includes solutionDerivative, for the memory plan
+		*/
+		static constexpr bool hasSolutionDerivative = true;
+
 		MAKE_DEFAULT_CONSTRUCTORS(WaveEquationSolver2D);
 
 	protected:
@@ -32,7 +39,22 @@ namespace pde
 
 		void MakeTimeDiscretizer(const std::shared_ptr<cl::Tensor<memorySpace, mathDomain>>& timeDiscretizers, const SolverType solverType);
 
+		/**
+		* Returns false if solverType has no sparse (or banded-factorizable) propagator, in which case the dense overload is used.
+		* Throws UnsupportedSolverTypeException if extendedSolverType is StormerVerlet and the boundary conditions rule out the sparse operator
+		*/
+		bool MakeTimeDiscretizer(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizers, const SolverType solverType);
+
 		void Setup(const unsigned solverSteps);
+
+	private:
+		/**
+		* Dense propagators only: after an odd number of steps the buffers are swapped with solution and solutionDerivative, so that nothing is allocated or copied back.
+		* solution then points to another matrix, and a copy of the pointer (or of one of its columns) taken before Advance is left on the previous step
+		*/
+		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> solutionBuffer;
+		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> solutionDerivativeBuffer;
+		std::shared_ptr<cl::ColumnWiseMatrix<memorySpace, mathDomain>> workBuffer;
 	};
 
 #pragma region Type aliases
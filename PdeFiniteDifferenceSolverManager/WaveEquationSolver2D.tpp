@@ -12,6 +12,16 @@ namespace pde
 	{
 		// NB: I am not writing support for multi-step algorithm here, so I will write the Iterate code here in place
 
+		if (!timeDiscretizers)
+		{
+			auto _solution = solution.Get();
+			auto _solutionDerivative = solutionDerivative->Get();
+			pde::detail::IterateWaveEquation2D(_solution, _solutionDerivative, this->sparseTimeDiscretizers, *this->sparseSpaceDiscretizer, this->hostInput, nSteps);
+			solution.ReadFrom(_solution);
+			solutionDerivative->ReadFrom(_solutionDerivative);
+			return;
+		}
+
 		FiniteDifferenceInput2D _input(inputData.dt,
 									   inputData.xSpaceGrid.GetBuffer(),
 									   inputData.ySpaceGrid.GetBuffer(),
@@ -22,13 +32,11 @@ namespace pde
 									   inputData.spaceDiscretizerType,
 									   inputData.boundaryConditions);
 
-		cl::ColumnWiseMatrix<ms, md> solutionBuffer(solution), solutionDerivativeBuffer(*solutionDerivative);
-		cl::ColumnWiseMatrix<ms, md> workBuffer(solution);
-
-		// for performance reasons, I'm creating two working buffers here, which I will re-use during the main loop
-		cl::ColumnWiseMatrix<ms, md> *inSol = &solution, *outSol = &solutionBuffer;
-		cl::ColumnWiseMatrix<ms, md> *inDer = solutionDerivative.get(), *outDer = &solutionDerivativeBuffer;
-		bool needToCopyBack = false;
+		// the working buffers are allocated once in Setup, and the steps ping-pong between them and the solution
+		cl::ColumnWiseMatrix<ms, md> *inSol = &solution, *outSol = solutionBuffer.get();
+		cl::ColumnWiseMatrix<ms, md> *inDer = solutionDerivative.get(), *outDer = solutionDerivativeBuffer.get();
+		cl::ColumnWiseMatrix<ms, md>& workBuffer = *this->workBuffer;
+		bool isInBuffer = false;
 
 		// u'' = L * u  
 		//		==>
@@ -51,14 +59,23 @@ namespace pde
 
 			std::swap(inSol, outSol);
 			std::swap(inDer, outDer);
-			needToCopyBack = !needToCopyBack;
+			isInBuffer = !isInBuffer;
 		}
 
-		if (needToCopyBack)
+		if (!isInBuffer)
+			return;
+
+		// the buffers become the solution, rather than being copied back: callers read solution from the solver again after Advance, see FiniteDifferenceSolver::solution
+		if (&solution == this->solution.get())
 		{
-			solution.ReadFrom(*inSol);
-			solutionDerivative->ReadFrom(*inDer);
+			std::swap(this->solution, solutionBuffer);
+			std::swap(solutionDerivative, solutionDerivativeBuffer);
+			return;
 		}
+
+		// solution is some other matrix, which has to keep its buffer
+		solution.ReadFrom(*inSol);
+		solutionDerivative->ReadFrom(*inDer);
 	}
 
 	template<MemorySpace ms, MathDomain md>
@@ -91,6 +108,34 @@ namespace pde
 		pde::detail::MakeTimeDiscretizerWaveEquation(timeDiscretizers->GetCube(), spaceDiscretizer->GetTile(), solverType, inputData.dt);
 	}
 
+	template<MemorySpace ms, MathDomain md>
+	bool WaveEquationSolver2D<ms, md>::MakeTimeDiscretizer(BandedTimeDiscretizer<stdType, SparseDiagonalMatrix>& timeDiscretizers, const SolverType solverType)
+	{
+		if (!this->SupportsSparseOperators())
+		{
+			// the dense propagators only implement solverType
+			if (this->inputData.settings.extendedSolverType == ExtendedSolverType::StormerVerlet)
+				throw UnsupportedSolverTypeException("StormerVerlet needs the sparse operators, which periodic boundaries and device-only coefficients rule out");
+			return false;
+		}
+
+		// as in the dense version: no u_x component, and xVelocity[0]^2 as 'diffusion'
+		HostFiniteDifferenceInput2D<stdType> _input(this->hostInput);
+		const stdType diffusion = _input.xVelocity[0] * _input.xVelocity[0];
+		std::fill(_input.xVelocity.begin(), _input.xVelocity.end(), stdType(0.0));
+		std::fill(_input.yVelocity.begin(), _input.yVelocity.end(), stdType(0.0));
+		std::fill(_input.diffusion.begin(), _input.diffusion.end(), diffusion);
+
+		this->sparseSpaceDiscretizer = std::make_shared<SparseDiagonalMatrix<stdType>>();
+		pde::detail::MakeSpaceDiscretizer2D(*this->sparseSpaceDiscretizer, _input);
+
+		// leapfrog steps only need the space discretizer, and take precedence over solverType
+		if (pde::detail::MakeStormerVerletTimeDiscretizer(timeDiscretizers, this->inputData.settings.extendedSolverType))
+			return true;
+
+		return pde::detail::MakeTimeDiscretizerWaveEquation(timeDiscretizers, *this->sparseSpaceDiscretizer, solverType, this->inputData.dt, this->inputData.settings.linearSolverSettings, &_input);
+	}
+
 	template<MemorySpace ms, MathDomain md>
 	void WaveEquationSolver2D<ms, md>::Setup(const unsigned solverSteps)
 	{
@@ -101,5 +146,13 @@ namespace pde
 		// TODO: read from input instead of setting it to 0
 		const unsigned dimension = this->inputData.initialCondition.nRows() * this->inputData.initialCondition.nCols();
 		solutionDerivative = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(dimension, solverSteps, static_cast<cl::ColumnWiseMatrix<ms, md>::stdType>(0.0));
+
+		// dense propagators only: the working buffers of AdvanceImpl live as long as the solver
+		if (this->timeDiscretizers)
+		{
+			solutionBuffer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(dimension, solverSteps);
+			solutionDerivativeBuffer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(dimension, solverSteps);
+			workBuffer = std::make_shared<cl::ColumnWiseMatrix<ms, md>>(dimension, solverSteps);
+		}
 	}
 }
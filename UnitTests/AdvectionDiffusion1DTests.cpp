@@ -168,4 +168,675 @@ namespace pdet
 			
 		}
 	}
-}
\ No newline at end of file
+
+	TEST_F(AdvectionDiffusion1DTests, SineModeLargeGridBanded)
+	{
+		// a dense operator on this grid would need 1e10 entries
+		const unsigned n = 100001;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+		const double dx = _grid[1] - _grid[0];
+
+		// sin(k * pi * x) is an eigenvector of the discrete Laplacian with homogeneous Dirichlet boundaries, with eigenvalue -4 / dx^2 * sin^2(k * pi * dx / 2)
+		const unsigned k = 1000;
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < n; ++i)
+			_initialCondition[i] = sin(k * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		const unsigned steps = 500;
+		double dt = 2e-11;
+		double diffusion = 1.0;
+		const double eigenvalue = -4.0 * diffusion / (dx * dx) * sin(.5 * k * pi * dx) * sin(.5 * k * pi * dx);
+		const double z = dt * eigenvalue;
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition1D boundaryConditions(zero, zero);
+		for (const SolverType solverType : { SolverType::ExplicitEuler, SolverType::RungeKutta4, SolverType::AdamsBashforth2, SolverType::ImplicitEuler, SolverType::CrankNicolson, SolverType::AdamsMouldon2 })
+		{
+			pde::GpuDoublePdeInputData1D data(initialCondition, grid, 0.0, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad1D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			// one-step schemes multiply the mode by their amplification factor at each step, the multi-step ones are compared to the exact decay
+			double amplification = exp(steps * z);
+			double tolerance = 1e-6;
+			switch (solverType)
+			{
+				case SolverType::ExplicitEuler:
+					amplification = pow(1.0 + z, steps);
+					tolerance = 1e-8;
+					break;
+				case SolverType::RungeKutta4:
+					amplification = pow(1.0 + z + z * z / 2.0 + z * z * z / 6.0 + z * z * z * z / 24.0, steps);
+					tolerance = 1e-8;
+					break;
+				case SolverType::ImplicitEuler:
+					amplification = pow(1.0 / (1.0 - z), steps);
+					tolerance = 1e-8;
+					break;
+				case SolverType::CrankNicolson:
+					amplification = pow((1.0 + .5 * z) / (1.0 - .5 * z), steps);
+					tolerance = 1e-8;
+					break;
+				default:
+					break;
+			}
+			ASSERT_LT(amplification, .95);
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(solution[i] - amplification * _initialCondition[i]), tolerance);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, SineSolutionPeriodicBanded)
+	{
+		// first and last points are ghost copies of the points n - 2 and 1: the period is 2 * pi
+		const unsigned n = 130;
+		const float pi = 3.14159265358979f;
+		const float dx = 2.0f * pi / (n - 2);
+		cl::vec grid = cl::LinSpace(-pi - dx, pi, n);
+		auto _grid = grid.Get();
+
+		std::vector<float> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = sin(_grid[i]);
+
+		cl::vec initialCondition(_initialCondition);
+
+		unsigned steps = 100;
+		double dt = 1e-4;
+		float velocity = 1.0f;
+		float diffusion = 0.0f;
+
+		float finalTime = steps * dt;
+		std::vector<float> _exactSolution(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_exactSolution[i] = sin(_grid[i] - velocity * finalTime);
+
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Periodic, 0.0), BoundaryCondition(BoundaryConditionType::Periodic, 0.0));
+		for (const SolverType solverType : { SolverType::ExplicitEuler, SolverType::RungeKutta4, SolverType::AdamsBashforth2, SolverType::ImplicitEuler, SolverType::CrankNicolson })
+		{
+			pde::GpuSinglePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::ad1D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_TRUE(fabs(solution[i] - _exactSolution[i]) <= 1e-3);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, SpectralAgainstRungeKutta)
+	{
+		const unsigned n = 48;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + _grid[i] + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		const unsigned steps = 100;
+		double dt = 1e-4;
+		double velocity = .3;
+		double diffusion = .05;
+
+		// non-homogeneous boundaries, so that the interior is forced
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 2.0));
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::RungeKutta4, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dad1D solver(data);
+
+		std::vector<double> times;
+		for (unsigned k = 1; k <= 5; ++k)
+			times.push_back(k * steps * dt);
+		cl::dmat snapshots(n, static_cast<unsigned>(times.size()), 0.0);
+		ASSERT_TRUE(solver.EvaluateSpectral(snapshots, times));
+
+		for (size_t k = 0; k < times.size(); ++k)
+		{
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+			const auto snapshot = snapshots.columns[k]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(snapshot[i] - solution[i]), 1e-9);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, KrylovExponentialAgainstSpectral)
+	{
+		const unsigned n = 128;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + _grid[i] + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		// way past the explicit stability limit dx^2 / (2 * diffusion) ~ 6e-4
+		const unsigned steps = 10;
+		double dt = 2e-2;
+		double velocity = .5;
+		double diffusion = .05;
+
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 2.0));
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::KrylovExponential });
+		pde::dad1D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+		std::vector<double> times;
+		for (unsigned k = 1; k <= 5; ++k)
+			times.push_back(k * steps * dt);
+		cl::dmat snapshots(n, static_cast<unsigned>(times.size()), 0.0);
+		ASSERT_TRUE(solver.EvaluateSpectral(snapshots, times));
+
+		for (size_t k = 0; k < times.size(); ++k)
+		{
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+			const auto snapshot = snapshots.columns[k]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(snapshot[i] - solution[i]), 1e-9);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, DormandPrinceAgainstSpectral)
+	{
+		const unsigned n = 64;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + _grid[i] + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		// dt is only the first step tried
+		double dt = 1e-4;
+		double velocity = .5;
+		double diffusion = .05;
+
+		pde::PdeSolverSettings settings;
+		settings.extendedSolverType = pde::ExtendedSolverType::DormandPrince54;
+		settings.propagatorPowerPolicy = pde::PropagatorPowerPolicy::CostModel;
+		settings.adaptiveStepSettings.absoluteTolerance = 1e-10;
+		settings.adaptiveStepSettings.relativeTolerance = 1e-10;
+
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Neumann, 1.0), BoundaryCondition(BoundaryConditionType::Neumann, 2.0));
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, settings);
+		pde::dad1D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+		// not multiples of dt
+		const std::vector<double> times = { .0137, .1, .5, 2.0 };
+		cl::dmat snapshots(n, static_cast<unsigned>(times.size()), 0.0);
+		ASSERT_TRUE(solver.EvaluateSpectral(snapshots, times));
+
+		for (size_t k = 0; k < times.size(); ++k)
+		{
+			solver.AdvanceTo(times[k]);
+			ASSERT_DOUBLE_EQ(times[k], solver.GetTime());
+
+			const auto solution = solver.solution->columns[0]->Get();
+			const auto snapshot = snapshots.columns[k]->Get();
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(snapshot[i] - solution[i]), 1e-8);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, StabilityAnalysis)
+	{
+		const unsigned n = 101;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = exp(-(_grid[i] - .5) * (_grid[i] - .5) / .01);
+		cl::dvec initialCondition(_initialCondition);
+
+		double velocity = .5;
+		double diffusion = .05;
+		const double dx = _grid[1] - _grid[0];
+
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 0.0), BoundaryCondition(BoundaryConditionType::Neumann, 0.0));
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, 1e-4, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dad1D solver(data);
+
+		// the classic dx^2 / (2 * diffusion) bound, as the cell Peclet number is below 2
+		const auto report = solver.AnalyseStability();
+		ASSERT_TRUE(report.isStable);
+		ASSERT_LE(report.spectralRadius, 1.0);
+		ASSERT_NEAR(report.largestStableDt, dx * dx / (2.0 * diffusion), 1e-3 * report.largestStableDt);
+
+		// past the bound, the propagator isn't a contraction anymore
+		pde::GpuDoublePdeInputData1D unstableData(initialCondition, grid, velocity, diffusion, 1.1 * report.largestStableDt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dad1D unstableSolver(unstableData);
+
+		const auto unstableReport = unstableSolver.AnalyseStability(false);
+		ASSERT_FALSE(unstableReport.isStable);
+		ASSERT_GT(unstableReport.spectralRadius, 1.1);
+
+		// stepping is left to the caller
+		const auto solution = unstableSolver.solution->columns[0]->Get();
+		for (size_t i = 0; i < solution.size(); ++i)
+			ASSERT_DOUBLE_EQ(_initialCondition[i], solution[i]);
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, StabilityAnalysisLeavesTrajectoryUnchanged)
+	{
+		const unsigned n = 64;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		double dt = 1e-3;
+		double velocity = .5;
+		double diffusion = .05;
+
+		// the adaptive step size and the exponential sub-steps carry from one step to the next, and the multi-step history is left alone
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0));
+		for (const pde::ExtendedSolverType extendedSolverType : { pde::ExtendedSolverType::DormandPrince54, pde::ExtendedSolverType::KrylovExponential, pde::ExtendedSolverType::AdamsBashforth3 })
+		{
+			pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { extendedSolverType });
+			pde::dad1D solver(data);
+			pde::dad1D referenceSolver(data);
+
+			solver.Advance(5);
+			const auto report = solver.AnalyseStability();
+			solver.Advance(5);
+			referenceSolver.Advance(5);
+			referenceSolver.Advance(5);
+
+			ASSERT_EQ(extendedSolverType == pde::ExtendedSolverType::AdamsBashforth3, std::isnan(report.spectralRadius));
+
+			const auto solution = solver.solution->columns[0]->Get();
+			const auto referenceSolution = referenceSolver.solution->columns[0]->Get();
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_DOUBLE_EQ(referenceSolution[i], solution[i]);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, ImexAgainstSpectral)
+	{
+		const unsigned n = 64;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + _grid[i] + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		// four times the diffusive limit dx^2 / (2 * diffusion), well within the advective one dx / velocity
+		const unsigned steps = 20;
+		double dt = 1e-2;
+		double velocity = .5;
+		double diffusion = .05;
+
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 2.0));
+
+		std::vector<double> times;
+		for (unsigned k = 1; k <= 5; ++k)
+			times.push_back(k * steps * dt);
+
+		// the first order splitting is off by ~dt * t * |L^2 u| / 2, the second order ones by ~1e-4
+		for (const pde::ExtendedSolverType extendedSolverType : { pde::ExtendedSolverType::ImexEuler, pde::ExtendedSolverType::ImexCrankNicolsonAdamsBashforth2, pde::ExtendedSolverType::ImexAdditiveRungeKutta2 })
+		{
+			pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { extendedSolverType });
+			pde::dad1D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			cl::dmat snapshots(n, static_cast<unsigned>(times.size()), 0.0);
+			ASSERT_TRUE(solver.EvaluateSpectral(snapshots, times));
+
+			const double tolerance = extendedSolverType == pde::ExtendedSolverType::ImexEuler ? 2e-2 : 1e-3;
+			for (size_t k = 0; k < times.size(); ++k)
+			{
+				solver.Advance(steps);
+				const auto solution = solver.solution->columns[0]->Get();
+				const auto snapshot = snapshots.columns[k]->Get();
+
+				for (size_t i = 0; i < solution.size(); ++i)
+					ASSERT_LE(fabs(snapshot[i] - solution[i]), tolerance);
+			}
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, ImexSplitAdvanceMatchesSingleAdvance)
+	{
+		const unsigned n = 64;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + _grid[i] + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		double dt = 1e-2;
+		double velocity = .5;
+		double diffusion = .05;
+
+		// CNAB2 carries the previous advection term from one call to the next: restarting it with an Euler step would show up here
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 2.0));
+		for (const pde::ExtendedSolverType extendedSolverType : { pde::ExtendedSolverType::ImexEuler, pde::ExtendedSolverType::ImexCrankNicolsonAdamsBashforth2 })
+		{
+			pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { extendedSolverType });
+			pde::dad1D solver(data);
+			pde::dad1D referenceSolver(data);
+
+			referenceSolver.Advance(21);
+			for (const unsigned steps : { 1u, 2u, 3u, 15u })
+				solver.Advance(steps);
+			ASSERT_DOUBLE_EQ(referenceSolver.GetTime(), solver.GetTime());
+
+			const auto solution = solver.solution->columns[0]->Get();
+			const auto referenceSolution = referenceSolver.solution->columns[0]->Get();
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_DOUBLE_EQ(referenceSolution[i], solution[i]);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, LinearMultiStepAgainstSpectral)
+	{
+		const unsigned n = 64;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + _grid[i] + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		double velocity = .5;
+		double diffusion = .05;
+
+		// the backward differentiation formulas run at four times the diffusive limit, and the Adams-Bashforth ones within their own stability region:
+		// either way the history carries over from one Advance to the next
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 2.0));
+		const std::vector<std::pair<pde::ExtendedSolverType, double>> schemes = { { pde::ExtendedSolverType::BackwardDifferentiation2, 1e-2 },
+																				  { pde::ExtendedSolverType::BackwardDifferentiation3, 1e-2 },
+																				  { pde::ExtendedSolverType::BackwardDifferentiation4, 1e-2 },
+																				  { pde::ExtendedSolverType::AdamsBashforth3, 2.5e-4 },
+																				  { pde::ExtendedSolverType::AdamsBashforth4, 2.5e-4 } };
+		for (const auto& scheme : schemes)
+		{
+			double dt = scheme.second;
+			const unsigned steps = static_cast<unsigned>(.2 / dt + .5);
+
+			pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, scheme.first);
+			pde::dad1D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			std::vector<double> times;
+			for (unsigned k = 1; k <= 5; ++k)
+				times.push_back(k * steps * dt);
+			cl::dmat snapshots(n, static_cast<unsigned>(times.size()), 0.0);
+			ASSERT_TRUE(solver.EvaluateSpectral(snapshots, times));
+
+			for (size_t k = 0; k < times.size(); ++k)
+			{
+				solver.Advance(steps);
+				const auto solution = solver.solution->columns[0]->Get();
+				const auto snapshot = snapshots.columns[k]->Get();
+
+				for (size_t i = 0; i < solution.size(); ++i)
+					ASSERT_LE(fabs(snapshot[i] - solution[i]), 1e-3);
+			}
+
+			// writing the initial condition back restarts the history, rather than stepping it from the last solution
+			solver.solution->columns[0]->ReadFrom(initialCondition);
+			solver.Advance(steps);
+
+			const auto solution = solver.solution->columns[0]->Get();
+			const auto snapshot = snapshots.columns[0]->Get();
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(snapshot[i] - solution[i]), 1e-3);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, RungeKuttaBootstrapAgainstSpectral)
+	{
+		const unsigned n = 64;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < _initialCondition.size(); ++i)
+			_initialCondition[i] = 1.0 + _grid[i] + sin(2.0 * pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		// a single CrankNicolson step is off by ~2e-3 here, four RungeKutta4 sub-steps by ~6e-6
+		double dt = 1e-2;
+		double velocity = .5;
+		double diffusion = .05;
+		pde::PdeSolverSettings settings;
+		settings.propagatorPowerPolicy = pde::PropagatorPowerPolicy::CostModel;
+		settings.bootstrapSubSteps = 4;
+
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 2.0));
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::AdamsBashforth2, SpaceDiscretizerType::Centered, boundaryConditions, settings);
+		pde::dad1D solver(data);
+
+		// EvaluateSpectral starts from the newest level, which is the bootstrapped one: the reference is a one-step solver, still at the initial condition
+		pde::GpuDoublePdeInputData1D referenceData(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dad1D reference(referenceData);
+		cl::dmat snapshots(n, 1, 0.0);
+		ASSERT_TRUE(reference.EvaluateSpectral(snapshots, { dt }));
+
+		// the first column holds the newest level of the history
+		const auto solution = solver.solution->columns[0]->Get();
+		const auto snapshot = snapshots.columns[0]->Get();
+		for (size_t i = 0; i < solution.size(); ++i)
+			ASSERT_LE(fabs(snapshot[i] - solution[i]), 1e-4);
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, MemoryBudgetRefusesDenseOperators)
+	{
+		const unsigned n = 64;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		cl::dvec initialCondition(n, 1.0);
+
+		// one-sided periodic boundaries have no banded operator, so that the dense ones would be allocated
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Periodic, 0.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0));
+		const auto plan = pde::PlanMemory(n, 1, SolverType::CrankNicolson, MathDomain::Double, false, true);
+		ASSERT_EQ(plan.timeDiscretizers, n * n * sizeof(double));
+		ASSERT_EQ(plan.propagatorPower, 3 * n * n * sizeof(double));
+
+		const size_t tightBudget = plan.Total() - plan.propagatorPower;
+		pde::PdeSolverSettings settings;
+		settings.propagatorPowerPolicy = pde::PropagatorPowerPolicy::Always;
+		settings.memoryBudget = tightBudget;
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, .5, .05, 1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions, settings);
+		pde::dad1D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() != nullptr);
+
+		// the power would be built by the first Advance, were it not dropped to fit in the budget
+		solver.Advance(8);
+		ASSERT_FALSE(solver.HasPropagatorPower());
+
+		settings.memoryBudget = plan.Total();
+		pde::GpuDoublePdeInputData1D fullData(initialCondition, grid, .5, .05, 1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions, settings);
+		pde::dad1D fullSolver(fullData);
+		fullSolver.Advance(8);
+		ASSERT_TRUE(fullSolver.HasPropagatorPower());
+
+		settings.memoryBudget = tightBudget - 1;
+		pde::GpuDoublePdeInputData1D smallData(initialCondition, grid, .5, .05, 1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions, settings);
+		ASSERT_THROW(pde::dad1D smallSolver(smallData), pde::MemoryBudgetExceededException);
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, ConstantCoefficientsKernelMatchesFieldKernel)
+	{
+		const unsigned n = 256;
+		pde::HostFiniteDifferenceInput1D<double> input;
+		input.dt = 1e-4;
+		for (unsigned i = 0; i < n; ++i)
+			input.spaceGrid.push_back(i / (n - 1.0));
+		input.velocity.assign(n, .5);
+		input.diffusion.assign(n, .05);
+		input.spaceDiscretizerType = SpaceDiscretizerType::Centered;
+
+		// scalar coefficients on a uniform grid: every row but the (empty) boundary ones has the same stencil
+		pde::BandedMatrix<double> spaceDiscretizer;
+		pde::detail::MakeSpaceDiscretizer1D(spaceDiscretizer, input);
+		ASSERT_EQ(spaceDiscretizer.constantCoefficientsBegin(), 1u);
+		ASSERT_EQ(spaceDiscretizer.constantCoefficientsEnd(), n - 1);
+
+		// the propagator keeps its constant rows, while a copy that drops them falls back to the field kernel
+		const auto propagator = pde::detail::MakeTaylorPropagator(spaceDiscretizer, input.dt, 4);
+		ASSERT_LT(propagator.constantCoefficientsBegin(), propagator.constantCoefficientsEnd());
+		auto fieldPropagator = propagator;
+		fieldPropagator.Diagonal(0);
+		ASSERT_EQ(fieldPropagator.constantCoefficientsEnd(), propagator.constantCoefficientsEnd());
+		fieldPropagator.DropConstantCoefficients();
+		ASSERT_EQ(fieldPropagator.constantCoefficientsEnd(), 0u);
+
+		const double pi = 3.14159265358979;
+		std::vector<double> in(n), out(n, 1.0), fieldOut(n, 1.0);
+		for (unsigned i = 0; i < n; ++i)
+			in[i] = sin(2.0 * pi * i / (n - 1.0));
+		propagator.Dot(out.data(), in.data(), .5, 2.0);
+		fieldPropagator.Dot(fieldOut.data(), in.data(), .5, 2.0);
+		for (unsigned i = 0; i < n; ++i)
+			ASSERT_LE(fabs(out[i] - fieldOut[i]), 1e-12);
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, EnsembleMatchesIndependentSolvers)
+	{
+		const unsigned n = 48;
+		const unsigned nMembers = 3;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialConditions(n * nMembers);
+		for (unsigned k = 0; k < nMembers; ++k)
+			for (unsigned i = 0; i < n; ++i)
+				_initialConditions[i + n * k] = 1.0 + sin((k + 1) * 3.0 * _grid[i]);
+		const cl::dmat initialConditions(_initialConditions, n, nMembers);
+
+		// Dirichlet boundaries take the banded propagators, and one-sided periodic ones the dense propagator
+		const BoundaryCondition1D dirichlet(BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 2.0));
+		const BoundaryCondition1D oneSidedPeriodic(BoundaryCondition(BoundaryConditionType::Periodic, 0.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 1.0));
+		for (const auto& boundaryConditions : { dirichlet, oneSidedPeriodic })
+		{
+			pde::GpuDoublePdeInputData1D data(*initialConditions.columns[0], grid, .5, .05, 1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad1D solver(data);
+
+			cl::dmat solutions(initialConditions);
+			solver.AdvanceEnsemble(solutions, 7);
+			const auto _solutions = solutions.Get();
+
+			for (unsigned k = 0; k < nMembers; ++k)
+			{
+				pde::GpuDoublePdeInputData1D memberData(*initialConditions.columns[k], grid, .5, .05, 1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions);
+				pde::dad1D memberSolver(memberData);
+				memberSolver.Advance(7);
+
+				const auto memberSolution = memberSolver.solution->columns[0]->Get();
+				for (unsigned i = 0; i < n; ++i)
+					ASSERT_LE(fabs(_solutions[i + n * k] - memberSolution[i]), 1e-12);
+			}
+		}
+
+		// the members can't share a multi-step history
+		pde::GpuDoublePdeInputData1D multiStepData(*initialConditions.columns[0], grid, .5, .05, 1e-3, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, dirichlet,
+												   { pde::ExtendedSolverType::AdamsBashforth3 });
+		pde::dad1D multiStepSolver(multiStepData);
+		cl::dmat solutions(initialConditions);
+		EXPECT_THROW(multiStepSolver.AdvanceEnsemble(solutions, 7), pde::UnsupportedSolverTypeException);
+
+		for (const SolverType solverType : { SolverType::AdamsBashforth2, SolverType::AdamsMouldon2 })
+		{
+			for (const auto& boundaryConditions : { dirichlet, oneSidedPeriodic })
+			{
+				pde::GpuDoublePdeInputData1D data(*initialConditions.columns[0], grid, .5, .05, 1e-3, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+				pde::dad1D solver(data);
+				EXPECT_THROW(solver.AdvanceEnsemble(solutions, 7), pde::UnsupportedSolverTypeException);
+			}
+		}
+	}
+
+	TEST_F(AdvectionDiffusion1DTests, HostOperatorMatchesDenseOperator)
+	{
+		const unsigned n = 40;
+		const double pi = 3.14159265358979;
+		const double dt = 1e-3;
+
+		// non-uniform grid, and velocity changing sign, so that every branch of the stencils is hit
+		std::vector<double> _grid(n), _velocity(n), _diffusion(n), _u(n);
+		for (unsigned i = 0; i < n; ++i)
+		{
+			const double x = i / (n - 1.0);
+			_grid[i] = x + .1 * x * (1.0 - x);
+			_velocity[i] = cos(2.0 * pi * x);
+			_diffusion[i] = .05 + .02 * x;
+			_u[i] = 1.0 + x + sin(3.0 * pi * x);
+		}
+		cl::dvec grid(_grid), velocity(_velocity), diffusion(_diffusion);
+
+		const BoundaryCondition dirichlet(BoundaryConditionType::Dirichlet, 1.0);
+		const BoundaryCondition neumann(BoundaryConditionType::Neumann, -.5);
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		for (const SpaceDiscretizerType spaceDiscretizerType : { SpaceDiscretizerType::Centered, SpaceDiscretizerType::Upwind, SpaceDiscretizerType::LaxWendroff })
+		{
+			for (const auto& boundaryConditions : { BoundaryCondition1D(dirichlet, dirichlet), BoundaryCondition1D(neumann, neumann), BoundaryCondition1D(dirichlet, neumann), BoundaryCondition1D(neumann, dirichlet), BoundaryCondition1D(periodic, periodic) })
+			{
+				FiniteDifferenceInput1D input(dt, grid.GetBuffer(), velocity.GetBuffer(), diffusion.GetBuffer(), SolverType::ExplicitEuler, spaceDiscretizerType, boundaryConditions);
+
+				// the boundary kernel makes u consistent with the boundary conditions, ghost points included
+				cl::dmat u(_u, n, 1);
+				pde::detail::SetBoundaryConditions1D(u.columns[0]->GetBuffer(), input);
+				const auto _consistentU = u.Get();
+
+				cl::dmat denseSpaceDiscretizer(n, n, 0.0);
+				pde::detail::MakeSpaceDiscretizer1D(denseSpaceDiscretizer.GetTile(), input);
+				cl::dmat denseOut(n, 1, 0.0);
+				cl::Multiply(denseOut, denseSpaceDiscretizer, u);
+				const auto _denseOut = denseOut.Get();
+
+				pde::HostFiniteDifferenceInput1D<double> hostInput;
+				hostInput.dt = dt;
+				hostInput.spaceGrid = _grid;
+				hostInput.velocity = _velocity;
+				hostInput.diffusion = _diffusion;
+				hostInput.spaceDiscretizerType = spaceDiscretizerType;
+				hostInput.boundaryConditions = boundaryConditions;
+
+				// periodic operators only span the interior points
+				pde::BandedMatrix<double> bandedSpaceDiscretizer;
+				pde::detail::MakeSpaceDiscretizer1D(bandedSpaceDiscretizer, hostInput);
+				const size_t offset = pde::detail::IsPeriodic(hostInput) ? 1 : 0;
+				std::vector<double> hostOut(n, 0.0);
+				bandedSpaceDiscretizer.Dot(hostOut.data() + offset, _consistentU.data() + offset);
+
+				// boundary rows are overwritten by the boundary conditions after every step
+				for (unsigned i = 1; i < n - 1; ++i)
+					ASSERT_LE(fabs(hostOut[i] - _denseOut[i]), 1e-9 * (1.0 + fabs(_denseOut[i])));
+			}
+		}
+	}
+}
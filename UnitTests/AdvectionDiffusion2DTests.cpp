@@ -158,4 +158,810 @@ namespace pdet
 			}
 		}
 	}
+
+	TEST_F(AdvectionDiffusion2DTests, SparseAgainstSpectral)
+	{
+		const unsigned nx = 40;
+		const unsigned ny = 32;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+
+		// non-homogeneous boundaries, so that the interior is forced
+		std::vector<double> _initialCondition(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+			for (unsigned i = 0; i < nx; ++i)
+				_initialCondition[i + nx * j] = 1.0 + .5 * sin(pi * _xGrid[i]) * sin(2.0 * pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+
+		// within the explicit limit dx^2 / (4 * diffusion) ~ 1.6e-3
+		const unsigned steps = 200;
+		double dt = 1e-4;
+		double xVelocity = .5;
+		double yVelocity = .7;
+		double diffusion = .1;
+
+		const BoundaryCondition one(BoundaryConditionType::Dirichlet, 1.0);
+		const BoundaryCondition2D boundaryConditions(one, one, one, one);
+		for (const SolverType solverType : { SolverType::ExplicitEuler, SolverType::RungeKutta4, SolverType::AdamsBashforth2, SolverType::ImplicitEuler, SolverType::CrankNicolson })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad2D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			cl::dmat snapshots(nx * ny, 1, 0.0);
+			ASSERT_TRUE(solver.EvaluateSpectral(snapshots, { steps * dt }));
+			const auto snapshot = snapshots.columns[0]->Get();
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			// the first order schemes are off by ~dt * t * |L u|^2 / 2
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(solution[i] - snapshot[i]), 1e-3);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, RungeKuttaBootstrapAgainstSpectral)
+	{
+		const unsigned nx = 24;
+		const unsigned ny = 18;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+
+		std::vector<double> _initialCondition(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+			for (unsigned i = 0; i < nx; ++i)
+				_initialCondition[i + nx * j] = 1.0 + .5 * sin(pi * _xGrid[i]) * sin(2.0 * pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+
+		// a single CrankNicolson step is off by ~9e-5 here, four RungeKutta4 sub-steps by ~1e-8
+		double dt = 1e-2;
+		double xVelocity = .5;
+		double yVelocity = .7;
+		double diffusion = .05;
+		pde::PdeSolverSettings settings;
+		settings.propagatorPowerPolicy = pde::PropagatorPowerPolicy::CostModel;
+		settings.bootstrapSubSteps = 4;
+
+		const BoundaryCondition one(BoundaryConditionType::Dirichlet, 1.0);
+		const BoundaryCondition2D boundaryConditions(one, one, one, one);
+		pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, SolverType::AdamsBashforth2, SpaceDiscretizerType::Centered, boundaryConditions, settings);
+		pde::dad2D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+		// as in 1D, the reference is a one-step solver, still at the initial condition
+		pde::GpuDoublePdeInputData2D referenceData(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dad2D reference(referenceData);
+		cl::dmat snapshots(nx * ny, 1, 0.0);
+		ASSERT_TRUE(reference.EvaluateSpectral(snapshots, { dt }));
+
+		// the first column holds the newest level of the history, and the last one the initial condition, untouched
+		const auto solution = solver.solution->columns[0]->Get();
+		const auto initialLevel = solver.solution->columns[1]->Get();
+		const auto snapshot = snapshots.columns[0]->Get();
+		for (size_t i = 0; i < solution.size(); ++i)
+		{
+			ASSERT_LE(fabs(snapshot[i] - solution[i]), 1e-6);
+			ASSERT_DOUBLE_EQ(_initialCondition[i], initialLevel[i]);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, SineSolutionSpectral)
+	{
+		const unsigned nx = 24;
+		const unsigned ny = 18;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		double dt = 1e-3;
+		double diffusion = 1.0;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		const double dx = _xGrid[1] - _xGrid[0];
+		const double dy = _yGrid[1] - _yGrid[0];
+
+		// sin(pi * x) * sin(2 * pi * y) is an eigenvector of the five-point Laplacian with homogeneous Dirichlet boundaries, so that u(t) = e^{lambda * t} * u(0) on the grid
+		std::vector<double> _initialCondition(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+			for (unsigned i = 0; i < nx; ++i)
+				_initialCondition[i + nx * j] = sin(pi * _xGrid[i]) * sin(2.0 * pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+		const double eigenvalue = -4.0 * diffusion * (sin(.5 * pi * dx) * sin(.5 * pi * dx) / (dx * dx) + sin(pi * dy) * sin(pi * dy) / (dy * dy));
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition2D boundaryConditions(zero, zero, zero, zero);
+		for (const SolverType solverType : { SolverType::ExplicitEuler, SolverType::ImplicitEuler })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, 0.0, 0.0, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad2D solver(data);
+
+			const std::vector<double> times = { .001, .01, .05 };
+			cl::dmat snapshots(nx * ny, static_cast<unsigned>(times.size()), 0.0);
+			ASSERT_TRUE(solver.EvaluateSpectral(snapshots, times));
+
+			for (size_t k = 0; k < times.size(); ++k)
+			{
+				const auto snapshot = snapshots.columns[k]->Get();
+				const double amplification = exp(eigenvalue * times[k]);
+				for (size_t i = 0; i < snapshot.size(); ++i)
+					ASSERT_LE(fabs(snapshot[i] - amplification * _initialCondition[i]), 1e-10);
+			}
+
+			cl::dmat wrongSnapshots(nx * ny, 1, 0.0);
+			ASSERT_THROW(solver.EvaluateSpectral(wrongSnapshots, times), pde::DimensionMismatchException);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, SineModeLargeGridMatrixFree)
+	{
+		// explicit one-step schemes don't store any operator: memory is a few copies of the grid
+		const unsigned n = 1024;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		const double dx = _xGrid[1] - _xGrid[0];
+
+		// sin(kx * pi * x) * sin(ky * pi * y) is an eigenvector of the five-point Laplacian with homogeneous Dirichlet boundaries
+		const unsigned kx = 64;
+		const unsigned ky = 48;
+		std::vector<double> _initialCondition(n * n);
+		for (unsigned j = 0; j < n; ++j)
+			for (unsigned i = 0; i < n; ++i)
+				_initialCondition[i + n * j] = sin(kx * pi * _xGrid[i]) * sin(ky * pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, n, n);
+
+		// within the explicit limit dx^2 / (4 * diffusion) ~ 2.4e-7
+		const unsigned steps = 10;
+		double dt = 2e-7;
+		double diffusion = 1.0;
+		const double eigenvalue = -4.0 * diffusion / (dx * dx) * (sin(.5 * kx * pi * dx) * sin(.5 * kx * pi * dx) + sin(.5 * ky * pi * dx) * sin(.5 * ky * pi * dx));
+		const double z = dt * eigenvalue;
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition2D boundaryConditions(zero, zero, zero, zero);
+		for (const SolverType solverType : { SolverType::ExplicitEuler, SolverType::RungeKuttaRalston, SolverType::RungeKutta3, SolverType::RungeKutta4 })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, 0.0, 0.0, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad2D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			// the Taylor polynomial of the scheme is the amplification factor of the mode at each step
+			const unsigned order = solverType == SolverType::ExplicitEuler ? 1 : solverType == SolverType::RungeKuttaRalston ? 2 : solverType == SolverType::RungeKutta3 ? 3 : 4;
+			double stepAmplification = 1.0, term = 1.0;
+			for (unsigned m = 1; m <= order; ++m)
+			{
+				term *= z / m;
+				stepAmplification += term;
+			}
+			const double amplification = pow(stepAmplification, steps);
+			ASSERT_LT(amplification, .95);
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(solution[i] - amplification * _initialCondition[i]), 1e-9);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, KrylovAgainstBandedLu)
+	{
+		// the Krylov iterations only need a few copies of the grid, where the banded LU stores 2 * nRows + 1 diagonals
+		const unsigned nx = 128;
+		const unsigned ny = 96;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		double dt = 1e-4;
+		double xVelocity = .5;
+		double yVelocity = .7;
+		double diffusion = 1.0;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		std::vector<double> _initialCondition(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+			for (unsigned i = 0; i < nx; ++i)
+				_initialCondition[i + nx * j] = 1.0 + sin(pi * _xGrid[i]) * sin(3.0 * pi * _yGrid[j]) + _xGrid[i] * _yGrid[j];
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+
+		const BoundaryCondition one(BoundaryConditionType::Dirichlet, 1.0);
+		const BoundaryCondition2D boundaryConditions(one, one, one, one);
+		for (const SolverType solverType : { SolverType::ImplicitEuler, SolverType::CrankNicolson })
+		{
+			pde::GpuDoublePdeInputData2D luData(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad2D luSolver(luData);
+			luSolver.Advance(10);
+			const auto luSolution = luSolver.solution->columns[0]->Get();
+
+			pde::LinearSolverSettings linearSolverSettings;
+			linearSolverSettings.solverType = pde::LinearSolverType::Krylov;
+			for (const pde::PreconditionerType preconditionerType : { pde::PreconditionerType::Jacobi, pde::PreconditionerType::IncompleteLu })
+			{
+				linearSolverSettings.preconditionerType = preconditionerType;
+
+				pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::Null, linearSolverSettings });
+				pde::dad2D solver(data);
+				ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+				solver.Advance(10);
+				const auto solution = solver.solution->columns[0]->Get();
+
+				for (size_t i = 0; i < solution.size(); ++i)
+					ASSERT_LE(fabs(solution[i] - luSolution[i]), 1e-9);
+			}
+
+			// a single iteration can't reach the tolerance: the step throws rather than carrying on with an unconverged solution
+			linearSolverSettings.maxIterations = 1;
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::Null, linearSolverSettings });
+			pde::dad2D solver(data);
+			ASSERT_THROW(solver.Advance(1), pde::LinearSolverNotConvergedException);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, MultigridAgainstBandedLu)
+	{
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0f, 1.0f, 65u);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0f, 1.0f, 48u);
+		double dt = 1e-3;
+		float diffusion = 1.0f;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		std::vector<double> _initialCondition(xGrid.size() * yGrid.size());
+		for (unsigned j = 0; j < _yGrid.size(); ++j)
+			for (unsigned i = 0; i < _xGrid.size(); ++i)
+				_initialCondition[i + _xGrid.size() * j] = sin(pi * _xGrid[i]) * sin(pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, xGrid.size(), yGrid.size());
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition2D boundaryConditions(zero, zero, zero, zero);
+		// pure diffusion gives a symmetric system, which the multigrid preconditioner still pairs with BiCGSTAB rather than conjugate gradient
+		for (const std::pair<float, float> velocities : { std::make_pair(.5f, .7f), std::make_pair(.0f, .0f) })
+		{
+			for (const SolverType solverType : { SolverType::ImplicitEuler, SolverType::CrankNicolson })
+			{
+				pde::GpuDoublePdeInputData2D luData(initialCondition, xGrid, yGrid, velocities.first, velocities.second, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+				pde::dad2D luSolver(luData);
+				luSolver.Advance(10);
+				const auto luSolution = luSolver.solution->columns[0]->Get();
+
+				// standalone V-cycles, and V-cycles preconditioning BiCGSTAB
+				pde::LinearSolverSettings linearSolverSettings;
+				for (const pde::LinearSolverType linearSolverType : { pde::LinearSolverType::Multigrid, pde::LinearSolverType::Krylov })
+				{
+					linearSolverSettings.solverType = linearSolverType;
+					linearSolverSettings.preconditionerType = pde::PreconditionerType::Multigrid;
+
+					pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, velocities.first, velocities.second, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::Null, linearSolverSettings });
+					pde::dad2D solver(data);
+					ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+					solver.Advance(10);
+					const auto solution = solver.solution->columns[0]->Get();
+
+					for (size_t i = 0; i < solution.size(); ++i)
+						ASSERT_LE(fabs(solution[i] - luSolution[i]), 1e-9);
+				}
+			}
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, SineSolutionNoTransportAdi)
+	{
+		// u = sin(pi * x) * sin(pi * y) * exp(-2 * pi^2 * diffusion * t): the error is dominated by the space discretization
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0f, 1.0f, 41u);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0f, 1.0f, 31u);
+		const unsigned steps = 50;
+		double dt = 1e-2;
+		float xVelocity = .0f;
+		float yVelocity = .0f;
+		float diffusion = .1f;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		std::vector<double> _initialCondition(xGrid.size() * yGrid.size());
+		for (unsigned j = 0; j < _yGrid.size(); ++j)
+			for (unsigned i = 0; i < _xGrid.size(); ++i)
+				_initialCondition[i + _xGrid.size() * j] = sin(pi * _xGrid[i]) * sin(pi * _yGrid[j]);
+
+		cl::dmat initialCondition(_initialCondition, xGrid.size(), yGrid.size());
+		const double decay = exp(-2.0 * pi * pi * diffusion * steps * dt);
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition2D boundaryConditions(zero, zero, zero, zero);
+		for (const pde::ExtendedSolverType extendedSolverType : { pde::ExtendedSolverType::PeacemanRachford, pde::ExtendedSolverType::Douglas })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions, { extendedSolverType });
+			pde::dad2D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(solution[i] - _initialCondition[i] * decay), 5e-4);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, NonSeparableAdiAgainstSpectral)
+	{
+		// velocities that change along both axes can't be split into 1D factors: this goes through the flattened line solves instead
+		const unsigned nx = 32;
+		const unsigned ny = 24;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		const unsigned steps = 20;
+		double dt = 1e-3;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		std::vector<double> _initialCondition(nx * ny);
+		std::vector<double> _xVelocity(nx * ny);
+		std::vector<double> _yVelocity(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+		{
+			for (unsigned i = 0; i < nx; ++i)
+			{
+				_initialCondition[i + nx * j] = 1.0 + .5 * sin(pi * _xGrid[i]) * sin(pi * _yGrid[j]);
+				_xVelocity[i + nx * j] = .5 + _xGrid[i] * _yGrid[j];
+				_yVelocity[i + nx * j] = .7 - _xGrid[i] * _yGrid[j];
+			}
+		}
+
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+		cl::dmat xVelocity(_xVelocity, nx, ny);
+		cl::dmat yVelocity(_yVelocity, nx, ny);
+		cl::dmat diffusion(nx, ny, .1);
+
+		const BoundaryCondition one(BoundaryConditionType::Dirichlet, 1.0);
+		const BoundaryCondition2D boundaryConditions(one, one, one, one);
+		for (const pde::ExtendedSolverType extendedSolverType : { pde::ExtendedSolverType::PeacemanRachford, pde::ExtendedSolverType::Douglas })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions, { extendedSolverType });
+			pde::dad2D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			cl::dmat snapshots(nx * ny, 1, 0.0);
+			ASSERT_TRUE(solver.EvaluateSpectral(snapshots, { steps * dt }));
+			const auto snapshot = snapshots.columns[0]->Get();
+
+			// both schemes are second order, up to their splitting error
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(solution[i] - snapshot[i]), 1e-4);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, SineSolutionPeriodicFastDiagonalization)
+	{
+		// first and last grid lines are ghost copies of the lines n - 2 and 1: the period is 2 * pi, and the 64 interior points go through the FFT
+		const unsigned n = 66;
+		const double pi = 3.14159265358979;
+		const double dx = 2.0 * pi / (n - 2);
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n);
+		const unsigned steps = 100;
+		double dt = 1e-3;
+		float xVelocity = .0f;
+		float yVelocity = .0f;
+		float diffusion = 1.0f;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		std::vector<double> _initialCondition(xGrid.size() * yGrid.size());
+		for (unsigned j = 0; j < _yGrid.size(); ++j)
+			for (unsigned i = 0; i < _xGrid.size(); ++i)
+				_initialCondition[i + _xGrid.size() * j] = sin(_xGrid[i]) * sin(_yGrid[j]);
+
+		cl::dmat initialCondition(_initialCondition, xGrid.size(), yGrid.size());
+		const double decay = exp(-2.0 * diffusion * steps * dt);
+
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		const BoundaryCondition2D boundaryConditions(periodic, periodic, periodic, periodic);
+		for (const SolverType solverType : { SolverType::ImplicitEuler, SolverType::CrankNicolson })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad2D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(solution[i] - _initialCondition[i] * decay), 1e-3);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, SineSolutionDirichletFastDiagonalization)
+	{
+		// 31 interior points along x go through a radix-2 FFT of length 64, and 24 along y through Bluestein's, as 50 isn't a power of 2
+		const unsigned nx = 33;
+		const unsigned ny = 26;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		const unsigned steps = 20;
+		double dt = 1e-3;
+		double diffusion = 1.0;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		const double dx = _xGrid[1] - _xGrid[0];
+		const double dy = _yGrid[1] - _yGrid[0];
+
+		// sin(2 * pi * x) * sin(3 * pi * y) is an eigenvector of the five-point Laplacian with homogeneous Dirichlet boundaries
+		std::vector<double> _initialCondition(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+			for (unsigned i = 0; i < nx; ++i)
+				_initialCondition[i + nx * j] = sin(2.0 * pi * _xGrid[i]) * sin(3.0 * pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+		const double eigenvalue = -4.0 * diffusion * (sin(pi * dx) * sin(pi * dx) / (dx * dx) + sin(1.5 * pi * dy) * sin(1.5 * pi * dy) / (dy * dy));
+		const double z = dt * eigenvalue;
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition2D boundaryConditions(zero, zero, zero, zero);
+		for (const SolverType solverType : { SolverType::ImplicitEuler, SolverType::CrankNicolson })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, 0.0, 0.0, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad2D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			const double stepAmplification = solverType == SolverType::ImplicitEuler ? 1.0 / (1.0 - z) : (1.0 + .5 * z) / (1.0 - .5 * z);
+			const double amplification = pow(stepAmplification, steps);
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (size_t i = 0; i < solution.size(); ++i)
+				ASSERT_LE(fabs(solution[i] - amplification * _initialCondition[i]), 1e-10);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, PeriodicAdiAgainstSpectral)
+	{
+		// transport rules out the fast diagonalization: separable coefficients still go through ADI, with the line factorizations wrapping around
+		const unsigned n = 34;
+		const double pi = 3.14159265358979;
+		const double dx = 2.0 * pi / (n - 2);
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n);
+		const unsigned steps = 50;
+		double dt = 1e-2;
+		double xVelocity = .5;
+		double yVelocity = -.3;
+		double diffusion = .1;
+
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		const BoundaryCondition one(BoundaryConditionType::Dirichlet, 1.0);
+		for (const bool yPeriodic : { true, false })
+		{
+			// the Dirichlet axis runs over [0, 1], where the initial condition matches the boundary values
+			cl::dvec yGrid = yPeriodic ? cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n) : cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+			auto _xGrid = xGrid.Get();
+			auto _yGrid = yGrid.Get();
+			std::vector<double> _initialCondition(n * n);
+			for (unsigned j = 0; j < n; ++j)
+				for (unsigned i = 0; i < n; ++i)
+					_initialCondition[i + n * j] = 1.0 + sin(_xGrid[i]) * (yPeriodic ? cos(2.0 * _yGrid[j]) : sin(pi * _yGrid[j]));
+			cl::dmat initialCondition(_initialCondition, n, n);
+
+			const BoundaryCondition2D boundaryConditions = yPeriodic ? BoundaryCondition2D(periodic, periodic, periodic, periodic) : BoundaryCondition2D(one, one, periodic, periodic);
+			for (const pde::ExtendedSolverType extendedSolverType : { pde::ExtendedSolverType::PeacemanRachford, pde::ExtendedSolverType::Douglas })
+			{
+				pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions, { extendedSolverType });
+				pde::dad2D solver(data);
+				ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+				cl::dmat snapshots(n * n, 1, 0.0);
+				ASSERT_TRUE(solver.EvaluateSpectral(snapshots, { steps * dt }));
+				const auto snapshot = snapshots.columns[0]->Get();
+
+				solver.Advance(steps);
+				const auto solution = solver.solution->columns[0]->Get();
+
+				for (size_t i = 0; i < solution.size(); ++i)
+					ASSERT_LE(fabs(solution[i] - snapshot[i]), 1e-3);
+			}
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, PeriodicUnsupportedExtendedSolverTypeThrows)
+	{
+		// the sparse stencils don't wrap around, and the dense propagators only implement solverType
+		const unsigned n = 16;
+		cl::dmat initialCondition(n, n, 1.0);
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		double dt = 1e-3;
+
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		const BoundaryCondition2D boundaryConditions(periodic, periodic, periodic, periodic);
+		for (const pde::ExtendedSolverType extendedSolverType : { pde::ExtendedSolverType::KrylovExponential, pde::ExtendedSolverType::DormandPrince54, pde::ExtendedSolverType::ImexEuler,
+																  pde::ExtendedSolverType::AdamsBashforth3, pde::ExtendedSolverType::BackwardDifferentiation2 })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, .5, .7, .1, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { extendedSolverType });
+			ASSERT_THROW(pde::dad2D solver(data), pde::UnsupportedSolverTypeException);
+		}
+
+		// velocities that change along both axes can't be split into periodic 1D factors
+		std::vector<double> _xVelocity(n * n);
+		for (size_t i = 0; i < _xVelocity.size(); ++i)
+			_xVelocity[i] = .5 + .01 * i;
+		cl::dmat xVelocity(_xVelocity, n, n);
+		cl::dmat yVelocity(n, n, .7);
+		cl::dmat diffusion(n, n, .1);
+		pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, SolverType::CrankNicolson, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::PeacemanRachford });
+		ASSERT_THROW(pde::dad2D solver(data), pde::UnsupportedSolverTypeException);
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, PropagatorPowerAgainstIteration)
+	{
+		// periodic boundaries with an explicit scheme go through the dense propagator
+		const unsigned n = 18;
+		const double pi = 3.14159265358979;
+		const double dx = 2.0 * pi / (n - 2);
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n);
+		double dt = 1e-3;
+		float xVelocity = .5f;
+		float yVelocity = .7f;
+		float diffusion = .1f;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		std::vector<double> _initialCondition(xGrid.size() * yGrid.size());
+		for (unsigned j = 0; j < _yGrid.size(); ++j)
+			for (unsigned i = 0; i < _xGrid.size(); ++i)
+				_initialCondition[i + _xGrid.size() * j] = sin(_xGrid[i]) * cos(_yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, xGrid.size(), yGrid.size());
+
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		const BoundaryCondition2D boundaryConditions(periodic, periodic, periodic, periodic);
+		for (const SolverType solverType : { SolverType::ExplicitEuler, SolverType::RungeKuttaRalston })
+		{
+			pde::GpuDoublePdeInputData2D iteratedData(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions);
+			pde::dad2D iteratedSolver(iteratedData);
+			ASSERT_TRUE(iteratedSolver.GetTimeDiscretizer() != nullptr);
+
+			pde::PdeSolverSettings cachedSettings;
+			cachedSettings.propagatorPowerPolicy = pde::PropagatorPowerPolicy::Always;
+			pde::GpuDoublePdeInputData2D cachedData(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions, cachedSettings);
+			pde::dad2D cachedSolver(cachedData);
+
+			// same n on every call but the last one, which rebuilds the power
+			for (const unsigned nSteps : { 37u, 37u, 37u, 16u })
+			{
+				iteratedSolver.Advance(nSteps);
+				cachedSolver.Advance(nSteps);
+
+				const auto iteratedSolution = iteratedSolver.solution->columns[0]->Get();
+				const auto cachedSolution = cachedSolver.solution->columns[0]->Get();
+				for (size_t i = 0; i < iteratedSolution.size(); ++i)
+					ASSERT_LE(fabs(cachedSolution[i] - iteratedSolution[i]), 1e-10);
+			}
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, SineSolutionPeriodicStrangSplitting)
+	{
+		// u = sin(x - xVelocity * t) * sin(y - yVelocity * t) * exp(-2 * diffusion * t): periodic transport has no sparse propagator, but each grid line handles its own ghost points
+		const unsigned n = 66;
+		const double pi = 3.14159265358979;
+		const double dx = 2.0 * pi / (n - 2);
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(-pi - dx, pi, n);
+		const unsigned steps = 100;
+		double dt = 1e-3;
+		float xVelocity = 1.0f;
+		float yVelocity = -.5f;
+		float diffusion = 1.0f;
+
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+		std::vector<double> _initialCondition(xGrid.size() * yGrid.size());
+		for (unsigned j = 0; j < _yGrid.size(); ++j)
+			for (unsigned i = 0; i < _xGrid.size(); ++i)
+				_initialCondition[i + _xGrid.size() * j] = sin(_xGrid[i]) * sin(_yGrid[j]);
+
+		cl::dmat initialCondition(_initialCondition, xGrid.size(), yGrid.size());
+		const double t = steps * dt;
+
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		const BoundaryCondition2D boundaryConditions(periodic, periodic, periodic, periodic);
+		for (const SolverType solverType : { SolverType::CrankNicolson, SolverType::RungeKutta4 })
+		{
+			pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, xVelocity, yVelocity, diffusion, dt, solverType, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::StrangSplitting });
+			pde::dad2D solver(data);
+			ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+			solver.Advance(steps);
+			const auto solution = solver.solution->columns[0]->Get();
+
+			for (unsigned j = 0; j < _yGrid.size(); ++j)
+				for (unsigned i = 0; i < _xGrid.size(); ++i)
+					ASSERT_LE(fabs(solution[i + _xGrid.size() * j] - sin(_xGrid[i] - xVelocity * t) * sin(_yGrid[j] - yVelocity * t) * exp(-2.0 * diffusion * t)), 1e-3);
+		}
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, ZeroCopyInputMatchesOwningInput)
+	{
+		const unsigned nx = 24;
+		const unsigned ny = 20;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		cl::dvec xVelocity(nx, .3);
+		cl::dvec yVelocity(ny, -.2);
+
+		std::vector<double> _initialCondition(nx * ny);
+		std::vector<double> _diffusion(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+		{
+			for (unsigned i = 0; i < nx; ++i)
+			{
+				_initialCondition[i + nx * j] = 1.0 + i * j / double(nx * ny);
+				_diffusion[i + nx * j] = .05 + .01 * i / double(nx);
+			}
+		}
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+		cl::dmat diffusion(_diffusion, nx, ny);
+
+		pde::GpuDoublePdeInputData2D viewData(initialCondition.GetTile(), xGrid.GetBuffer(), yGrid.GetBuffer(), xVelocity.GetBuffer(), yVelocity.GetBuffer(), diffusion.GetTile(),
+											  1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered);
+		ASSERT_EQ(viewData.initialCondition.matrices[0]->GetBuffer().pointer, initialCondition.GetBuffer().pointer);
+		ASSERT_EQ(viewData.diffusion.GetBuffer().pointer, diffusion.GetBuffer().pointer);
+
+		pde::GpuDoublePdeInputData2D ownedData(initialCondition, xGrid, yGrid, .0, .0, .0, 1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered);
+		ownedData.xVelocity = xVelocity;
+		ownedData.yVelocity = yVelocity;
+		ownedData.diffusion = diffusion.Flatten();
+
+		pde::dad2D viewSolver(viewData);
+		pde::dad2D ownedSolver(ownedData);
+		viewSolver.Advance(10);
+		ownedSolver.Advance(10);
+
+		const auto viewSolution = viewSolver.solution->columns[0]->Get();
+		const auto ownedSolution = ownedSolver.solution->columns[0]->Get();
+		for (size_t i = 0; i < viewSolution.size(); ++i)
+			ASSERT_DOUBLE_EQ(viewSolution[i], ownedSolution[i]);
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, HostViewInputChecksMemorySpaceAndMathDomain)
+	{
+		const unsigned nx = 12;
+		const unsigned ny = 10;
+		std::vector<double> xGrid(nx), yGrid(ny), xVelocity(nx, .3), yVelocity(ny, -.2);
+		for (unsigned i = 0; i < nx; ++i)
+			xGrid[i] = i / (nx - 1.0);
+		for (unsigned j = 0; j < ny; ++j)
+			yGrid[j] = j / (ny - 1.0);
+		std::vector<double> initialCondition(nx * ny, 1.0), diffusion(nx * ny, .05);
+		std::vector<float> floatDiffusion(nx * ny, .05f);
+
+		using pde::MakeHostView;
+		using pde::detail::MakeFlatView;
+		const auto xGridView = MakeFlatView(MakeHostView<MathDomain::Double>(xGrid.data(), nx));
+		const auto yGridView = MakeFlatView(MakeHostView<MathDomain::Double>(yGrid.data(), ny));
+		const auto xVelocityView = MakeFlatView(MakeHostView<MathDomain::Double>(xVelocity.data(), nx));
+		const auto yVelocityView = MakeFlatView(MakeHostView<MathDomain::Double>(yVelocity.data(), ny));
+		const auto initialConditionView = MakeHostView<MathDomain::Double>(initialCondition.data(), nx, ny);
+		const auto diffusionView = MakeHostView<MathDomain::Double>(diffusion.data(), nx, ny);
+
+		// host views wrap the host memory
+		pde::CpuDoublePdeInputData2D data(initialConditionView, xGridView, yGridView, xVelocityView, yVelocityView, diffusionView,
+										  1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered);
+		ASSERT_EQ(data.initialCondition.matrices[0]->GetBuffer().pointer, reinterpret_cast<ptr_t>(initialCondition.data()));
+		ASSERT_EQ(data.xSpaceGrid.GetBuffer().pointer, reinterpret_cast<ptr_t>(xGrid.data()));
+		ASSERT_EQ(data.diffusion.GetBuffer().pointer, reinterpret_cast<ptr_t>(diffusion.data()));
+
+		// host views can't back device input data
+		EXPECT_THROW(pde::GpuDoublePdeInputData2D(initialConditionView, xGridView, yGridView, xVelocityView, yVelocityView, diffusionView,
+												  1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered),
+					 pde::InputViewMismatchException);
+
+		// nor can a single precision field back double precision input data
+		EXPECT_THROW(pde::CpuDoublePdeInputData2D(initialConditionView, xGridView, yGridView, xVelocityView, yVelocityView, MakeHostView<MathDomain::Float>(floatDiffusion.data(), nx, ny),
+												  1e-3, SolverType::CrankNicolson, SpaceDiscretizerType::Centered),
+					 pde::InputViewMismatchException);
+	}
+
+	TEST_F(AdvectionDiffusion2DTests, HostOperatorMatchesDenseOperator)
+	{
+		const unsigned nx = 14;
+		const unsigned ny = 12;
+		const double pi = 3.14159265358979;
+		const double dt = 1e-3;
+
+		// non-uniform grids, velocities changing sign and diffusion varying over the grid, so that every branch of the stencils is hit
+		std::vector<double> _xGrid(nx), _yGrid(ny), _xVelocity(nx), _yVelocity(ny), _diffusion(nx * ny), _u(nx * ny);
+		for (unsigned i = 0; i < nx; ++i)
+		{
+			const double x = i / (nx - 1.0);
+			_xGrid[i] = x + .1 * x * (1.0 - x);
+			_xVelocity[i] = cos(2.0 * pi * x);
+		}
+		for (unsigned j = 0; j < ny; ++j)
+		{
+			const double y = j / (ny - 1.0);
+			_yGrid[j] = y - .1 * y * (1.0 - y);
+			_yVelocity[j] = -.5 * sin(2.0 * pi * y);
+		}
+		for (unsigned j = 0; j < ny; ++j)
+		{
+			for (unsigned i = 0; i < nx; ++i)
+			{
+				_diffusion[i + nx * j] = .05 + .02 * _xGrid[i] * _yGrid[j];
+				_u[i + nx * j] = 1.0 + _xGrid[i] + sin(3.0 * pi * _xGrid[i]) * cos(2.0 * pi * _yGrid[j]);
+			}
+		}
+		cl::dvec xGrid(_xGrid), yGrid(_yGrid), xVelocity(_xVelocity), yVelocity(_yVelocity), diffusion(_diffusion);
+
+		const BoundaryCondition dirichlet(BoundaryConditionType::Dirichlet, 1.0);
+		const BoundaryCondition neumann(BoundaryConditionType::Neumann, -.5);
+		for (const SpaceDiscretizerType spaceDiscretizerType : { SpaceDiscretizerType::Centered, SpaceDiscretizerType::Upwind, SpaceDiscretizerType::LaxWendroff })
+		{
+			for (const auto& boundaryConditions : { BoundaryCondition2D(dirichlet, dirichlet, dirichlet, dirichlet), BoundaryCondition2D(neumann, neumann, neumann, neumann), BoundaryCondition2D(dirichlet, neumann, neumann, dirichlet), BoundaryCondition2D(neumann, dirichlet, dirichlet, neumann) })
+			{
+				FiniteDifferenceInput2D input(dt, xGrid.GetBuffer(), yGrid.GetBuffer(), xVelocity.GetBuffer(), yVelocity.GetBuffer(), diffusion.GetBuffer(), SolverType::ExplicitEuler, spaceDiscretizerType, boundaryConditions);
+
+				cl::dmat u(_u, nx * ny, 1);
+				pde::detail::SetBoundaryConditions2D(u.columns[0]->GetBuffer(), input);
+				const auto _consistentU = u.Get();
+
+				cl::dmat denseSpaceDiscretizer(nx * ny, nx * ny, 0.0);
+				pde::detail::MakeSpaceDiscretizer2D(denseSpaceDiscretizer.GetTile(), input);
+				cl::dmat denseOut(nx * ny, 1, 0.0);
+				cl::Multiply(denseOut, denseSpaceDiscretizer, u);
+				const auto _denseOut = denseOut.Get();
+
+				pde::HostFiniteDifferenceInput2D<double> hostInput;
+				hostInput.dt = dt;
+				hostInput.xSpaceGrid = _xGrid;
+				hostInput.ySpaceGrid = _yGrid;
+				hostInput.xVelocity = _xVelocity;
+				hostInput.yVelocity = _yVelocity;
+				hostInput.diffusion = _diffusion;
+				hostInput.spaceDiscretizerType = spaceDiscretizerType;
+				hostInput.boundaryConditions = boundaryConditions;
+
+				pde::SparseDiagonalMatrix<double> sparseSpaceDiscretizer;
+				pde::detail::MakeSpaceDiscretizer2D(sparseSpaceDiscretizer, hostInput);
+				std::vector<double> sparseOut(nx * ny, 0.0);
+				sparseSpaceDiscretizer.Dot(sparseOut.data(), _consistentU.data());
+
+				// the separable form has to agree as well, as it replaces the sparse one when available
+				pde::KroneckerOperator2D<double> kroneckerSpaceDiscretizer;
+				const bool isSeparable = pde::detail::MakeKroneckerOperator2D(kroneckerSpaceDiscretizer, hostInput);
+				std::vector<double> kroneckerOut(nx * ny, 0.0);
+				if (isSeparable)
+					pde::detail::ApplySpaceDiscretizer2D(kroneckerOut.data(), _consistentU.data(), kroneckerSpaceDiscretizer);
+
+				// boundary points are overwritten by the boundary conditions after every step
+				for (unsigned j = 1; j < ny - 1; ++j)
+				{
+					for (unsigned i = 1; i < nx - 1; ++i)
+					{
+						const size_t k = i + nx * j;
+						ASSERT_LE(fabs(sparseOut[k] - _denseOut[k]), 1e-9 * (1.0 + fabs(_denseOut[k])));
+						if (isSeparable)
+							ASSERT_LE(fabs(kroneckerOut[k] - _denseOut[k]), 1e-9 * (1.0 + fabs(_denseOut[k])));
+					}
+				}
+			}
+		}
+	}
 }
\ No newline at end of file
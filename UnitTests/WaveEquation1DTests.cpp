@@ -116,4 +116,73 @@ namespace pdet
 
 		}
 	}
+
+	TEST_F(WaveEquation1DTests, StandingWaveStormerVerlet)
+	{
+		// sin(pi * x) is an eigenvector of L, whose leapfrog steps are rotations by theta, with cos(theta) = 1 + .5 * dt^2 * lambda: no damping over many periods
+		const unsigned n = 101;
+		const double pi = 3.14159265358979;
+		const double dx = 1.0 / (n - 1);
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < n; ++i)
+			_initialCondition[i] = sin(pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		const unsigned steps = 10000;
+		double dt = .9 * dx;
+		float velocity = 1.0f;
+		float diffusion = 0.0f;
+
+		const double lambda = -velocity * velocity * (2.0 - 2.0 * cos(pi * dx)) / (dx * dx);
+		const double theta = acos(1.0 + .5 * dt * dt * lambda);
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition1D boundaryConditions(zero, zero);
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::StormerVerlet });
+		pde::dwave1D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+		solver.Advance(steps);
+		const auto solution = solver.solution->columns[0]->Get();
+
+		for (size_t i = 0; i < solution.size(); ++i)
+			ASSERT_LE(fabs(solution[i] - _initialCondition[i] * cos(steps * theta)), 1e-10);
+	}
+
+	TEST_F(WaveEquation1DTests, DenseSingleStepsMatchOneAdvance)
+	{
+		const unsigned n = 32;
+		const double pi = 3.14159265358979;
+		cl::dvec grid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _grid = grid.Get();
+
+		std::vector<double> _initialCondition(n);
+		for (unsigned i = 0; i < n; ++i)
+			_initialCondition[i] = sin(pi * _grid[i]);
+		cl::dvec initialCondition(_initialCondition);
+
+		const unsigned steps = 7;
+		double dt = 1e-3;
+		float velocity = 1.0f;
+		float diffusion = 0.0f;
+
+		// one-sided periodic boundaries have no banded operator: after an odd number of steps the solution is in the buffers of the solver
+		const BoundaryCondition1D boundaryConditions(BoundaryCondition(BoundaryConditionType::Periodic, 0.0), BoundaryCondition(BoundaryConditionType::Dirichlet, 0.0));
+		pde::GpuDoublePdeInputData1D data(initialCondition, grid, velocity, diffusion, dt, SolverType::ImplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dwave1D stepper(data);
+		pde::dwave1D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() != nullptr);
+
+		for (unsigned k = 0; k < steps; ++k)
+			stepper.Advance(1);
+		solver.Advance(steps);
+
+		const auto solution = solver.solution->columns[0]->Get();
+		const auto steppedSolution = stepper.solution->columns[0]->Get();
+		for (size_t i = 0; i < solution.size(); ++i)
+			ASSERT_LE(fabs(solution[i] - steppedSolution[i]), 1e-12);
+	}
 }
\ No newline at end of file
@@ -131,4 +131,104 @@ namespace pdet
 			}
 		}
 	}
+
+	TEST_F(WaveEquation2DTests, StandingWaveStormerVerlet)
+	{
+		// sin(pi * x) * sin(pi * y) is an eigenvector of L, whose leapfrog steps are rotations by theta, with cos(theta) = 1 + .5 * dt^2 * lambda: no damping over many periods
+		const unsigned n = 41;
+		const double pi = 3.14159265358979;
+		const double dx = 1.0 / (n - 1);
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, n);
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+
+		std::vector<double> _initialCondition(n * n);
+		for (unsigned j = 0; j < n; ++j)
+			for (unsigned i = 0; i < n; ++i)
+				_initialCondition[i + n * j] = sin(pi * _xGrid[i]) * sin(pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, n, n);
+
+		// within the 2D limit dt <= dx / sqrt(2)
+		const unsigned steps = 2000;
+		double dt = .5 * dx;
+		float velocity = 1.0f;
+		float diffusion = 0.0f;
+
+		const double lambda = -2.0 * velocity * velocity * (2.0 - 2.0 * cos(pi * dx)) / (dx * dx);
+		const double theta = acos(1.0 + .5 * dt * dt * lambda);
+
+		const BoundaryCondition zero(BoundaryConditionType::Dirichlet, 0.0);
+		const BoundaryCondition2D boundaryConditions(zero, zero, zero, zero);
+		pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, velocity, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::StormerVerlet });
+		pde::dwave2D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() == nullptr);
+
+		solver.Advance(steps);
+		const auto solution = solver.solution->columns[0]->Get();
+
+		for (size_t i = 0; i < solution.size(); ++i)
+			ASSERT_LE(fabs(solution[i] - _initialCondition[i] * cos(steps * theta)), 1e-10);
+	}
+
+	TEST_F(WaveEquation2DTests, PeriodicStormerVerletThrows)
+	{
+		// the sparse stencils don't wrap around, and the dense propagators have no leapfrog steps
+		cl::dmat initialCondition(16, 16, 1.0);
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, initialCondition.nRows());
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, initialCondition.nCols());
+		double dt = 1e-3;
+		float velocity = 1.0f;
+		float diffusion = 0.0f;
+
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		const BoundaryCondition2D boundaryConditions(periodic, periodic, periodic, periodic);
+		pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, velocity, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions, { pde::ExtendedSolverType::StormerVerlet });
+		ASSERT_THROW(pde::dwave2D solver(data), pde::UnsupportedSolverTypeException);
+
+		// without it, the dense propagators take over as before
+		pde::GpuDoublePdeInputData2D denseData(initialCondition, xGrid, yGrid, velocity, velocity, diffusion, dt, SolverType::ExplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dwave2D solver(denseData);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() != nullptr);
+	}
+
+	TEST_F(WaveEquation2DTests, DenseSingleStepsMatchOneAdvance)
+	{
+		const unsigned nx = 16;
+		const unsigned ny = 12;
+		const double pi = 3.14159265358979;
+		cl::dvec xGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, nx);
+		cl::dvec yGrid = cl::LinSpace<MemorySpace::Device, MathDomain::Double>(0.0, 1.0, ny);
+		auto _xGrid = xGrid.Get();
+		auto _yGrid = yGrid.Get();
+
+		std::vector<double> _initialCondition(nx * ny);
+		for (unsigned j = 0; j < ny; ++j)
+			for (unsigned i = 0; i < nx; ++i)
+				_initialCondition[i + nx * j] = sin(pi * _xGrid[i]) * sin(pi * _yGrid[j]);
+		cl::dmat initialCondition(_initialCondition, nx, ny);
+
+		const unsigned steps = 7;
+		double dt = 1e-3;
+		float velocity = 1.0f;
+		float diffusion = 0.0f;
+
+		// periodic boundaries have no sparse operator: after an odd number of steps the solution is in the buffers of the solver
+		const BoundaryCondition periodic(BoundaryConditionType::Periodic, 0.0);
+		const BoundaryCondition2D boundaryConditions(periodic, periodic, periodic, periodic);
+		pde::GpuDoublePdeInputData2D data(initialCondition, xGrid, yGrid, velocity, velocity, diffusion, dt, SolverType::ImplicitEuler, SpaceDiscretizerType::Centered, boundaryConditions);
+		pde::dwave2D stepper(data);
+		pde::dwave2D solver(data);
+		ASSERT_TRUE(solver.GetTimeDiscretizer() != nullptr);
+
+		for (unsigned k = 0; k < steps; ++k)
+			stepper.Advance(1);
+		solver.Advance(steps);
+
+		// read through the solvers again: solution has been swapped with a buffer of each
+		const auto solution = solver.solution->columns[0]->Get();
+		const auto steppedSolution = stepper.solution->columns[0]->Get();
+		for (size_t i = 0; i < solution.size(); ++i)
+			ASSERT_LE(fabs(solution[i] - steppedSolution[i]), 1e-12);
+	}
 }
\ No newline at end of file